@@ -1,6 +1,8 @@
 #include <cctype>
 
 #include <golos/application/api.hpp>
+#include <golos/application/batch_api_connection.hpp>
+#include <golos/application/subscription_hub.hpp>
 
 #include <golos/utilities/key_conversion.hpp>
 #include <golos/utilities/git_revision.hpp>
@@ -86,6 +88,15 @@ namespace golos {
                     fc::string(fc::git_revision_sha));
         }
 
+        vector<string> login_api::set_binary_results(bool enabled) {
+            std::shared_ptr<api_session_data> session = _ctx.session.lock();
+            FC_ASSERT(session);
+
+            auto connection = std::dynamic_pointer_cast<batch_api_connection>(session->wsc);
+            FC_ASSERT(connection, "Binary results are not supported by this connection");
+            return connection->set_binary_results(enabled);
+        }
+
         network_broadcast_api::network_broadcast_api(const api_context &a)
                 : _app(a.app) {
             /// NOTE: cannot register callbacks in constructor because shared_from_this() is not valid.
@@ -93,9 +104,6 @@ namespace golos {
         }
 
         void network_broadcast_api::on_api_startup() {
-            /// note cannot capture shared pointer here, because _applied_block_connection will never
-            /// be freed if the lambda holds a reference to it.
-            _applied_block_connection = connect_signal(_app.chain_database()->applied_block, *this, &network_broadcast_api::on_applied_block);
         }
 
         bool network_broadcast_api::check_max_block_age(int32_t max_block_age) {
@@ -116,57 +124,6 @@ namespace golos {
             _max_block_age = max_block_age;
         }
 
-        void network_broadcast_api::on_applied_block(const signed_block &b) {
-            /// we need to ensure the database_api is not deleted for the life of the async operation
-            auto capture_this = shared_from_this();
-
-            fc::async([this, capture_this, b]() {
-                int32_t block_num = int32_t(b.block_num());
-                if (_callbacks.size()) {
-                    for (size_t trx_num = 0;
-                         trx_num < b.transactions.size(); ++trx_num) {
-                        const auto &trx = b.transactions[trx_num];
-                        auto id = trx.id();
-                        auto itr = _callbacks.find(id);
-                        if (itr == _callbacks.end()) {
-                            continue;
-                        }
-                        confirmation_callback callback = itr->second;
-                        itr->second = [](variant) {};
-                        callback(fc::variant(transaction_confirmation(id, block_num, int32_t(trx_num), false)));
-                    }
-                }
-
-                /// clear all expirations
-                while (true) {
-                    auto exp_it = _callbacks_expirations.begin();
-                    if (exp_it == _callbacks_expirations.end()) {
-                        break;
-                    }
-                    if (exp_it->first >= b.timestamp) {
-                        break;
-                    }
-                    for (const transaction_id_type &txid : exp_it->second) {
-                        auto cb_it = _callbacks.find(txid);
-                        // If it's empty, that means the transaction has been confirmed and has been deleted by the above check.
-                        if (cb_it == _callbacks.end()) {
-                            continue;
-                        }
-
-                        confirmation_callback callback = cb_it->second;
-                        transaction_id_type txid_byval = txid;    // can't pass in by reference as it's going to be deleted
-                        callback(fc::variant(transaction_confirmation{
-                                txid_byval, block_num, -1, true
-                        }));
-
-                        _callbacks.erase(cb_it);
-                    }
-                    _callbacks_expirations.erase(exp_it);
-                }
-            }); /// fc::async
-
-        }
-
         void network_broadcast_api::broadcast_transaction(const signed_transaction &trx) {
             trx.validate();
 
@@ -226,8 +183,10 @@ namespace golos {
             } else {
                 FC_ASSERT(!check_max_block_age(_max_block_age));
                 trx.validate();
-                _callbacks[trx.id()] = cb;
-                _callbacks_expirations[trx.expiration].push_back(trx.id());
+                _app.get_subscription_hub()->subscribe_transaction(shared_from_this(), trx.id(), trx.expiration,
+                        [cb](const transaction_id_type &id, int32_t block_num, int32_t trx_num, bool expired) {
+                            cb(fc::variant(transaction_confirmation(id, block_num, trx_num, expired)));
+                        });
 
                 _app.chain_database()->push_transaction(trx);
                 _app.p2p_node()->broadcast_transaction(trx);
@@ -277,11 +236,16 @@ namespace golos {
         vector<account_asset_balance> asset_api::get_asset_holders(std::string asset_symbol, uint32_t start, uint32_t limit) const {
             FC_ASSERT(limit <= 100);
 
-            const auto &bal_idx = _db.get_index<account_balance_index>().indices().get<by_asset_balance>();
-            auto range = bal_idx.equal_range(boost::make_tuple(asset_symbol));
-
             vector<account_asset_balance> result;
 
+            const asset_object *asset_obj = _db.find_asset(asset_symbol);
+            if (asset_obj == nullptr) {
+                return result;
+            }
+
+            const auto &bal_idx = _db.get_index<account_balance_index>().indices().get<by_asset_balance>();
+            auto range = bal_idx.equal_range(boost::make_tuple(asset_obj->id));
+
             uint32_t index = 0;
             for (const account_balance_object &bal : boost::make_iterator_range(range.first, range.second)) {
                 if (result.size() >= limit) {
@@ -311,8 +275,13 @@ namespace golos {
         // get number of asset holders.
         int asset_api::get_asset_holders_count(std::string asset_symbol) const {
 
+            const asset_object *asset_obj = _db.find_asset(asset_symbol);
+            if (asset_obj == nullptr) {
+                return 0;
+            }
+
             const auto &bal_idx = _db.get_index<account_balance_index>().indices().get<by_asset_balance>();
-            auto range = bal_idx.equal_range(boost::make_tuple(asset_symbol));
+            auto range = bal_idx.equal_range(boost::make_tuple(asset_obj->id));
 
             return (boost::distance(range) - 1);
         }
@@ -329,7 +298,7 @@ namespace golos {
                 asset_name_type asset_id = dasset_obj.asset_name;
 
                 const auto &bal_idx = _db.get_index<account_balance_index>().indices().get<by_asset_balance>();
-                auto range = bal_idx.equal_range(boost::make_tuple(asset_id));
+                auto range = bal_idx.equal_range(boost::make_tuple(asset_obj.id));
 
                 int count = boost::distance(range) - 1;
 
@@ -0,0 +1,119 @@
+#include <golos/application/api_method_stats.hpp>
+
+#include <algorithm>
+#include <cctype>
+
+namespace golos {
+    namespace application {
+
+        namespace {
+            /// Number of methods written to the log, the ones with the largest total time
+            const std::size_t logged_methods = 20;
+        }
+
+        constexpr std::array<uint64_t, 5> api_method_stats::latency_buckets;
+
+        const std::string api_method_stats::unknown_method = "<unknown>";
+
+        api_method_stats::api_method_stats(chain::database &db) : _db(db) {
+        }
+
+        void api_method_stats::add_api(const std::string &api, const std::vector<std::string> &methods) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _apis[api].insert(methods.begin(), methods.end());
+            _api_methods.insert(methods.begin(), methods.end());
+        }
+
+        api_method_stats_entry &api_method_stats::entry_for(const std::string &api, const std::string &method) {
+            std::pair<std::string, std::string> key(std::string(), unknown_method);
+
+            auto itr = _apis.find(api);
+            if (itr != _apis.end()) {
+                if (itr->second.count(method)) {
+                    key = std::make_pair(api, method);
+                }
+            } else if (std::all_of(api.begin(), api.end(), [](char c) {
+                return std::isdigit(static_cast<unsigned char>(c));
+            })) {
+                if (_api_methods.count(method)) {
+                    key.second = method;
+                }
+            }
+
+            auto &entry = _methods[key];
+            if (entry.latency_histogram.empty()) {
+                entry.api = key.first;
+                entry.method = key.second;
+                entry.latency_histogram.resize(latency_buckets.size() + 1);
+            }
+            return entry;
+        }
+
+        void api_method_stats::record(const std::string &api, const std::string &method, fc::microseconds time,
+                                      bool error, std::size_t response_bytes, uint64_t lock_wait_time) {
+            const uint64_t elapsed = std::max<int64_t>(time.count(), 0);
+            const auto bucket = std::lower_bound(latency_buckets.begin(), latency_buckets.end(), elapsed) -
+                                latency_buckets.begin();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto &entry = entry_for(api, method);
+
+            ++entry.calls;
+            if (error) {
+                ++entry.errors;
+            }
+            entry.total_time += elapsed;
+            entry.max_time = std::max(entry.max_time, elapsed);
+            ++entry.latency_histogram[bucket];
+            entry.response_bytes += response_bytes;
+            entry.max_response_bytes = std::max<uint64_t>(entry.max_response_bytes, response_bytes);
+            entry.lock_wait_time += lock_wait_time;
+        }
+
+        api_method_stats_result api_method_stats::get_stats() const {
+            api_method_stats_result result;
+            result.latency_buckets.assign(latency_buckets.begin(), latency_buckets.end());
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            result.methods.reserve(_methods.size());
+            for (const auto &entry : _methods) {
+                result.methods.push_back(entry.second);
+            }
+            return result;
+        }
+
+        void api_method_stats::set_log_interval(uint32_t interval) {
+            _applied_block_connection.disconnect();
+            if (interval == 0) {
+                return;
+            }
+
+            _applied_block_connection = _db.applied_block.connect([this, interval](const protocol::signed_block &b) {
+                if (b.block_num() % interval == 0) {
+                    log();
+                }
+            });
+        }
+
+        void api_method_stats::log() const {
+            auto methods = get_stats().methods;
+            std::sort(methods.begin(), methods.end(), [](const api_method_stats_entry &a,
+                                                         const api_method_stats_entry &b) {
+                return a.total_time > b.total_time;
+            });
+            if (methods.size() > logged_methods) {
+                methods.resize(logged_methods);
+            }
+
+            for (const auto &stats : methods) {
+                ilog("API ${a}.${m}: ${c} calls, ${e} errors, ${t} ms total, ${avg} us average, ${max} us max, "
+                     "${w} ms lock wait, ${b} bytes average reply",
+                     ("a", stats.api)("m", stats.method)("c", stats.calls)("e", stats.errors)
+                             ("t", stats.total_time / 1000)("avg", stats.total_time / stats.calls)
+                             ("max", stats.max_time)("w", stats.lock_wait_time / 1000)
+                             ("b", stats.response_bytes / stats.calls));
+            }
+        }
+
+    }
+} // golos::application
@@ -0,0 +1,60 @@
+#include <golos/application/api_response_cache.hpp>
+
+namespace golos {
+    namespace application {
+
+        api_response_cache::api_response_cache(chain::database &db) : _db(db) {
+        }
+
+        void api_response_cache::set_max_size(uint32_t max_size) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _max_size = max_size;
+            _entries.clear();
+        }
+
+        std::string api_response_cache::fetch(const std::string &key, const std::function<std::string()> &compute) {
+            if (_max_size == 0) {
+                return compute();
+            }
+
+            const auto block_id = _db.with_read_lock([&]() {
+                return _db.head_block_id();
+            });
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (block_id != _block_id) {
+                    _entries.clear();
+                    _block_id = block_id;
+                }
+
+                auto itr = _entries.find(key);
+                if (itr != _entries.end()) {
+                    ++_hits;
+                    return itr->second;
+                }
+                ++_misses;
+            }
+
+            // a result computed after the next block is newer, never older than block_id
+            auto result = compute();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (block_id == _block_id && _entries.size() < _max_size) {
+                _entries.emplace(key, result);
+            }
+            return result;
+        }
+
+        api_response_cache_stats api_response_cache::get_stats() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            api_response_cache_stats result;
+            result.max_size = _max_size;
+            result.size = _entries.size();
+            result.hits = _hits;
+            result.misses = _misses;
+            return result;
+        }
+
+    }
+} // golos::application
@@ -0,0 +1,96 @@
+#include <golos/application/api_thread_pool.hpp>
+
+namespace golos {
+    namespace application {
+
+        namespace {
+            thread_local bool pool_thread = false;
+            thread_local lock_wait_scope *current_wait_scope = nullptr;
+
+            template<typename T>
+            void update_max(std::atomic<T> &max, T value) {
+                T current = max;
+                while (current < value && !max.compare_exchange_weak(current, value)) {
+                }
+            }
+        }
+
+        lock_wait_scope::lock_wait_scope() {
+            current_wait_scope = this;
+        }
+
+        lock_wait_scope::~lock_wait_scope() {
+            if (current_wait_scope == this) {
+                current_wait_scope = nullptr;
+            }
+        }
+
+        lock_wait_scope *lock_wait_scope::current() {
+            return current_wait_scope;
+        }
+
+        void lock_wait_scope::set_current(lock_wait_scope *scope) {
+            current_wait_scope = scope;
+        }
+
+        api_thread_pool::api_thread_pool(chain::database &db) : _db(db) {
+        }
+
+        api_thread_pool::~api_thread_pool() {
+            for (auto &thread : _threads) {
+                thread->quit();
+            }
+        }
+
+        void api_thread_pool::start(uint32_t threads) {
+            FC_ASSERT(_threads.empty(), "API thread pool is already started");
+
+            for (uint32_t i = 0; i < threads; ++i) {
+                _threads.emplace_back(new fc::thread("api_" + std::to_string(i)));
+                _threads.back()->async([]() {
+                    pool_thread = true;
+                }).wait();
+            }
+
+            if (threads) {
+                ilog("Executing read API calls on ${n} threads", ("n", threads));
+            }
+        }
+
+        bool api_thread_pool::on_pool_thread() {
+            return pool_thread;
+        }
+
+        api_thread_pool_stats api_thread_pool::get_stats() const {
+            api_thread_pool_stats result;
+            result.threads = _threads.size();
+            result.queue_depth = _queue_depth;
+            result.max_queue_depth = _max_queue_depth;
+            result.calls = _calls;
+            result.total_wait_time = _total_wait_time;
+            result.max_wait_time = _max_wait_time;
+            result.total_run_time = _total_run_time;
+            return result;
+        }
+
+        api_thread_pool::call_scope::call_scope(api_thread_pool &pool, lock_wait_scope *wait_scope)
+                : _pool(pool), _wait_scope(wait_scope), _queued(fc::time_point::now()), _started(_queued) {
+            update_max(_pool._max_queue_depth, ++_pool._queue_depth);
+        }
+
+        api_thread_pool::call_scope::~call_scope() {
+            const uint64_t wait = (_started - _queued).count();
+            --_pool._queue_depth;
+            ++_pool._calls;
+            _pool._total_wait_time += wait;
+            update_max(_pool._max_wait_time, wait);
+            _pool._total_run_time += (fc::time_point::now() - _started).count();
+            lock_wait_scope::set_current(_wait_scope);
+        }
+
+        void api_thread_pool::call_scope::started() {
+            _started = fc::time_point::now();
+        }
+
+    }
+} // golos::application
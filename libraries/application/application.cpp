@@ -1,4 +1,10 @@
 #include <golos/application/api.hpp>
+#include <golos/application/api_method_stats.hpp>
+#include <golos/application/api_response_cache.hpp>
+#include <golos/application/api_thread_pool.hpp>
+#include <golos/application/batch_api_connection.hpp>
+#include <golos/application/json_writer.hpp>
+#include <golos/application/subscription_hub.hpp>
 
 #include <golos/chain/database_exceptions.hpp>
 
@@ -175,7 +181,11 @@ namespace golos {
 
                 void on_connection(const fc::http::websocket_connection_ptr &c) {
                     std::shared_ptr<api_session_data> session = std::make_shared<api_session_data>();
-                    session->wsc = std::make_shared<fc::rpc::websocket_api_connection>(*c);
+                    auto wsc = std::make_shared<batch_api_connection>(*c, _rpc_batch_max_size, _api_method_stats,
+                                                                      _api_response_cache);
+                    add_binary_methods(*wsc, session);
+                    add_json_methods(*wsc, session);
+                    session->wsc = wsc;
 
                     for (const std::string &name : _public_apis) {
                         api_context ctx(*_self, name, session);
@@ -190,10 +200,121 @@ namespace golos {
                     c->set_session_data(session);
                 }
 
+                /// Block and history export methods that can answer with fc::raw packed results
+                static void add_binary_methods(batch_api_connection &wsc, std::weak_ptr<api_session_data> session) {
+                    auto get_database_api = [session]() {
+                        auto s = session.lock();
+                        FC_ASSERT(s);
+                        auto itr = s->api_map.find("database_api");
+                        FC_ASSERT(itr != s->api_map.end() && itr->second, "database_api is not available");
+                        return itr->second->as<database_api>();
+                    };
+
+                    wsc.add_binary_method("database_api", "get_block", [get_database_api](const fc::variants &args) {
+                        FC_ASSERT(args.size() == 1);
+                        return fc::raw::pack(get_database_api()->get_block(args[0].as<uint32_t>()));
+                    });
+                    wsc.add_binary_method("database_api", "get_ops_in_block", [get_database_api](const fc::variants &args) {
+                        FC_ASSERT(args.size() == 1 || args.size() == 2);
+                        const bool only_virtual = args.size() == 1 || args[1].as<bool>();
+                        return fc::raw::pack(get_database_api()->get_ops_in_block(args[0].as<uint32_t>(), only_virtual));
+                    });
+                    wsc.add_binary_method("database_api", "get_account_history", [get_database_api](const fc::variants &args) {
+                        FC_ASSERT(args.size() == 3);
+                        return fc::raw::pack(get_database_api()->get_account_history(
+                                args[0].as_string(), args[1].as<uint64_t>(), args[2].as<uint32_t>()));
+                    });
+                }
+
+                /// Methods with large results, written by json_writer without building an fc::variant
+                static void add_json_methods(batch_api_connection &wsc, std::weak_ptr<api_session_data> session) {
+                    auto get_database_api = [session]() {
+                        auto s = session.lock();
+                        FC_ASSERT(s);
+                        auto itr = s->api_map.find("database_api");
+                        FC_ASSERT(itr != s->api_map.end() && itr->second, "database_api is not available");
+                        return itr->second->as<database_api>();
+                    };
+
+                    wsc.add_json_method("database_api", "get_block", 1, [get_database_api](const fc::variants &args) {
+                        return to_json(get_database_api()->get_block(args[0].as<uint32_t>()));
+                    });
+                    wsc.add_json_method("database_api", "get_ops_in_block", 2, [get_database_api](const fc::variants &args) {
+                        return to_json(get_database_api()->get_ops_in_block(args[0].as<uint32_t>(), args[1].as<bool>()));
+                    });
+                    wsc.add_json_method("database_api", "get_account_history", 3, [get_database_api](const fc::variants &args) {
+                        return to_json(get_database_api()->get_account_history(
+                                args[0].as_string(), args[1].as<uint64_t>(), args[2].as<uint32_t>()));
+                    });
+                    wsc.add_json_method("database_api", "get_accounts", 1, [get_database_api](const fc::variants &args) {
+                        return to_json(get_database_api()->get_accounts(args[0].as<std::vector<std::string>>()));
+                    });
+                    wsc.add_json_method("database_api", "get_content", 2, [get_database_api](const fc::variants &args) {
+                        return to_json(get_database_api()->get_content(args[0].as_string(), args[1].as_string()));
+                    });
+                    wsc.add_json_method("database_api", "get_content_replies", 2, [get_database_api](const fc::variants &args) {
+                        return to_json(get_database_api()->get_content_replies(args[0].as_string(), args[1].as_string()));
+                    });
+
+                    // the hot pages are shared between the sessions until the next block
+                    wsc.add_json_method("database_api", "get_trending_tags", 2, [get_database_api](const fc::variants &args) {
+                        return to_json(get_database_api()->get_trending_tags(args[0].as_string(), args[1].as<uint32_t>()));
+                    }, true);
+
+                    typedef std::function<std::vector<discussion>(fc::api<database_api> &, const discussion_query &)> discussions_getter;
+                    auto add_discussions = [&](const std::string &method, discussions_getter getter, bool cached = false) {
+                        wsc.add_json_method("database_api", method, 1, [get_database_api, getter](const fc::variants &args) {
+                            auto api = get_database_api();
+                            return to_json(getter(api, args[0].as<discussion_query>()));
+                        }, cached);
+                    };
+
+                    add_discussions("get_discussions_by_trending", [](fc::api<database_api> &api, const discussion_query &query) {
+                        return api->get_discussions_by_trending(query);
+                    }, true);
+                    add_discussions("get_discussions_by_created", [](fc::api<database_api> &api, const discussion_query &query) {
+                        return api->get_discussions_by_created(query);
+                    }, true);
+                    add_discussions("get_discussions_by_active", [](fc::api<database_api> &api, const discussion_query &query) {
+                        return api->get_discussions_by_active(query);
+                    });
+                    add_discussions("get_discussions_by_cashout", [](fc::api<database_api> &api, const discussion_query &query) {
+                        return api->get_discussions_by_cashout(query);
+                    });
+                    add_discussions("get_discussions_by_payout", [](fc::api<database_api> &api, const discussion_query &query) {
+                        return api->get_discussions_by_payout(query);
+                    });
+                    add_discussions("get_discussions_by_votes", [](fc::api<database_api> &api, const discussion_query &query) {
+                        return api->get_discussions_by_votes(query);
+                    });
+                    add_discussions("get_discussions_by_children", [](fc::api<database_api> &api, const discussion_query &query) {
+                        return api->get_discussions_by_children(query);
+                    });
+                    add_discussions("get_discussions_by_hot", [](fc::api<database_api> &api, const discussion_query &query) {
+                        return api->get_discussions_by_hot(query);
+                    }, true);
+                    add_discussions("get_discussions_by_feed", [](fc::api<database_api> &api, const discussion_query &query) {
+                        return api->get_discussions_by_feed(query);
+                    });
+                    add_discussions("get_discussions_by_blog", [](fc::api<database_api> &api, const discussion_query &query) {
+                        return api->get_discussions_by_blog(query);
+                    });
+                    add_discussions("get_discussions_by_comments", [](fc::api<database_api> &api, const discussion_query &query) {
+                        return api->get_discussions_by_comments(query);
+                    });
+                    add_discussions("get_discussions_by_promoted", [](fc::api<database_api> &api, const discussion_query &query) {
+                        return api->get_discussions_by_promoted(query);
+                    }, true);
+                }
+
                 application_impl(application *self)
                         : _self(self),
                         //_pending_trx_db(std::make_shared<golos::get_database::object_database>()),
-                          _chain_db(std::make_shared<chain::database>()) {
+                          _chain_db(std::make_shared<chain::database>()),
+                          _subscription_hub(std::make_shared<subscription_hub>(*_chain_db)),
+                          _api_thread_pool(std::make_shared<api_thread_pool>(*_chain_db)),
+                          _api_response_cache(std::make_shared<api_response_cache>(*_chain_db)),
+                          _api_method_stats(std::make_shared<api_method_stats>(*_chain_db)) {
                 }
 
                 ~application_impl() {
@@ -235,6 +356,29 @@ namespace golos {
 
                             _chain_db->set_flush_interval(_options->at("flush").as<uint32_t>());
 
+                            const auto virtual_operations = _options->at("virtual-operations").as<string>();
+                            if (virtual_operations == "auto") {
+                                _chain_db->set_virtual_operations_mode(chain::database::virtual_operations_auto);
+                            } else if (virtual_operations == "all") {
+                                _chain_db->set_virtual_operations_mode(chain::database::virtual_operations_all);
+                            } else if (virtual_operations == "none") {
+                                _chain_db->set_virtual_operations_mode(chain::database::virtual_operations_none);
+                            } else {
+                                FC_THROW("Unknown virtual-operations mode ${m}, expected auto, all or none",
+                                         ("m", virtual_operations));
+                            }
+
+                            _chain_db->set_state_hash(_options->at("state-hash").as<bool>(),
+                                                      _options->at("state-hash-log-interval").as<uint32_t>());
+                            _chain_db->set_background_invariants_check(
+                                    _options->at("validate-invariants-interval").as<uint32_t>(),
+                                    _options->at("validate-invariants-chunk-size").as<uint32_t>());
+                            _chain_db->set_plugin_handler_stats_log_interval(
+                                    _options->at("plugin-stats-log-interval").as<uint32_t>());
+                            _chain_db->set_deferred_plugin_indexing(_options->at("deferred-plugin-indexing").as<bool>());
+                            _chain_db->set_plugin_rebuild_after_reindex(_shared_dir / "plugin_operations.log",
+                                                                        _options->at("plugin-rebuild-threads").as<uint32_t>());
+
                             flat_map<uint32_t, block_id_type> loaded_checkpoints;
                             if (_options->count("checkpoint")) {
                                 auto cps = _options->at("checkpoint").as<vector<string>>();
@@ -246,7 +390,15 @@ namespace golos {
                             }
                             _chain_db->add_checkpoints(loaded_checkpoints);
 
-                            if (_options->count("replay-blockchain")) {
+                            uint32_t snapshot_threads = _options->at("state-snapshot-threads").as<uint32_t>();
+
+                            if (_options->count("load-state-snapshot")) {
+                                ilog("Loading state snapshot on user request.");
+                                _chain_db->wipe(_data_dir / "blockchain", _shared_dir, false);
+                                _chain_db->open(_data_dir /
+                                                "blockchain", _shared_dir, STEEMIT_INIT_SUPPLY, _shared_file_size, chainbase::database::read_write,
+                                                fc::path(_options->at("load-state-snapshot").as<string>()), snapshot_threads);
+                            } else if (_options->count("replay-blockchain")) {
                                 ilog("Replaying blockchain on user request.");
                                 _chain_db->reindex(_data_dir /
                                                    "blockchain", _shared_dir, _shared_file_size);
@@ -275,6 +427,27 @@ namespace golos {
                                 ilog("All transaction signatures will be validated");
                                 _force_validate = true;
                             }
+
+                            if (_options->count("dump-state-snapshot")) {
+                                _chain_db->export_state_snapshot(
+                                        fc::path(_options->at("dump-state-snapshot").as<string>()), snapshot_threads);
+                            }
+
+                            if (_options->count("compact-shared-memory")) {
+                                auto compact_dir = fc::path(_options->at("compact-shared-memory").as<string>());
+
+                                // the open above has rewound the undo history, the copy itself only reads the old file
+                                _chain_db->close();
+                                _chain_db->open(_data_dir /
+                                                "blockchain", _shared_dir, STEEMIT_INIT_SUPPLY, _shared_file_size, chainbase::database::read_only);
+                                _chain_db->compact_shared_memory(compact_dir, _shared_file_size);
+                                ilog("Restart the node with shared-file-dir = ${d} to use the compacted shared memory file",
+                                     ("d", compact_dir));
+
+                                // the opened state is the old file, the node must not go on with it
+                                _self->_exit_after_startup = true;
+                                return;
+                            }
                         } else {
                             ilog("Starting Golos node in read mode.");
                             _chain_db->open(_data_dir /
@@ -290,6 +463,20 @@ namespace golos {
                             }
                         }
 
+                        if (_options->at("log-memory-usage").as<bool>()) {
+                            _chain_db->with_read_lock([&]() {
+                                uint64_t total = 0;
+                                for (const auto &usage : _chain_db->get_memory_usage()) {
+                                    ilog("  ${n}: ${c} objects, ${t} bytes (objects ${o}, dynamic ${d}, nodes ${i})",
+                                         ("n", usage.name)("c", usage.count)("t", usage.total_bytes)
+                                         ("o", usage.object_bytes)("d", usage.dynamic_bytes)("i", usage.node_bytes));
+                                    total += usage.total_bytes;
+                                }
+                                ilog("Shared memory used by indexes: ${t} bytes, free: ${f} bytes",
+                                     ("t", total)("f", _chain_db->get_free_memory()));
+                            });
+                        }
+
                         if (_options->count("api-user")) {
                             for (const std::string &api_access_str : _options->at("api-user").as<std::vector<std::string>>()) {
                                 api_access_info info = fc::json::from_string(api_access_str).as<api_access_info>();
@@ -324,6 +511,11 @@ namespace golos {
                             reset_p2p_node(_data_dir);
                         }
 
+                        _api_thread_pool->start(_options->at("api-threads").as<uint32_t>());
+                        _rpc_batch_max_size = _options->at("rpc-batch-max-size").as<uint32_t>();
+                        _api_response_cache->set_max_size(_options->at("api-response-cache-size").as<uint32_t>());
+                        _api_method_stats->set_log_interval(_options->at("api-stats-log-interval").as<uint32_t>());
+
                         reset_websocket_server();
                         reset_websocket_tls_server();
                     } FC_LOG_AND_RETHROW()
@@ -817,6 +1009,11 @@ namespace golos {
 
                 //std::shared_ptr<golos::get_database::object_database>   _pending_trx_db;
                 std::shared_ptr<golos::chain::database> _chain_db;
+                std::shared_ptr<subscription_hub> _subscription_hub;
+                std::shared_ptr<api_thread_pool> _api_thread_pool;
+                std::shared_ptr<api_response_cache> _api_response_cache;
+                std::shared_ptr<api_method_stats> _api_method_stats;
+                uint32_t _rpc_batch_max_size = 0;
                 std::shared_ptr<network::node> _p2p_network;
                 std::shared_ptr<fc::http::websocket_server> _websocket_server;
                 std::shared_ptr<fc::http::websocket_tls_server> _websocket_tls_server;
@@ -887,11 +1084,28 @@ namespace golos {
                     ("enable-plugin", bpo::value<vector<string>>()->composing()->default_value(default_plugins, str_default_plugins), "Plugin(s) to enable, may be specified multiple times")
                     ("max-block-age", bpo::value<int32_t>()->default_value(200), "Maximum age of head block when broadcasting tx via API")
                                         ("flush", bpo::value<uint32_t>()->default_value(100000), "Flush shared memory file to disk this many blocks")
+                    ("virtual-operations", bpo::value<string>()->default_value("auto"), "Emit virtual operations: auto (only the ones some plugin subscribes to), all or none")
+                    ("state-hash", bpo::value<bool>()->default_value(false), "Maintain an incremental checksum of the chain state to compare builds block by block")
+                    ("state-hash-log-interval", bpo::value<uint32_t>()->default_value(10000), "Log the state checksum every this many blocks, 0 disables logging")
+                    ("validate-invariants-interval", bpo::value<uint32_t>()->default_value(0), "Check chain state invariants on a background thread every this many blocks, 0 disables the check")
+                    ("validate-invariants-chunk-size", bpo::value<uint32_t>()->default_value(10000), "Maximum number of objects checked under one read lock by the background invariants check")
+                    ("plugin-stats-log-interval", bpo::value<uint32_t>()->default_value(0), "Log the time plugins spent handling blocks and operations every this many blocks, 0 disables logging")
+                    ("deferred-plugin-indexing", bpo::value<bool>()->default_value(false), "Update account history and market history indexes in a deferred task on the chain thread after a block is pushed")
+                    ("plugin-rebuild-threads", bpo::value<uint32_t>()->default_value(0), "Replay consensus first and rebuild account history and market history indexes afterwards on this many threads, 0 updates them during the replay")
+                    ("log-memory-usage", bpo::value<bool>()->default_value(false), "Log the approximate shared memory usage of every index on startup")
+                    ("state-snapshot-threads", bpo::value<uint32_t>()->default_value(0), "Number of threads used to write and verify state snapshots, 0 means the number of cores")
+                    ("api-threads", bpo::value<uint32_t>()->default_value(0), "Number of threads executing read-only API calls concurrently, 0 executes them on the main thread")
+                    ("rpc-batch-max-size", bpo::value<uint32_t>()->default_value(100), "Maximum number of requests in a JSON-RPC batch")
+                    ("api-response-cache-size", bpo::value<uint32_t>()->default_value(0), "Maximum number of encoded discussion and trending tags replies cached until the next block, 0 disables the cache")
+                    ("api-stats-log-interval", bpo::value<uint32_t>()->default_value(0), "Log the call counts and latencies of the busiest API methods every this many blocks, 0 disables logging")
                     ("statsd_port", bpo::value<uint32_t>()->default_value(8125), "Statsd agregators port");
             command_line_options.add(configuration_file_options);
             command_line_options.add_options()
                     ("replay-blockchain", "Rebuild object graph by replaying all blocks")
                     ("resync-blockchain", "Delete all blocks and re-sync with network from scratch")
+                    ("load-state-snapshot", bpo::value<string>(), "Replace the chain state with the state snapshot from this directory, the block log must contain its head block")
+                    ("dump-state-snapshot", bpo::value<string>(), "Write a state snapshot of the opened chain state to this directory")
+                    ("compact-shared-memory", bpo::value<string>(), "Copy the chain state into a new, defragmented shared memory file in this directory and exit")
                     ("force-validate", "Force validation of all transactions")
                     ("read-only", "Node will not connect to p2p network and can only read from the chain state")
                     ("check-locks", "Check correctness of chainbase locking");
@@ -934,6 +1148,22 @@ namespace golos {
             return my->_chain_db;
         }
 
+        std::shared_ptr<subscription_hub> application::get_subscription_hub() const {
+            return my->_subscription_hub;
+        }
+
+        std::shared_ptr<api_thread_pool> application::get_api_thread_pool() const {
+            return my->_api_thread_pool;
+        }
+
+        std::shared_ptr<api_response_cache> application::get_api_response_cache() const {
+            return my->_api_response_cache;
+        }
+
+        std::shared_ptr<api_method_stats> application::get_api_method_stats() const {
+            return my->_api_method_stats;
+        }
+
 /*std::shared_ptr<golos::get_database::object_database> application::pending_trx_database() const
 {
    return my->_pending_trx_db;
@@ -955,6 +1185,10 @@ namespace golos {
             return my->register_api_factory(name, factory);
         }
 
+        void application::register_api_methods(const string &name, const std::vector<std::string> &methods) {
+            my->_api_method_stats->add_api(name, methods);
+        }
+
         fc::api_ptr application::create_api_by_name(const api_context &ctx) {
             return my->create_api_by_name(ctx);
         }
@@ -0,0 +1,304 @@
+#include <golos/application/batch_api_connection.hpp>
+#include <golos/application/api_thread_pool.hpp>
+
+#include <fc/crypto/base64.hpp>
+#include <fc/io/json.hpp>
+#include <fc/rpc/state.hpp>
+#include <fc/thread/thread.hpp>
+#include <fc/variant_object.hpp>
+
+#include <cctype>
+#include <vector>
+
+namespace golos {
+    namespace application {
+
+        namespace {
+            /// JSON-RPC 2.0 error codes
+            const int64_t parse_error = -32700;
+            const int64_t invalid_request = -32600;
+
+            bool is_batch(const std::string &message) {
+                for (char c : message) {
+                    if (!std::isspace(static_cast<unsigned char>(c))) {
+                        return c == '[';
+                    }
+                }
+                return false;
+            }
+
+            /// {"method":"call","params":[api, method, args]} names the api, other requests only the method
+            std::pair<std::string, std::string> method_name(const fc::variant_object &request) {
+                if (!request.contains("method") || !request["method"].is_string()) {
+                    return {};
+                }
+
+                auto method = request["method"].as_string();
+                if (method == "call" && request.contains("params")) {
+                    const auto &params = request["params"];
+                    if (params.is_array() && params.size() >= 2 && params[1].is_string()) {
+                        return {params[0].as_string(), params[1].as_string()};
+                    }
+                }
+                return {std::string(), method};
+            }
+
+            /// Names and arguments of {"id":..., "method":"call", "params":[api, method, args]}
+            bool parse_call(const fc::variant_object &request, std::string &name, const fc::variants *&args) {
+                if (!request.contains("id") || !request.contains("params") || !request.contains("method") ||
+                    !request["method"].is_string() || request["method"].as_string() != "call") {
+                    return false;
+                }
+                const auto &params = request["params"];
+                if (!params.is_array() || params.size() != 3 || !params[0].is_string() || !params[1].is_string() ||
+                    !params[2].is_array()) {
+                    return false;
+                }
+
+                name = params[0].as_string() + "." + params[1].as_string();
+                args = &params[2].get_array();
+                return true;
+            }
+
+            /// The reply of websocket_api_connection to a call which has thrown
+            std::string exception_reply(const fc::rpc::request &call, const fc::exception &e) {
+                return fc::json::to_string(fc::rpc::response(*call.id, fc::rpc::error_object{
+                        1, e.to_detail_string(), fc::variant(e)}));
+            }
+
+            std::string error_reply(int64_t code, const std::string &message) {
+                return fc::json::to_string(fc::mutable_variant_object()
+                        ("id", fc::variant())
+                        ("jsonrpc", "2.0")
+                        ("error", fc::mutable_variant_object()("code", code)("message", message)));
+            }
+        }
+
+        batch_api_connection::batch_api_connection(fc::http::websocket_connection &c, uint32_t max_batch_size,
+                                                   std::shared_ptr<api_method_stats> stats,
+                                                   std::shared_ptr<api_response_cache> cache)
+                : fc::rpc::websocket_api_connection(c), _max_batch_size(max_batch_size), _stats(std::move(stats)),
+                  _cache(std::move(cache)) {
+            // replace the handlers installed by websocket_api_connection
+            c.on_message_handler([this](const std::string &message) {
+                on_request(message, true);
+            });
+            c.on_http_handler([this](const std::string &message) {
+                return on_request(message, false);
+            });
+        }
+
+        std::string batch_api_connection::on_request(const std::string &message, bool send_message) {
+            fc::variant request;
+            std::string reply;
+            try {
+                request = fc::json::from_string(message);
+            } catch (const fc::exception &e) {
+                reply = error_reply(parse_error, e.to_string());
+            }
+
+            if (reply.empty()) {
+                if (!is_batch(message)) {
+                    return on_call(request, send_message);
+                }
+                reply = on_batch(request.get_array());
+            }
+
+            if (send_message && !reply.empty()) {
+                _connection.send_message(reply);
+            }
+            return reply;
+        }
+
+        std::string batch_api_connection::on_batch(const fc::variants &requests) {
+            if (requests.empty()) {
+                return error_reply(invalid_request, "Empty batch");
+            }
+            if (requests.size() > _max_batch_size) {
+                return error_reply(invalid_request,
+                                   "Batch of " + std::to_string(requests.size()) + " requests exceeds the limit of " +
+                                   std::to_string(_max_batch_size));
+            }
+
+            std::vector<fc::future<std::string>> replies;
+            replies.reserve(requests.size());
+            for (const auto &request : requests) {
+                replies.push_back(fc::async([this, &request]() {
+                    return on_call(request, false);
+                }, "batch_call"));
+            }
+
+            std::string result;
+            for (auto &reply : replies) {
+                auto text = reply.wait();
+                if (text.empty()) {
+                    continue;
+                }
+                result += result.empty() ? "[" : ",";
+                result += text;
+            }
+
+            // a batch of notifications has no reply
+            if (!result.empty()) {
+                result += "]";
+            }
+            return result;
+        }
+
+        void batch_api_connection::add_json_method(const std::string &api, const std::string &method, uint32_t arity,
+                                                   json_method handler, bool cached) {
+            _json_methods[api + "." + method] = json_method_entry{arity, std::move(handler), cached};
+        }
+
+        void batch_api_connection::add_binary_method(const std::string &api, const std::string &method,
+                                                     binary_method handler) {
+            _binary_methods[api + "." + method] = std::move(handler);
+        }
+
+        std::vector<std::string> batch_api_connection::set_binary_results(bool enabled) {
+            _binary_results = enabled;
+
+            std::vector<std::string> result;
+            if (enabled) {
+                for (const auto &method : _binary_methods) {
+                    result.push_back(method.first);
+                }
+            }
+            return result;
+        }
+
+        std::string batch_api_connection::on_call(const fc::variant &message, bool send_message) {
+            lock_wait_scope wait_scope;
+            const auto start = fc::time_point::now();
+
+            fc::variant_object request;
+            if (message.is_object()) {
+                request = message.get_object();
+            }
+
+            std::string reply;
+            bool error = false;
+            if ((!_binary_results || !on_binary_call(message, reply, error)) && !on_json_call(message, reply, error)) {
+                reply = dispatch(message, error);
+            }
+
+            if (send_message && !reply.empty()) {
+                _connection.send_message(reply);
+            }
+
+            if (_stats) {
+                const auto name = method_name(request);
+                _stats->record(name.first, name.second, fc::time_point::now() - start, error, reply.size(),
+                               wait_scope.wait_time());
+            }
+            return reply;
+        }
+
+        std::string batch_api_connection::dispatch(const fc::variant &message, bool &error) {
+            // websocket_api_connection::on_message() for a message which is already parsed
+            try {
+                if (!message.get_object().contains("method")) {
+                    _rpc_state.handle_reply(message.as<fc::rpc::response>());
+                    return std::string();
+                }
+
+                auto call = message.as<fc::rpc::request>();
+                try {
+                    auto result = _rpc_state.local_call(call.method, call.params);
+                    if (call.id) {
+                        return fc::json::to_string(fc::rpc::response(*call.id, result));
+                    }
+                } catch (const fc::exception &e) {
+                    error = true;
+                    if (call.id) {
+                        return exception_reply(call, e);
+                    }
+                }
+            } catch (const fc::exception &e) {
+                // not an object, or not a request nor a reply
+                error = true;
+                return error_reply(invalid_request, e.to_string());
+            }
+            return std::string();
+        }
+
+        bool batch_api_connection::on_json_call(const fc::variant &message, std::string &reply, bool &error) {
+            if (_json_methods.empty() || !message.is_object()) {
+                return false;
+            }
+
+            std::string name;
+            const fc::variants *args = nullptr;
+            if (!parse_call(message.get_object(), name, args)) {
+                return false;
+            }
+
+            auto itr = _json_methods.find(name);
+            if (itr == _json_methods.end() || args->size() != itr->second.arity) {
+                return false;
+            }
+
+            auto call = message.as<fc::rpc::request>();
+            if (!call.id) {
+                return false;
+            }
+
+            // the same reply as fc::json::to_string(fc::rpc::response(id, result))
+            try {
+                const auto &entry = itr->second;
+                const auto result = entry.cached && _cache
+                                    ? _cache->fetch(name + fc::json::to_string(fc::variant(*args)), [&]() {
+                                        return entry.handler(*args);
+                                    })
+                                    : entry.handler(*args);
+                reply = "{\"id\":" + fc::json::to_string(fc::variant(*call.id)) + ",\"jsonrpc\":\"2.0\",\"result\":" +
+                        result + "}";
+            } catch (const fc::exception &e) {
+                error = true;
+                reply = exception_reply(call, e);
+            }
+            return true;
+        }
+
+        bool batch_api_connection::on_binary_call(const fc::variant &message, std::string &reply, bool &error) {
+            // only {"id":..., "method":"call", "params":[api, method, args]}, the rest goes the JSON way
+            if (!message.is_object()) {
+                return false;
+            }
+
+            std::string name;
+            const fc::variants *args = nullptr;
+            if (!parse_call(message.get_object(), name, args)) {
+                return false;
+            }
+
+            auto itr = _binary_methods.find(name);
+            if (itr == _binary_methods.end()) {
+                return false;
+            }
+
+            auto call = message.as<fc::rpc::request>();
+            if (!call.id) {
+                return false;
+            }
+
+            std::vector<char> packed;
+            try {
+                packed = itr->second(*args);
+            } catch (const fc::exception &e) {
+                // the JSON error reply, the call is not run again on the JSON path
+                error = true;
+                reply = exception_reply(call, e);
+                return true;
+            }
+
+            const auto data = reinterpret_cast<const unsigned char *>(packed.data());
+            reply = fc::json::to_string(fc::mutable_variant_object()
+                    ("id", message["id"])
+                    ("jsonrpc", "2.0")
+                    ("result", fc::base64_encode(data, packed.size())));
+            return true;
+        }
+
+    }
+} // golos::application
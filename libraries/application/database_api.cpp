@@ -1,6 +1,7 @@
 #include <golos/application/api_context.hpp>
 #include <golos/application/application.hpp>
 #include <golos/application/database_api.hpp>
+#include <golos/application/subscription_hub.hpp>
 
 #include <golos/follow/follow_api.hpp>
 #include <golos/market_history/market_history_plugin.hpp>
@@ -12,12 +13,13 @@
 #include <golos/languages/languages_plugin.hpp>
 #include <golos/tags/tags_plugin.hpp>
 
-#include <fc/bloom_filter.hpp>
 #include <fc/smart_ref_impl.hpp>
 
 #include <boost/range/iterator_range.hpp>
 #include <boost/algorithm/string.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <cfenv>
 
 #define GET_REQUIRED_FEES_MAX_RECURSION 4
@@ -39,6 +41,9 @@ namespace golos {
 
             void set_block_applied_callback(std::function<void(const variant &block_id)> cb);
 
+            void set_block_feed_callback(std::function<void(const variant &)> cb, uint32_t start_block,
+                                         bool irreversible_only);
+
             void cancel_all_subscriptions();
 
             // Blocks and transactions
@@ -107,40 +112,27 @@ namespace golos {
             // Proposed transactions
             vector<proposal_object> get_proposed_transactions(account_name_type name) const;
 
-            template<typename T>
-            void subscribe_to_item(const T &i) const {
-                auto vec = fc::raw::pack(i);
-                if (!_subscribe_callback) {
+            /// Adds objects returned to the client to the ones it is notified about when they change
+            void subscribe_to_items(subscription_hub::changed_object_keys keys) const {
+                if (!_subscribed) {
                     return;
                 }
 
-                if (!is_subscribed_to_item(i)) {
-                    idump((i));
-                    _subscribe_filter.insert(vec.data(), vec.size());//(vecconst char*)&i, sizeof(i) );
-                }
-            }
-
-            template<typename T>
-            bool is_subscribed_to_item(const T &i) const {
-                if (!_subscribe_callback) {
-                    return false;
-                }
-
-                return _subscribe_filter.contains(i);
+                _subscription_hub->watch_changed_objects(
+                        std::const_pointer_cast<database_api_impl>(shared_from_this()), std::move(keys));
             }
 
-            // signal handlers
-            void on_applied_block(const chain::signed_block &b);
-
-            mutable fc::bloom_filter _subscribe_filter;
-            std::function<void(const fc::variant &)> _subscribe_callback;
+            /// Read by API calls running on the pool threads
+            std::atomic<bool> _subscribed{false};
             std::function<void(const fc::variant &)> _pending_trx_callback;
-            std::function<void(const fc::variant &)> _block_applied_callback;
 
             golos::chain::database &_db;
             std::shared_ptr<golos::follow::follow_api> _follow_api;
 
-            boost::signals2::scoped_connection _block_applied_connection;
+            std::shared_ptr<subscription_hub> _subscription_hub;
+            std::shared_ptr<api_thread_pool> _api_thread_pool;
+            std::shared_ptr<api_response_cache> _response_cache;
+            std::shared_ptr<api_method_stats> _method_stats;
 
             map<pair<asset_symbol_type, asset_symbol_type>, std::function<void(const variant &)>> _market_subscriptions;
         };
@@ -172,15 +164,8 @@ namespace golos {
         }
 
         void database_api_impl::set_subscribe_callback(std::function<void(const variant &)> cb, bool clear_filter) {
-            _subscribe_callback = cb;
-            if (clear_filter || !cb) {
-                static fc::bloom_parameters param;
-                param.projected_element_count = 10000;
-                param.false_positive_probability = 1.0 / 10000;
-                param.maximum_size = 1024 * 8 * 8 * 2;
-                param.compute_optimal_parameters();
-                _subscribe_filter = fc::bloom_filter(param);
-            }
+            _subscribed = bool(cb);
+            _subscription_hub->subscribe_changed_objects(shared_from_this(), cb, clear_filter);
         }
 
         void database_api::set_pending_transaction_callback(std::function<void(const variant &)> cb) {
@@ -199,17 +184,24 @@ namespace golos {
             });
         }
 
-        void database_api_impl::on_applied_block(const chain::signed_block &b) {
-            try {
-                _block_applied_callback(fc::variant(signed_block_header(b)));
-            } catch (...) {
-                _block_applied_connection.release();
-            }
+        void database_api_impl::set_block_applied_callback(std::function<void(const variant &block_header)> cb) {
+            _subscription_hub->subscribe_block_headers(shared_from_this(), cb);
         }
 
-        void database_api_impl::set_block_applied_callback(std::function<void(const variant &block_header)> cb) {
-            _block_applied_callback = cb;
-            _block_applied_connection = connect_signal(_db.applied_block, *this, &database_api_impl::on_applied_block);
+        void database_api::set_block_feed_callback(std::function<void(const variant &)> cb, uint32_t start_block,
+                                                   bool irreversible_only) {
+            my->_db.with_read_lock([&]() {
+                my->set_block_feed_callback(cb, start_block, irreversible_only);
+            });
+        }
+
+        void database_api_impl::set_block_feed_callback(std::function<void(const variant &)> cb, uint32_t start_block,
+                                                        bool irreversible_only) {
+            _subscription_hub->subscribe_block_feed(shared_from_this(), cb, start_block, irreversible_only);
+        }
+
+        void database_api::acknowledge_block_feed(uint32_t block_num) {
+            my->_subscription_hub->acknowledge_block_feed(my, block_num);
         }
 
         void database_api::cancel_all_subscriptions() {
@@ -220,6 +212,7 @@ namespace golos {
 
         void database_api_impl::cancel_all_subscriptions() {
             set_subscribe_callback(std::function<void(const fc::variant &)>(), true);
+            set_block_feed_callback(std::function<void(const fc::variant &)>(), 0, false);
         }
 
         //////////////////////////////////////////////////////////////////////
@@ -235,7 +228,10 @@ namespace golos {
         }
 
         database_api_impl::database_api_impl(const golos::application::api_context &ctx) : _db(
-                *ctx.app.chain_database()) {
+                *ctx.app.chain_database()), _subscription_hub(ctx.app.get_subscription_hub()),
+                _api_thread_pool(ctx.app.get_api_thread_pool()),
+                _response_cache(ctx.app.get_api_response_cache()),
+                _method_stats(ctx.app.get_api_method_stats()) {
             wlog("creating database api ${x}", ("x", int64_t(this)));
 
             try {
@@ -259,6 +255,7 @@ namespace golos {
         //                                                                  //
         //////////////////////////////////////////////////////////////////////
 
+        // the block log is not safe for concurrent reads, block getters stay on the calling thread
         optional<block_header> database_api::get_block_header(uint32_t block_num) const {
             return my->_db.with_read_lock([&]() {
                 return my->get_block_header(block_num);
@@ -284,7 +281,7 @@ namespace golos {
         }
 
         std::vector<applied_operation> database_api::get_ops_in_block(uint32_t block_num, bool only_virtual) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->get_ops_in_block(block_num, only_virtual);
             });
         }
@@ -313,7 +310,7 @@ namespace golos {
         //////////////////////////////////////////////////////////////////////=
 
         fc::variant_object database_api::get_config() const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->get_config();
             });
         }
@@ -322,30 +319,60 @@ namespace golos {
             return my->_db.get_free_memory();
         }
 
+        optional<uint64_t> database_api::get_state_hash(uint32_t block_num) const {
+            return my->_api_thread_pool->with_read_lock([&]() {
+                return my->_db.get_state_hash(block_num);
+            });
+        }
+
+        std::vector<plugin_handler_stats> database_api::get_plugin_handler_stats() const {
+            return my->_api_thread_pool->with_read_lock([&]() {
+                return my->_db.get_plugin_handler_stats();
+            });
+        }
+
+        uint32_t database_api::get_plugin_head_block_num() const {
+            return my->_api_thread_pool->with_read_lock([&]() {
+                return my->_db.plugin_head_block_num();
+            });
+        }
+
+        api_thread_pool_stats database_api::get_api_thread_pool_stats() const {
+            return my->_api_thread_pool->get_stats();
+        }
+
+        api_response_cache_stats database_api::get_api_response_cache_stats() const {
+            return my->_response_cache->get_stats();
+        }
+
+        api_method_stats_result database_api::get_api_method_stats() const {
+            return my->_method_stats->get_stats();
+        }
+
         fc::variant_object database_api_impl::get_config() const {
             return golos::protocol::get_config();
         }
 
         dynamic_global_property_object database_api::get_dynamic_global_properties() const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->get_dynamic_global_properties();
             });
         }
 
         chain_properties<0, 17, 0> database_api::get_chain_properties() const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->_db.get_witness_schedule_object().median_props;
             });
         }
 
         feed_history_api_obj database_api::get_feed_history() const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return feed_history_api_obj(my->_db.get_feed_history());
             });
         }
 
         price<0, 17, 0> database_api::get_current_median_history_price() const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->_db.get_feed_history().current_median_history;
             });
         }
@@ -355,19 +382,19 @@ namespace golos {
         }
 
         witness_schedule_object database_api::get_witness_schedule() const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->_db.get(witness_schedule_object::id_type());
             });
         }
 
         hardfork_version database_api::get_hardfork_version() const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->_db.get(hardfork_property_object::id_type()).current_hardfork_version;
             });
         }
 
         scheduled_hardfork database_api::get_next_scheduled_hardfork() const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 scheduled_hardfork shf;
                 const auto &hpo = my->_db.get(hardfork_property_object::id_type());
                 shf.hf_version = hpo.next_hardfork;
@@ -383,7 +410,7 @@ namespace golos {
         //////////////////////////////////////////////////////////////////////
 
         std::vector<extended_account> database_api::get_accounts(std::vector<std::string> names) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->get_accounts(names);
             });
         }
@@ -402,20 +429,26 @@ namespace golos {
                         results.back().reputation = _follow_api->get_account_reputations(itr->name, 1)[0].reputation;
                     }
 
-                    auto vitr = vidx.lower_bound(boost::make_tuple(itr->name, account_name_type()));
-                    while (vitr != vidx.end() && vitr->account == itr->name) {
-                        results.back().witness_votes.insert(_db.get_witness(vitr->witness).owner);
+                    auto vitr = vidx.lower_bound(itr->id);
+                    while (vitr != vidx.end() && vitr->account == itr->id) {
+                        results.back().witness_votes.insert(_db.get(vitr->witness).owner);
                         ++vitr;
                     }
                 }
             }
 
+            subscription_hub::changed_object_keys keys;
+            for (const auto &account : results) {
+                keys.accounts.insert(account.name);
+            }
+            subscribe_to_items(std::move(keys));
+
             return results;
         }
 
         std::vector<optional<account_api_obj>> database_api::lookup_account_names(
                 const std::vector<std::string> &account_names) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->lookup_account_names(account_names);
             });
         }
@@ -439,7 +472,7 @@ namespace golos {
         }
 
         std::set<std::string> database_api::lookup_accounts(const std::string &lower_bound_name, uint32_t limit) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->lookup_accounts(lower_bound_name, limit);
             });
         }
@@ -459,7 +492,7 @@ namespace golos {
         }
 
         uint64_t database_api::get_account_count() const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->get_account_count();
             });
         }
@@ -469,7 +502,7 @@ namespace golos {
         }
 
         std::vector<owner_authority_history_api_obj> database_api::get_owner_history(std::string account) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 std::vector<owner_authority_history_api_obj> results;
 
                 const auto &hist_idx = my->_db.get_index<owner_authority_history_index>().indices().get<by_account>();
@@ -485,7 +518,7 @@ namespace golos {
         }
 
         optional<account_recovery_request_api_obj> database_api::get_recovery_request(std::string account) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 optional<account_recovery_request_api_obj> result;
 
                 const auto &rec_idx = my->_db.get_index<account_recovery_request_index>().indices().get<by_account>();
@@ -499,13 +532,13 @@ namespace golos {
             });
         }
 
-        optional<escrow_object> database_api::get_escrow(std::string from, uint32_t escrow_id) const {
-            return my->_db.with_read_lock([&]() {
-                optional<escrow_object> result;
+        optional<escrow_api_obj> database_api::get_escrow(std::string from, uint32_t escrow_id) const {
+            return my->_api_thread_pool->with_read_lock([&]() {
+                optional<escrow_api_obj> result;
 
-                try {
-                    result = my->_db.get_escrow(from, escrow_id);
-                } catch (...) {
+                const auto *escrow = my->_db.find_escrow(from, escrow_id);
+                if (escrow != nullptr) {
+                    result = escrow_api_obj(*escrow, my->_db);
                 }
 
                 return result;
@@ -514,7 +547,7 @@ namespace golos {
 
         std::vector<withdraw_route> database_api::get_withdraw_routes(std::string account,
                                                                       withdraw_route_type type) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 std::vector<withdraw_route> result;
 
                 const auto &acc = my->_db.get_account(account);
@@ -579,7 +612,7 @@ namespace golos {
 
         std::vector<optional<witness_api_obj>> database_api::get_witnesses(
                 const std::vector<witness_object::id_type> &witness_ids) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->get_witnesses(witness_ids);
             });
         }
@@ -599,13 +632,13 @@ namespace golos {
         }
 
         fc::optional<witness_api_obj> database_api::get_witness_by_account(std::string account_name) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->get_witness_by_account(account_name);
             });
         }
 
         std::vector<witness_api_obj> database_api::get_witnesses_by_vote(std::string from, uint32_t limit) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 //idump((from)(limit));
                 FC_ASSERT(limit <= 100);
 
@@ -641,7 +674,7 @@ namespace golos {
 
         std::set<account_name_type> database_api::lookup_witness_accounts(const std::string &lower_bound_name,
                                                                           uint32_t limit) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->lookup_witness_accounts(lower_bound_name, limit);
             });
         }
@@ -670,7 +703,7 @@ namespace golos {
         }
 
         uint64_t database_api::get_witness_count() const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->get_witness_count();
             });
         }
@@ -700,6 +733,11 @@ namespace golos {
                 for (const account_balance_object &balance : boost::make_iterator_range(range.first, range.second)) {
                     result.push_back(balance.get_balance());
                 }
+
+                // the index is ordered by asset id, the result keeps the order by asset name
+                std::sort(result.begin(), result.end(), [](const asset<0, 17, 0> &a, const asset<0, 17, 0> &b) {
+                    return a.symbol < b.symbol;
+                });
             } else {
                 result.reserve(assets.size());
 
@@ -731,7 +769,6 @@ namespace golos {
                            [&](asset_name_type id) -> optional<asset_object> {
                                auto itr = idx.find(id);
                                if (itr != idx.end()) {
-                                   subscribe_to_item(id);
                                    return *itr;
                                }
                                return {};
@@ -768,7 +805,6 @@ namespace golos {
                            [&](string symbol) -> optional<asset_dynamic_data_object> {
                                auto itr = idx.find(symbol);
                                if (itr != idx.end()) {
-                                   subscribe_to_item(symbol);
                                    return *itr;
                                }
                                return {};
@@ -790,7 +826,6 @@ namespace golos {
                            [&](string symbol) -> optional<asset_bitasset_data_object> {
                                auto itr = idx.find(symbol);
                                if (itr != idx.end()) {
-                                   subscribe_to_item(symbol);
                                    return *itr;
                                }
                                return {};
@@ -829,7 +864,7 @@ namespace golos {
         //////////////////////////////////////////////////////////////////////
 
         std::string database_api::get_transaction_hex(const signed_transaction &trx) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->get_transaction_hex(trx);
             });
         }
@@ -840,7 +875,7 @@ namespace golos {
 
         std::set<public_key_type> database_api::get_required_signatures(const signed_transaction &trx, const flat_set<
                 public_key_type> &available_keys) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->get_required_signatures(trx, available_keys);
             });
         }
@@ -861,7 +896,7 @@ namespace golos {
         }
 
         std::set<public_key_type> database_api::get_potential_signatures(const signed_transaction &trx) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->get_potential_signatures(trx);
             });
         }
@@ -896,7 +931,7 @@ namespace golos {
         }
 
         bool database_api::verify_authority(const signed_transaction &trx) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->verify_authority(trx);
             });
         }
@@ -914,7 +949,7 @@ namespace golos {
 
         bool database_api::verify_account_authority(const std::string &name,
                                                     const flat_set<public_key_type> &signers) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 return my->verify_account_authority(name, signers);
             });
         }
@@ -941,7 +976,7 @@ namespace golos {
         }
 
         std::vector<convert_request_object> database_api::get_conversion_requests(const std::string &account) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 const auto &idx = my->_db.get_index<convert_request_index>().indices().get<by_owner>();
                 std::vector<convert_request_object> result;
                 auto itr = idx.lower_bound(account);
@@ -954,10 +989,14 @@ namespace golos {
         }
 
         discussion database_api::get_content(std::string author, std::string permlink) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 const auto &by_permlink_idx = my->_db.get_index<comment_index>().indices().get<by_permlink>();
                 auto itr = by_permlink_idx.find(boost::make_tuple(author, permlink));
                 if (itr != by_permlink_idx.end()) {
+                    subscription_hub::changed_object_keys keys;
+                    keys.comments.emplace(itr->author, permlink);
+                    my->subscribe_to_items(std::move(keys));
+
                     discussion result(*itr);
                     set_pending_payout(result);
                     result.active_votes = get_active_votes(author, permlink);
@@ -968,7 +1007,7 @@ namespace golos {
         }
 
         std::vector<vote_state> database_api::get_active_votes(std::string author, std::string permlink) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 std::vector<vote_state> result;
                 const auto &comment = my->_db.get_comment(author, permlink);
                 const auto &idx = my->_db.get_index<comment_vote_index>().indices().get<by_comment_voter>();
@@ -998,7 +1037,7 @@ namespace golos {
         }
 
         std::vector<account_vote> database_api::get_account_votes(std::string voter) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 std::vector<account_vote> result;
 
                 const auto &voter_acnt = my->_db.get_account(voter);
@@ -1110,7 +1149,7 @@ namespace golos {
         }
 
         std::vector<discussion> database_api::get_content_replies(std::string author, std::string permlink) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 account_name_type acc_name = account_name_type(author);
                 const auto &by_permlink_idx = my->_db.get_index<comment_index>().indices().get<by_parent>();
                 auto itr = by_permlink_idx.find(boost::make_tuple(acc_name, permlink));
@@ -1138,7 +1177,7 @@ namespace golos {
         std::vector<discussion> database_api::get_replies_by_last_update(account_name_type start_parent_author,
                                                                          std::string start_permlink,
                                                                          uint32_t limit) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 std::vector<discussion> result;
 
 #ifndef STEEMIT_BUILD_LOW_MEMORY
@@ -1171,7 +1210,7 @@ namespace golos {
 
         std::map<uint32_t, applied_operation> database_api::get_account_history(std::string account, uint64_t from,
                                                                                 uint32_t limit) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 FC_ASSERT(limit <= 10000, "Limit of ${l} is greater than maxmimum allowed", ("l", limit));
                 FC_ASSERT(from >= limit, "From must be greater than limit");
                 //   idump((account)(from)(limit));
@@ -1203,7 +1242,7 @@ namespace golos {
 
         std::vector<pair<std::string, uint32_t>> database_api::get_tags_used_by_author(
                 const std::string &author) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 const auto *acnt = my->_db.find_account(author);
                 FC_ASSERT(acnt != nullptr);
                 const auto &tidx = my->_db.get_index<tags::author_tag_stats_index>().indices().get<
@@ -1223,7 +1262,7 @@ namespace golos {
         }
 
         std::vector<tag_api_obj> database_api::get_trending_tags(std::string after, uint32_t limit) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 limit = std::min(limit, uint32_t(1000));
                 std::vector<tag_api_obj> result;
                 result.reserve(limit);
@@ -1284,9 +1323,35 @@ namespace golos {
             return d;
         }
 
+        /**
+         * Fields of a comment the discussion filters look at. The title and the body are left out, the
+         * discussions are built only for the final page.
+         */
+        comment_api_object filter_view(const comment_object &o) {
+            comment_api_object c;
+            c.id = o.id;
+            c.category = to_string(o.category);
+            c.parent_author = o.parent_author;
+            c.parent_permlink = to_string(o.parent_permlink);
+            c.author = o.author;
+            c.permlink = to_string(o.permlink);
+            c.json_metadata = to_string(o.json_metadata);
+            c.last_update = o.last_update;
+            c.created = o.created;
+            c.active = o.active;
+            c.depth = o.depth;
+            c.children = o.children;
+            c.children_rshares2 = o.children_rshares2;
+            c.net_rshares = o.net_rshares;
+            c.abs_rshares = o.abs_rshares;
+            c.cashout_time = o.cashout_time;
+            c.net_votes = o.net_votes;
+            return c;
+        }
+
         template<typename Object, typename DatabaseIndex, typename DiscussionIndex, typename CommentIndex,
                 typename Index, typename StartItr>
-        std::multimap<Object, discussion, DiscussionIndex> database_api::get_discussions(const discussion_query &query,
+        discussion_candidates<Object, DiscussionIndex> database_api::get_discussions(const discussion_query &query,
                                                                                          const std::string &tag,
                                                                                          comment_object::id_type parent,
                                                                                          const Index &tidx,
@@ -1315,7 +1380,7 @@ namespace golos {
                     ++itr;
                 }
             }
-            std::multimap<Object, discussion, DiscussionIndex> result;
+            discussion_candidates<Object, DiscussionIndex> result;
             uint32_t count = query.limit;
             uint64_t filter_count = 0;
             uint64_t exc_count = 0;
@@ -1325,15 +1390,15 @@ namespace golos {
                 }
 
                 try {
-                    discussion insert_discussion = get_discussion(tidx_itr->comment, query.truncate_body);
-                    insert_discussion.promoted = asset<0, 17, 0>(tidx_itr->promoted_balance, SBD_SYMBOL_NAME);
+                    // the discussions are built by materialize(), once the candidates are intersected
+                    const auto candidate = filter_view(my->_db.get(tidx_itr->comment));
 
-                    if (filter(insert_discussion)) {
+                    if (filter(candidate)) {
                         ++filter_count;
-                    } else if (exit(insert_discussion) || tag_exit(*tidx_itr)) {
+                    } else if (exit(candidate) || tag_exit(*tidx_itr)) {
                         break;
                     } else {
-                        result.insert({*tidx_itr, insert_discussion});
+                        result.emplace(*tidx_itr, tidx_itr->comment);
                         --count;
                     }
                 } catch (const fc::exception &e) {
@@ -1347,7 +1412,7 @@ namespace golos {
         }
 
         comment_object::id_type database_api::get_parent(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 comment_object::id_type parent;
                 if (query.parent_author && query.parent_permlink) {
                     parent = my->_db.get_comment(*query.parent_author, *query.parent_permlink).id;
@@ -1356,41 +1421,55 @@ namespace golos {
             });
         }
 
-        template<typename FirstCompare, typename SecondCompare>
-        std::vector<discussion> merge(std::multimap<tags::tag_object, discussion, FirstCompare> &result1,
-                                      std::multimap<languages::language_object, discussion, SecondCompare> &result2) {
-            //TODO:std::set_intersection(
+        template<typename TagIndex, typename LanguageIndex>
+        std::vector<discussion> database_api::materialize(
+                const discussion_candidates<tags::tag_object, TagIndex> &tag_candidates,
+                const discussion_candidates<languages::language_object, LanguageIndex> &language_candidates,
+                const discussion_query &query) const {
             std::vector<discussion> discussions;
-            if (!result2.empty()) {
-                std::multimap<comment_object::id_type, discussion> tmp;
 
-                for (auto &&i:result1) {
-                    tmp.emplace(i.second.id, std::move(i.second));
+            // a candidate which can't be built is skipped
+            auto add = [&](comment_object::id_type id, share_type promoted_balance) {
+                try {
+                    discussions.push_back(get_discussion(id, query.truncate_body));
+                    discussions.back().promoted = asset<0, 17, 0>(promoted_balance, SBD_SYMBOL_NAME);
+                } catch (const fc::exception &e) {
+                    edump((e.to_detail_string()));
+                }
+            };
+
+            if (!language_candidates.empty()) {
+                // the candidates are intersected by comment id, only the selected ones are built
+                std::vector<comment_object::id_type> selected;
+                selected.reserve(tag_candidates.size());
+                for (const auto &candidate : tag_candidates) {
+                    selected.push_back(candidate.second);
                 }
+                std::sort(selected.begin(), selected.end());
 
-                for (auto &&i:result2) {
-                    if (tmp.count(i.second.id)) {
-                        discussions.push_back(std::move(i.second));
+                for (const auto &candidate : language_candidates) {
+                    if (std::binary_search(selected.begin(), selected.end(), candidate.second)) {
+                        add(candidate.second, candidate.first.promoted_balance);
                     }
                 }
 
                 return discussions;
             }
 
-            discussions.reserve(result1.size());
-            for (auto &&iterator : result1) {
-                discussions.push_back(std::move(iterator.second));
+            discussions.reserve(tag_candidates.size());
+            for (const auto &candidate : tag_candidates) {
+                add(candidate.second, candidate.first.promoted_balance);
             }
 
             return discussions;
         }
 
         std::vector<discussion> database_api::get_discussions_by_trending(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
-                std::multimap<tags::tag_object, discussion, tags::by_parent_trending> map_result = select<
+                discussion_candidates<tags::tag_object, tags::by_parent_trending> map_result = select<
                         tags::tag_object, tags::tag_index, tags::by_parent_trending, tags::by_comment>(
                         query.select_tags, query, parent,
                         std::bind(tags::tags_plugin::filter, query, std::placeholders::_1,
@@ -1402,7 +1481,7 @@ namespace golos {
                             return false;
                         }, parent, std::numeric_limits<double>::max());
 
-                std::multimap<languages::language_object, discussion,
+                discussion_candidates<languages::language_object,
                         languages::by_parent_trending> map_result_ = select<languages::language_object,
                         languages::language_index, languages::by_parent_trending, languages::by_comment>(
                         query.select_languages, query, parent,
@@ -1416,7 +1495,7 @@ namespace golos {
                         }, parent, std::numeric_limits<double>::max());
 
 
-                std::vector<discussion> return_result = merge(map_result, map_result_);
+                std::vector<discussion> return_result = materialize(map_result, map_result_, query);
 
                 return return_result;
             });
@@ -1424,11 +1503,11 @@ namespace golos {
 
 
         vector<discussion> database_api::get_post_discussions_by_payout(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 query.validate();
                 auto parent = comment_object::id_type();
 
-                std::multimap<tags::tag_object, discussion, tags::by_parent_promoted> map_result = select<
+                discussion_candidates<tags::tag_object, tags::by_parent_promoted> map_result = select<
                         tags::tag_object, tags::tag_index, tags::by_parent_promoted, tags::by_comment>(
                         query.select_tags, query, parent,
                         std::bind(tags::tags_plugin::filter, query, std::placeholders::_1,
@@ -1440,7 +1519,7 @@ namespace golos {
                             return false;
                         }, true);
 
-                std::multimap<languages::language_object, discussion,
+                discussion_candidates<languages::language_object,
                         languages::by_parent_promoted> map_result_language = select<languages::language_object,
                         languages::language_index, languages::by_parent_promoted, languages::by_comment>(
                         query.select_tags, query, parent,
@@ -1453,19 +1532,19 @@ namespace golos {
                             return false;
                         }, true);
 
-                std::vector<discussion> return_result = merge(map_result, map_result_language);
+                std::vector<discussion> return_result = materialize(map_result, map_result_language, query);
 
                 return return_result;
             });
         }
 
         vector<discussion> database_api::get_comment_discussions_by_payout(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 query.validate();
 
                 auto parent = comment_object::id_type(1);
 
-                std::multimap<tags::tag_object, discussion, tags::by_reward_fund_net_rshares> map_result = select<
+                discussion_candidates<tags::tag_object, tags::by_reward_fund_net_rshares> map_result = select<
                         tags::tag_object, tags::tag_index, tags::by_reward_fund_net_rshares, tags::by_comment>(
                         query.select_tags, query, parent,
                         std::bind(tags::tags_plugin::filter, query, std::placeholders::_1,
@@ -1477,7 +1556,7 @@ namespace golos {
                             return false;
                         }, false);
 
-                std::multimap<languages::language_object, discussion,
+                discussion_candidates<languages::language_object,
                         languages::by_reward_fund_net_rshares> map_result_language = select<languages::language_object,
                         languages::language_index, languages::by_reward_fund_net_rshares, languages::by_comment>(
                         query.select_tags, query, parent,
@@ -1490,18 +1569,18 @@ namespace golos {
                             return false;
                         }, false);
 
-                std::vector<discussion> return_result = merge(map_result, map_result_language);
+                std::vector<discussion> return_result = materialize(map_result, map_result_language, query);
 
                 return return_result;
             });
         }
 
         std::vector<discussion> database_api::get_discussions_by_promoted(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
-                std::multimap<tags::tag_object, discussion, tags::by_parent_promoted> map_result = select<
+                discussion_candidates<tags::tag_object, tags::by_parent_promoted> map_result = select<
                         tags::tag_object, tags::tag_index, tags::by_parent_promoted, tags::by_comment>(
                         query.select_tags, query, parent,
                         std::bind(tags::tags_plugin::filter, query, std::placeholders::_1,
@@ -1514,7 +1593,7 @@ namespace golos {
                         }, parent, share_type(STEEMIT_MAX_SHARE_SUPPLY));
 
 
-                std::multimap<languages::language_object, discussion,
+                discussion_candidates<languages::language_object,
                         languages::by_parent_promoted> map_result_language = select<languages::language_object,
                         languages::language_index, languages::by_parent_promoted, languages::by_comment>(
                         query.select_tags, query, parent,
@@ -1528,18 +1607,18 @@ namespace golos {
                         }, parent, share_type(STEEMIT_MAX_SHARE_SUPPLY));
 
 
-                std::vector<discussion> return_result = merge(map_result, map_result_language);
+                std::vector<discussion> return_result = materialize(map_result, map_result_language, query);
 
                 return return_result;
             });
         }
 
         std::vector<discussion> database_api::get_discussions_by_created(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
-                std::multimap<tags::tag_object, discussion, tags::by_parent_created> map_result = select<
+                discussion_candidates<tags::tag_object, tags::by_parent_created> map_result = select<
                         tags::tag_object, tags::tag_index, tags::by_parent_created, tags::by_comment>(query.select_tags,
                                                                                                       query, parent,
                                                                                                       std::bind(
@@ -1557,7 +1636,7 @@ namespace golos {
                                                                                                       }, parent,
                                                                                                       fc::time_point_sec::maximum());
 
-                std::multimap<languages::language_object, discussion,
+                discussion_candidates<languages::language_object,
                         languages::by_parent_created> map_result_language = select<languages::language_object,
                         languages::language_index, languages::by_parent_created, languages::by_comment>(
                         query.select_tags, query, parent,
@@ -1570,19 +1649,19 @@ namespace golos {
                             return false;
                         }, parent, fc::time_point_sec::maximum());
 
-                std::vector<discussion> return_result = merge(map_result, map_result_language);
+                std::vector<discussion> return_result = materialize(map_result, map_result_language, query);
 
                 return return_result;
             });
         }
 
         std::vector<discussion> database_api::get_discussions_by_active(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
 
-                std::multimap<tags::tag_object, discussion, tags::by_parent_active> map_result = select<
+                discussion_candidates<tags::tag_object, tags::by_parent_active> map_result = select<
                         tags::tag_object, tags::tag_index, tags::by_parent_active, tags::by_comment>(query.select_tags,
                                                                                                      query, parent,
                                                                                                      std::bind(
@@ -1600,7 +1679,7 @@ namespace golos {
                                                                                                      }, parent,
                                                                                                      fc::time_point_sec::maximum());
 
-                std::multimap<languages::language_object, discussion,
+                discussion_candidates<languages::language_object,
                         languages::by_parent_active> map_result_language = select<languages::language_object,
                         languages::language_index, languages::by_parent_active, languages::by_comment>(
                         query.select_tags, query, parent,
@@ -1613,19 +1692,19 @@ namespace golos {
                             return false;
                         }, parent, fc::time_point_sec::maximum());
 
-                std::vector<discussion> return_result = merge(map_result, map_result_language);
+                std::vector<discussion> return_result = materialize(map_result, map_result_language, query);
 
                 return return_result;
             });
         }
 
         std::vector<discussion> database_api::get_discussions_by_cashout(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
 
-                std::multimap<tags::tag_object, discussion, tags::by_cashout> map_result = select<tags::tag_object,
+                discussion_candidates<tags::tag_object, tags::by_cashout> map_result = select<tags::tag_object,
                         tags::tag_index, tags::by_cashout, tags::by_comment>(query.select_tags, query, parent,
                                                                              std::bind(tags::tags_plugin::filter, query,
                                                                                        std::placeholders::_1,
@@ -1639,7 +1718,7 @@ namespace golos {
                             return false;
                         }, fc::time_point::now() - fc::minutes(60));
 
-                std::multimap<languages::language_object, discussion,
+                discussion_candidates<languages::language_object,
                         languages::by_cashout> map_result_language = select<languages::language_object,
                         languages::language_index, languages::by_cashout, languages::by_comment>(query.select_tags,
                                                                                                  query, parent,
@@ -1661,17 +1740,17 @@ namespace golos {
                                                                                                  fc::minutes(60));
 
 
-                std::vector<discussion> return_result = merge(map_result, map_result_language);
+                std::vector<discussion> return_result = materialize(map_result, map_result_language, query);
                 return return_result;
             });
         }
 
         std::vector<discussion> database_api::get_discussions_by_payout(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
-                std::multimap<tags::tag_object, discussion, tags::by_net_rshares> map_result = select<tags::tag_object,
+                discussion_candidates<tags::tag_object, tags::by_net_rshares> map_result = select<tags::tag_object,
                         tags::tag_index, tags::by_net_rshares, tags::by_comment>(query.select_tags, query, parent,
                                                                                  std::bind(tags::tags_plugin::filter,
                                                                                            query, std::placeholders::_1,
@@ -1686,7 +1765,7 @@ namespace golos {
                                                                                      return false;
                                                                                  });
 
-                std::multimap<languages::language_object, discussion,
+                discussion_candidates<languages::language_object,
                         languages::by_net_rshares> map_result_language = select<languages::language_object,
                         languages::language_index, languages::by_net_rshares, languages::by_comment>(query.select_tags,
                                                                                                      query, parent,
@@ -1705,18 +1784,18 @@ namespace golos {
                                                                                                          return false;
                                                                                                      });
 
-                std::vector<discussion> return_result = merge(map_result, map_result_language);
+                std::vector<discussion> return_result = materialize(map_result, map_result_language, query);
 
                 return return_result;
             });
         }
 
         std::vector<discussion> database_api::get_discussions_by_votes(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
-                std::multimap<tags::tag_object, discussion, tags::by_parent_net_votes> map_result = select<
+                discussion_candidates<tags::tag_object, tags::by_parent_net_votes> map_result = select<
                         tags::tag_object, tags::tag_index, tags::by_parent_net_votes, tags::by_comment>(
                         query.select_tags, query, parent,
                         std::bind(tags::tags_plugin::filter, query, std::placeholders::_1,
@@ -1728,7 +1807,7 @@ namespace golos {
                             return false;
                         }, parent, std::numeric_limits<int32_t>::max());
 
-                std::multimap<languages::language_object, discussion,
+                discussion_candidates<languages::language_object,
                         languages::by_parent_net_votes> map_result_language = select<languages::language_object,
                         languages::language_index, languages::by_parent_net_votes, languages::by_comment>(
                         query.select_tags, query, parent,
@@ -1741,18 +1820,18 @@ namespace golos {
                             return false;
                         }, parent, std::numeric_limits<int32_t>::max());
 
-                std::vector<discussion> return_result = merge(map_result, map_result_language);
+                std::vector<discussion> return_result = materialize(map_result, map_result_language, query);
 
                 return return_result;
             });
         }
 
         std::vector<discussion> database_api::get_discussions_by_children(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
-                std::multimap<tags::tag_object, discussion, tags::by_parent_children> map_result =
+                discussion_candidates<tags::tag_object, tags::by_parent_children> map_result =
 
                         select<tags::tag_object, tags::tag_index, tags::by_parent_children, tags::by_comment>(
                                 query.select_tags, query, parent,
@@ -1765,7 +1844,7 @@ namespace golos {
                                     return false;
                                 }, parent, std::numeric_limits<int32_t>::max());
 
-                std::multimap<languages::language_object, discussion,
+                discussion_candidates<languages::language_object,
                         languages::by_parent_children> map_result_language = select<languages::language_object,
                         languages::language_index, languages::by_parent_children, languages::by_comment>(
                         query.select_tags, query, parent,
@@ -1778,7 +1857,7 @@ namespace golos {
                             return false;
                         }, parent, std::numeric_limits<int32_t>::max());
 
-                std::vector<discussion> return_result = merge(map_result, map_result_language);
+                std::vector<discussion> return_result = materialize(map_result, map_result_language, query);
 
                 return return_result;
             });
@@ -1786,11 +1865,11 @@ namespace golos {
 
         std::vector<discussion> database_api::get_discussions_by_hot(const discussion_query &query) const {
 
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 query.validate();
                 auto parent = get_parent(query);
 
-                std::multimap<tags::tag_object, discussion, tags::by_parent_hot> map_result = select<tags::tag_object,
+                discussion_candidates<tags::tag_object, tags::by_parent_hot> map_result = select<tags::tag_object,
                         tags::tag_index, tags::by_parent_hot, tags::by_comment>(query.select_tags, query, parent,
                                                                                 std::bind(tags::tags_plugin::filter,
                                                                                           query, std::placeholders::_1,
@@ -1805,7 +1884,7 @@ namespace golos {
                                                                                 }, parent,
                                                                                 std::numeric_limits<double>::max());
 
-                std::multimap<languages::language_object, discussion,
+                discussion_candidates<languages::language_object,
                         languages::by_parent_hot> map_result_language = select<languages::language_object,
                         languages::language_index, languages::by_parent_hot, languages::by_comment>(query.select_tags,
                                                                                                     query, parent,
@@ -1826,7 +1905,7 @@ namespace golos {
                                                                                                     std::numeric_limits<
                                                                                                             double>::max());
 
-                std::vector<discussion> return_result = merge(map_result, map_result_language);
+                std::vector<discussion> return_result = materialize(map_result, map_result_language, query);
 
                 return return_result;
             });
@@ -1919,7 +1998,7 @@ namespace golos {
         }
 
         std::vector<discussion> database_api::get_discussions_by_feed(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 query.validate();
                 FC_ASSERT(my->_follow_api, "Node is not running the follow plugin");
                 FC_ASSERT(query.select_authors.size(), "No such author to select feed from");
@@ -1998,7 +2077,7 @@ namespace golos {
         }
 
         std::vector<discussion> database_api::get_discussions_by_blog(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 query.validate();
                 FC_ASSERT(my->_follow_api, "Node is not running the follow plugin");
                 FC_ASSERT(query.select_authors.size(), "No such author to select feed from");
@@ -2019,7 +2098,7 @@ namespace golos {
         }
 
         std::vector<discussion> database_api::get_discussions_by_comments(const discussion_query &query) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 std::vector<discussion> result;
 #ifndef STEEMIT_BUILD_LOW_MEMORY
                 query.validate();
@@ -2065,7 +2144,7 @@ namespace golos {
         }
 
         std::vector<category_api_obj> database_api::get_trending_categories(std::string after, uint32_t limit) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 limit = std::min(limit, uint32_t(100));
                 std::vector<category_api_obj> result;
                 result.reserve(limit);
@@ -2092,7 +2171,7 @@ namespace golos {
         }
 
         std::vector<category_api_obj> database_api::get_best_categories(std::string after, uint32_t limit) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 limit = std::min(limit, uint32_t(100));
                 std::vector<category_api_obj> result;
                 result.reserve(limit);
@@ -2101,7 +2180,7 @@ namespace golos {
         }
 
         std::vector<category_api_obj> database_api::get_active_categories(std::string after, uint32_t limit) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 limit = std::min(limit, uint32_t(100));
                 std::vector<category_api_obj> result;
                 result.reserve(limit);
@@ -2110,7 +2189,7 @@ namespace golos {
         }
 
         std::vector<category_api_obj> database_api::get_recent_categories(std::string after, uint32_t limit) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 limit = std::min(limit, uint32_t(100));
                 std::vector<category_api_obj> result;
                 result.reserve(limit);
@@ -2128,7 +2207,7 @@ namespace golos {
          */
         void database_api::recursively_fetch_content(state &_state, discussion &root,
                                                      std::set<std::string> &referenced_accounts) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 try {
                     if (root.author.size()) {
                         referenced_accounts.insert(root.author);
@@ -2152,7 +2231,7 @@ namespace golos {
         }
 
         std::vector<account_name_type> database_api::get_miner_queue() const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 std::vector<account_name_type> result;
                 const auto &pow_idx = my->_db.get_index<witness_index>().indices().get<by_pow>();
 
@@ -2168,7 +2247,7 @@ namespace golos {
         }
 
         std::vector<account_name_type> database_api::get_active_witnesses() const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 const auto &wso = my->_db.get_witness_schedule_object();
                 size_t n = wso.current_shuffled_witnesses.size();
                 vector<account_name_type> result;
@@ -2184,7 +2263,7 @@ namespace golos {
                                                                                     std::string start_permlink,
                                                                                     time_point_sec before_date,
                                                                                     uint32_t limit) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 try {
                     std::vector<discussion> result;
 #ifndef STEEMIT_BUILD_LOW_MEMORY
@@ -2223,13 +2302,18 @@ namespace golos {
         }
 
         std::vector<savings_withdraw_api_obj> database_api::get_savings_withdraw_from(std::string account) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 std::vector<savings_withdraw_api_obj> result;
 
+                const auto *from = my->_db.find_account(account);
+                if (from == nullptr) {
+                    return result;
+                }
+
                 const auto &from_rid_idx = my->_db.get_index<savings_withdraw_index>().indices().get<by_from_rid>();
-                auto itr = from_rid_idx.lower_bound(account);
-                while (itr != from_rid_idx.end() && itr->from == account) {
-                    result.push_back(savings_withdraw_api_obj(*itr));
+                auto itr = from_rid_idx.lower_bound(from->id);
+                while (itr != from_rid_idx.end() && itr->from == from->id) {
+                    result.push_back(savings_withdraw_api_obj(*itr, my->_db));
                     ++itr;
                 }
                 return result;
@@ -2237,14 +2321,19 @@ namespace golos {
         }
 
         std::vector<savings_withdraw_api_obj> database_api::get_savings_withdraw_to(std::string account) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 std::vector<savings_withdraw_api_obj> result;
 
+                const auto *to = my->_db.find_account(account);
+                if (to == nullptr) {
+                    return result;
+                }
+
                 const auto &to_complete_idx = my->_db.get_index<savings_withdraw_index>().indices().get<
                         by_to_complete>();
-                auto itr = to_complete_idx.lower_bound(account);
-                while (itr != to_complete_idx.end() && itr->to == account) {
-                    result.push_back(savings_withdraw_api_obj(*itr));
+                auto itr = to_complete_idx.lower_bound(to->id);
+                while (itr != to_complete_idx.end() && itr->to == to->id) {
+                    result.push_back(savings_withdraw_api_obj(*itr, my->_db));
                     ++itr;
                 }
                 return result;
@@ -2255,7 +2344,7 @@ namespace golos {
                                                                                 uint32_t limit) const {
             FC_ASSERT(limit <= 1000);
 
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 vector<vesting_delegation_object> result;
                 result.reserve(limit);
 
@@ -2275,7 +2364,7 @@ namespace golos {
                                                                                                     uint32_t limit) const {
             FC_ASSERT(limit <= 1000);
 
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 vector<vesting_delegation_expiration_object> result;
                 result.reserve(limit);
 
@@ -2291,6 +2380,7 @@ namespace golos {
         }
 
         annotated_signed_transaction database_api::get_transaction(transaction_id_type id) const {
+            // reads the block log, see get_block_header()
             return my->_db.with_read_lock([&]() {
                 const auto &idx = my->_db.get_index<operation_index>().indices().get<by_transaction_id>();
                 auto itr = idx.lower_bound(id);
@@ -2311,7 +2401,7 @@ namespace golos {
 
         template<typename Object, typename DatabaseIndex, typename DiscussionIndex, typename CommentIndex,
                 typename ...Args>
-        std::multimap<Object, discussion, DiscussionIndex> database_api::select(const std::set<std::string> &select_set,
+        discussion_candidates<Object, DiscussionIndex> database_api::select(const std::set<std::string> &select_set,
                                                                                 const discussion_query &query,
                                                                                 comment_object::id_type parent,
                                                                                 const std::function<
@@ -2321,7 +2411,7 @@ namespace golos {
                                                                                 const std::function<
                                                                                         bool(const Object &)> &exit2,
                                                                                 Args... args) const {
-            std::multimap<Object, discussion, DiscussionIndex> map_result;
+            discussion_candidates<Object, DiscussionIndex> map_result;
             std::string helper;
 
             const auto &index = my->_db.get_index<DatabaseIndex>().indices().template get<DiscussionIndex>();
@@ -2338,7 +2428,7 @@ namespace golos {
                                                                                                         filter, exit,
                                                                                                         exit2);
 
-                    map_result.insert(result.cbegin(), result.cend());
+                    map_result.insert(result.begin(), result.end());
                 }
             } else {
                 auto tidx_itr = index.lower_bound(boost::make_tuple(helper, args...));
@@ -2353,7 +2443,7 @@ namespace golos {
         }
 
         reward_fund_object database_api::get_reward_fund(string name) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 const reward_fund_object *fund = my->_db.find<reward_fund_object, by_name>(name);
                 FC_ASSERT(fund != nullptr, "Invalid reward fund name");
 
@@ -2393,7 +2483,7 @@ namespace golos {
         }
 
         state database_api::get_state(std::string path) const {
-            return my->_db.with_read_lock([&]() {
+            return my->_api_thread_pool->with_read_lock([&]() {
                 state _state;
                 _state.props = get_dynamic_global_properties();
                 _state.current_route = path;
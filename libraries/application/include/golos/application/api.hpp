@@ -85,25 +85,10 @@ namespace golos {
             // implementation detail, not reflected
             bool check_max_block_age(int32_t max_block_age);
 
-            /**
-             * @brief Not reflected, thus not accessible to API clients.
-             *
-             * This function is registered to receive the applied_block
-             * signal from the chain database when a block is received.
-             * It then dispatches callbacks to clients who have requested
-             * to be notified when a particular txid is included in a block.
-             */
-            void on_applied_block(const signed_block &b);
-
             /// internal method, not exposed via JSON RPC
             void on_api_startup();
 
         private:
-            boost::signals2::scoped_connection _applied_block_connection;
-
-            map<transaction_id_type, confirmation_callback> _callbacks;
-            map<time_point_sec, vector<transaction_id_type>> _callbacks_expirations;
-
             int32_t _max_block_age = -1;
 
             application &_app;
@@ -216,6 +201,16 @@ namespace golos {
 
             steem_version_info get_version();
 
+            /**
+             * @brief Switch the connection to binary results for block and history export
+             * @param enabled True to get fc::raw packed results, false to return to JSON
+             * @return Methods answered in binary form, as "api.method"
+             *
+             * The result of such a call is the base64 of the fc::raw packed return value, the rest of the
+             * reply and all other methods stay JSON. Only available over websocket and HTTP RPC.
+             */
+            vector<string> set_binary_results(bool enabled);
+
             /// internal method, not exposed via JSON RPC
             void on_api_startup();
 
@@ -255,4 +250,5 @@ FC_API(golos::application::login_api,
         (login)
                 (get_api_by_name)
                 (get_version)
+                (set_binary_results)
 )
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <golos/chain/database.hpp>
+
+#include <fc/reflect/reflect.hpp>
+#include <fc/time.hpp>
+
+#include <boost/signals2.hpp>
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace golos {
+    namespace application {
+
+        /**
+         * @brief Calls of one RPC method since the node started
+         */
+        struct api_method_stats_entry {
+            std::string api;
+            std::string method;
+            uint64_t calls = 0;
+            /// Calls answered with an error
+            uint64_t errors = 0;
+            /// Time from receiving the request to having the reply, microseconds
+            uint64_t total_time = 0;
+            uint64_t max_time = 0;
+            /// Number of calls per latency bucket, see api_method_stats_result::latency_buckets
+            std::vector<uint64_t> latency_histogram;
+            /// Size of the replies, bytes
+            uint64_t response_bytes = 0;
+            uint64_t max_response_bytes = 0;
+            /// Time spent waiting for the database read lock, microseconds
+            uint64_t lock_wait_time = 0;
+        };
+
+        struct api_method_stats_result {
+            /// Upper bounds of the latency buckets in microseconds, the last bucket has no bound
+            std::vector<uint64_t> latency_buckets;
+            std::vector<api_method_stats_entry> methods;
+        };
+
+        /**
+         * @brief Node-wide call counts, latencies and reply sizes of the RPC methods
+         *
+         * The RPC connections record every call they dispatch. The api is the first parameter of a
+         * "call" request. Names come from clients, so only methods of the APIs added with add_api() get
+         * their own entry: a call naming an API by its numeric id, which is only valid on one connection,
+         * is recorded under an empty api, and calls of unknown methods share the entry of unknown_method.
+         */
+        class api_method_stats {
+        public:
+            static constexpr std::array<uint64_t, 5> latency_buckets = {{100, 1000, 10000, 100000, 1000000}};
+
+            /// Method name of the entry counting calls of unknown APIs and methods
+            static const std::string unknown_method;
+
+            api_method_stats(chain::database &db);
+
+            /// Registers the methods of an API, called for every API factory of the application
+            void add_api(const std::string &api, const std::vector<std::string> &methods);
+
+            void record(const std::string &api, const std::string &method, fc::microseconds time, bool error,
+                        std::size_t response_bytes, uint64_t lock_wait_time);
+
+            api_method_stats_result get_stats() const;
+
+            /// Logs the busiest methods every @p interval blocks, 0 disables logging
+            void set_log_interval(uint32_t interval);
+
+        private:
+            void log() const;
+
+            /// The entry a call is recorded in, the caller holds _mutex
+            api_method_stats_entry &entry_for(const std::string &api, const std::string &method);
+
+            chain::database &_db;
+            boost::signals2::scoped_connection _applied_block_connection;
+
+            mutable std::mutex _mutex;
+            std::map<std::pair<std::string, std::string>, api_method_stats_entry> _methods;
+            std::map<std::string, std::set<std::string>> _apis;
+            std::set<std::string> _api_methods;
+        };
+
+    }
+} // golos::application
+
+FC_REFLECT((golos::application::api_method_stats_entry),
+           (api)(method)(calls)(errors)(total_time)(max_time)(latency_histogram)(response_bytes)(
+                   max_response_bytes)(lock_wait_time))
+FC_REFLECT((golos::application::api_method_stats_result), (latency_buckets)(methods))
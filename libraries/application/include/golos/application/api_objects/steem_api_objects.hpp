@@ -287,15 +287,36 @@ namespace golos {
             time_point_sec expires;
         };
 
+        /**
+         * Balance in the form it had before the balance indexes were keyed by asset ids,
+         * asset_id is an internal key and is left out
+         */
+        struct account_balance_api_obj {
+            account_balance_api_obj(const chain::account_balance_object &b) :
+                    id(b.id),
+                    owner(b.owner),
+                    asset_name(b.asset_name),
+                    balance(b.balance) {
+            }
+
+            account_balance_api_obj() {
+            }
+
+            account_balance_object::id_type id;
+            account_name_type owner;
+            protocol::asset_name_type asset_name;
+            share_type balance = 0;
+        };
+
         struct account_history_api_obj {
 
         };
 
         struct savings_withdraw_api_obj {
-            savings_withdraw_api_obj(const chain::savings_withdraw_object &o) :
+            savings_withdraw_api_obj(const chain::savings_withdraw_object &o, const chain::database &db) :
                     id(o.id),
-                    from(o.from),
-                    to(o.to),
+                    from(db.get(o.from).name),
+                    to(db.get(o.to).name),
                     memo(to_string(o.memo)),
                     request_id(o.request_id),
                     amount(o.amount),
@@ -314,6 +335,41 @@ namespace golos {
             time_point_sec complete;
         };
 
+        struct escrow_api_obj {
+            escrow_api_obj(const chain::escrow_object &e, const chain::database &db) :
+                    id(e.id),
+                    escrow_id(e.escrow_id),
+                    from(db.get(e.from).name),
+                    to(db.get(e.to).name),
+                    agent(db.get(e.agent).name),
+                    ratification_deadline(e.ratification_deadline),
+                    escrow_expiration(e.escrow_expiration),
+                    sbd_balance(e.sbd_balance),
+                    steem_balance(e.steem_balance),
+                    pending_fee(e.pending_fee),
+                    to_approved(e.to_approved),
+                    agent_approved(e.agent_approved),
+                    disputed(e.disputed) {
+            }
+
+            escrow_api_obj() {
+            }
+
+            escrow_object::id_type id;
+            uint32_t escrow_id = 20;
+            account_name_type from;
+            account_name_type to;
+            account_name_type agent;
+            time_point_sec ratification_deadline;
+            time_point_sec escrow_expiration;
+            asset<0, 17, 0> sbd_balance;
+            asset<0, 17, 0> steem_balance;
+            asset<0, 17, 0> pending_fee;
+            bool to_approved = false;
+            bool agent_approved = false;
+            bool disputed = false;
+        };
+
         struct feed_history_api_obj {
             feed_history_api_obj(const chain::feed_history_object &f) :
                     id(f.id),
@@ -418,6 +474,13 @@ FC_REFLECT((golos::application::account_recovery_request_api_obj),
                 (expires)
 )
 
+FC_REFLECT((golos::application::account_balance_api_obj),
+        (id)
+                (owner)
+                (asset_name)
+                (balance)
+)
+
 FC_REFLECT((golos::application::savings_withdraw_api_obj),
         (id)
                 (from)
@@ -428,6 +491,22 @@ FC_REFLECT((golos::application::savings_withdraw_api_obj),
                 (complete)
 )
 
+FC_REFLECT((golos::application::escrow_api_obj),
+        (id)
+                (escrow_id)
+                (from)
+                (to)
+                (agent)
+                (ratification_deadline)
+                (escrow_expiration)
+                (sbd_balance)
+                (steem_balance)
+                (pending_fee)
+                (to_approved)
+                (agent_approved)
+                (disputed)
+)
+
 FC_REFLECT((golos::application::feed_history_api_obj),
         (id)
                 (current_median_history)
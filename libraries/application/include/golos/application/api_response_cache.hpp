@@ -0,0 +1,63 @@
+#pragma once
+
+#include <golos/chain/database.hpp>
+
+#include <fc/reflect/reflect.hpp>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace golos {
+    namespace application {
+
+        /**
+         * @brief Hit ratio of the API response cache
+         */
+        struct api_response_cache_stats {
+            uint32_t max_size = 0;
+            uint32_t size = 0;
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+        };
+
+        /**
+         * @brief Node-wide cache of the encoded results of hot read API calls
+         *
+         * Holds the JSON text of results, keyed by the method name and the JSON of the parameters.
+         * Entries stay valid until the head block changes, so all sessions asking for the same page
+         * within a block interval share one evaluation and one serialization. Changes of pending
+         * transactions show up with the next block. batch_api_connection consults the cache for the
+         * methods added with add_json_method() as cached, a hit is copied into the reply as is.
+         *
+         * fetch() takes the database read lock itself, it must not be called under the lock.
+         */
+        class api_response_cache {
+        public:
+            api_response_cache(chain::database &db);
+
+            /// Maximum number of cached results, 0 disables the cache
+            void set_max_size(uint32_t max_size);
+
+            /// @return The cached result for @p key, or the result of @p compute, which is cached
+            std::string fetch(const std::string &key, const std::function<std::string()> &compute);
+
+            api_response_cache_stats get_stats() const;
+
+        private:
+            chain::database &_db;
+            std::atomic<uint32_t> _max_size{0};
+
+            mutable std::mutex _mutex;
+            protocol::block_id_type _block_id;
+            std::map<std::string, std::string> _entries;
+            uint64_t _hits = 0;
+            uint64_t _misses = 0;
+        };
+
+    }
+} // golos::application
+
+FC_REFLECT((golos::application::api_response_cache_stats), (max_size)(size)(hits)(misses))
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <golos/chain/database.hpp>
+
+#include <fc/reflect/reflect.hpp>
+#include <fc/thread/thread.hpp>
+#include <fc/time.hpp>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace golos {
+    namespace application {
+
+        /**
+         * @brief Load of the API thread pool
+         */
+        struct api_thread_pool_stats {
+            uint32_t threads = 0;
+            /// Calls queued or running on the pool right now
+            uint32_t queue_depth = 0;
+            uint32_t max_queue_depth = 0;
+            uint64_t calls = 0;
+            /// Time the calls waited for a pool thread, microseconds
+            uint64_t total_wait_time = 0;
+            uint64_t max_wait_time = 0;
+            /// Time the calls ran under the read lock, microseconds
+            uint64_t total_run_time = 0;
+        };
+
+        /**
+         * @brief Sums the time the calls of an RPC request wait for the database read lock
+         *
+         * The scope is current on its thread from construction on. Tasks of the thread interleave while
+         * a call waits for the pool, so with_read_lock() makes the scope of a task current again when
+         * the task resumes.
+         */
+        class lock_wait_scope {
+        public:
+            lock_wait_scope();
+
+            ~lock_wait_scope();
+
+            /// Microseconds
+            uint64_t wait_time() const {
+                return _wait_time;
+            }
+
+            static lock_wait_scope *current();
+
+            static void set_current(lock_wait_scope *scope);
+
+            void add(const fc::time_point &since) {
+                _wait_time += (fc::time_point::now() - since).count();
+            }
+
+        private:
+            uint64_t _wait_time = 0;
+        };
+
+        /**
+         * @brief Runs read-only API calls concurrently under the database read lock
+         *
+         * RPC calls are dispatched on the cooperative scheduler of the thread which applies blocks, so
+         * a long read call blocks all other clients. Read calls wrapped by with_read_lock() are executed
+         * on a pool thread while the calling task waits for the result and yields to other clients.
+         * Calls which write, broadcast or read the block log stay on the calling thread.
+         *
+         * Without threads, and for nested calls made on a pool thread, the callback runs in place.
+         */
+        class api_thread_pool {
+        public:
+            api_thread_pool(chain::database &db);
+
+            ~api_thread_pool();
+
+            /// Starts the threads, must be called before the RPC servers accept connections
+            void start(uint32_t threads);
+
+            template<typename Lambda>
+            auto with_read_lock(Lambda &&callback) -> decltype(callback()) {
+                auto *wait_scope = lock_wait_scope::current();
+                const auto entered = fc::time_point::now();
+                auto locked_callback = [&]() {
+                    if (wait_scope) {
+                        wait_scope->add(entered);
+                    }
+                    return callback();
+                };
+
+                if (_threads.empty() || on_pool_thread()) {
+                    return _db.with_read_lock(locked_callback);
+                }
+
+                call_scope scope(*this, wait_scope);
+                auto &thread = *_threads[_next_thread++ % _threads.size()];
+                return thread.async([&]() {
+                    scope.started();
+                    return _db.with_read_lock(locked_callback);
+                }, "api_call").wait();
+            }
+
+            api_thread_pool_stats get_stats() const;
+
+        private:
+            /// Accounts one call from queuing to completion
+            class call_scope {
+            public:
+                /// Makes @p wait_scope current again when the calling task resumes
+                call_scope(api_thread_pool &pool, lock_wait_scope *wait_scope);
+
+                ~call_scope();
+
+                void started();
+
+            private:
+                api_thread_pool &_pool;
+                lock_wait_scope *const _wait_scope;
+                const fc::time_point _queued;
+                fc::time_point _started;
+            };
+
+            static bool on_pool_thread();
+
+            chain::database &_db;
+            std::vector<std::unique_ptr<fc::thread>> _threads;
+            std::atomic<uint32_t> _next_thread{0};
+
+            std::atomic<uint32_t> _queue_depth{0};
+            std::atomic<uint32_t> _max_queue_depth{0};
+            std::atomic<uint64_t> _calls{0};
+            std::atomic<uint64_t> _total_wait_time{0};
+            std::atomic<uint64_t> _max_wait_time{0};
+            std::atomic<uint64_t> _total_run_time{0};
+        };
+
+    }
+} // golos::application
+
+FC_REFLECT((golos::application::api_thread_pool_stats),
+           (threads)(queue_depth)(max_queue_depth)(calls)(total_wait_time)(max_wait_time)(total_run_time))
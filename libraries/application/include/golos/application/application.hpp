@@ -16,6 +16,16 @@ namespace golos {
     namespace application {
         namespace detail {
             class application_impl;
+
+            /// Collects the method names of an FC_API interface
+            struct api_method_name_visitor {
+                std::vector<std::string> &names;
+
+                template<typename Member>
+                void operator()(const char *name, const Member &) const {
+                    names.emplace_back(name);
+                }
+            };
         }
         using std::string;
 
@@ -29,6 +39,14 @@ namespace golos {
 
         class login_api;
 
+        class subscription_hub;
+
+        class api_thread_pool;
+
+        class api_response_cache;
+
+        class api_method_stats;
+
         class application {
         public:
             application();
@@ -72,6 +90,18 @@ namespace golos {
             network::node_ptr p2p_node();
 
             std::shared_ptr<chain::database> chain_database() const;
+
+            /// Shared applied_block fan-out used by the API sessions
+            std::shared_ptr<subscription_hub> get_subscription_hub() const;
+
+            /// Executes read-only API calls, see api_thread_pool
+            std::shared_ptr<api_thread_pool> get_api_thread_pool() const;
+
+            /// Shares results of hot read API calls between sessions, see api_response_cache
+            std::shared_ptr<api_response_cache> get_api_response_cache() const;
+
+            /// Call counts and latencies of the RPC methods, see api_method_stats
+            std::shared_ptr<api_method_stats> get_api_method_stats() const;
             //std::shared_ptr<golos::get_database::object_database> pending_trx_database() const;
 
             void set_block_production(bool producing_blocks);
@@ -85,6 +115,9 @@ namespace golos {
              */
             void register_api_factory(const string &name, std::function<fc::api_ptr(const api_context &)> factory);
 
+            /// Makes the methods of the named API known to api_method_stats
+            void register_api_methods(const string &name, const std::vector<std::string> &methods);
+
             /**
              * Convenience method to build an API factory from a type which only requires a reference to the application.
              */
@@ -92,6 +125,10 @@ namespace golos {
 #ifndef STEEMIT_BUILD_TESTNET
                 idump((name));
 #endif
+                std::vector<std::string> methods;
+                fc::vtable<Api, fc::identity_member>().visit(detail::api_method_name_visitor{methods});
+                register_api_methods(name, methods);
+
                 register_api_factory(name, [](const api_context &ctx) -> fc::api_ptr {
                     // apparently the compiler is smart enough to downcast shared_ptr< api<Api> > to shared_ptr< api_base > automatically
                     // see http://en.cppreference.com/w/cpp/memory/shared_ptr/pointer_cast for example
@@ -112,6 +149,9 @@ namespace golos {
 
             bool _read_only = true;
 
+            /// Set by startup() when the node only had to run a maintenance task, such as compact-shared-memory
+            bool _exit_after_startup = false;
+
             fc::optional<string> _remote_endpoint;
             fc::optional<fc::api<network_broadcast_api>> _remote_net_api;
             fc::optional<fc::api<login_api>> _remote_login;
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <golos/application/api_method_stats.hpp>
+#include <golos/application/api_response_cache.hpp>
+
+#include <fc/rpc/websocket_api.hpp>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace golos {
+    namespace application {
+
+        /**
+         * @brief Websocket API connection accepting JSON-RPC 2.0 batch requests
+         *
+         * A message holding an array of requests is executed as a batch: the requests run as concurrent
+         * tasks, so with api-threads they are spread over the API thread pool, and the replies are sent
+         * back as one array in the order of the requests. Requests without id get no reply. Single
+         * requests are handled by websocket_api_connection as before, over websocket and HTTP alike.
+         * Malformed messages and batch members which are not requests are answered with JSON-RPC 2.0
+         * error objects with a null id, -32700 and -32600 respectively.
+         *
+         * Calls of the methods added with add_json_method() are answered with the JSON text their handler
+         * writes, e.g. with json_writer, so large results skip the conversion to fc::variant. The replies
+         * are identical to the ones of the generic path. Results of the methods added as cached are shared
+         * through the api_response_cache passed to the constructor until the next block.
+         *
+         * Once binary results are enabled on the connection, calls of the methods added with
+         * add_binary_method() are answered with the base64 of the fc::raw packed result instead of its
+         * JSON form. The reply itself stays a JSON text message, fc::http::websocket_connection can not
+         * send binary frames. Everything else, including errors of those methods, keeps the JSON replies.
+         *
+         * Every call is recorded in the api_method_stats passed to the constructor, if any. A request is
+         * parsed once: the calls are dispatched from the parsed message, the way websocket_api_connection
+         * does it after parsing the text.
+         */
+        class batch_api_connection : public fc::rpc::websocket_api_connection {
+        public:
+            typedef std::function<std::vector<char>(const fc::variants &args)> binary_method;
+
+            /// Returns the JSON text of the result
+            typedef std::function<std::string(const fc::variants &args)> json_method;
+
+            batch_api_connection(fc::http::websocket_connection &c, uint32_t max_batch_size,
+                                 std::shared_ptr<api_method_stats> stats,
+                                 std::shared_ptr<api_response_cache> cache = std::shared_ptr<api_response_cache>());
+
+            /**
+             * Answers {"method":"call","params":[api, method, args]} requests naming the api by name and
+             * passing @p arity arguments with @p handler, others go through the registered APIs
+             * @param cached Share the results through the api_response_cache of the connection
+             */
+            void add_json_method(const std::string &api, const std::string &method, uint32_t arity,
+                                 json_method handler, bool cached = false);
+
+            void add_binary_method(const std::string &api, const std::string &method, binary_method handler);
+
+            /// @return names of the methods answered in binary form, "api.method"
+            std::vector<std::string> set_binary_results(bool enabled);
+
+        private:
+            std::string on_request(const std::string &message, bool send_message);
+
+            std::string on_batch(const fc::variants &requests);
+
+            std::string on_call(const fc::variant &message, bool send_message);
+
+            /// Executes a parsed request, @p error is set when the reply is an error
+            std::string dispatch(const fc::variant &message, bool &error);
+
+            bool on_json_call(const fc::variant &message, std::string &reply, bool &error);
+
+            bool on_binary_call(const fc::variant &message, std::string &reply, bool &error);
+
+            struct json_method_entry {
+                uint32_t arity;
+                json_method handler;
+                bool cached;
+            };
+
+            const uint32_t _max_batch_size;
+            const std::shared_ptr<api_method_stats> _stats;
+            const std::shared_ptr<api_response_cache> _cache;
+
+            std::map<std::string, json_method_entry> _json_methods;
+
+            std::atomic<bool> _binary_results{false};
+            std::map<std::string, binary_method> _binary_methods;
+        };
+
+    }
+} // golos::application
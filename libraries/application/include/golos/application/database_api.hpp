@@ -1,5 +1,8 @@
 #pragma once
 
+#include <golos/application/api_method_stats.hpp>
+#include <golos/application/api_response_cache.hpp>
+#include <golos/application/api_thread_pool.hpp>
 #include <golos/application/applied_operation.hpp>
 #include <golos/application/state.hpp>
 
@@ -26,6 +29,14 @@
 #include <vector>
 
 namespace golos {
+    namespace tags {
+        class tag_object;
+    }
+
+    namespace languages {
+        class language_object;
+    }
+
     namespace application {
 
         using namespace golos::chain;
@@ -53,6 +64,13 @@ namespace golos {
 
         class database_api_impl;
 
+        /**
+         * Index entries selected by a discussion query, ordered like the index, with the ids of the
+         * comments which passed the filters
+         */
+        template<typename Object, typename DiscussionIndex>
+        using discussion_candidates = std::multimap<Object, comment_object::id_type, DiscussionIndex>;
+
 
 /**
  * @brief The database_api class implements the RPC API for the chain database.
@@ -71,12 +89,36 @@ namespace golos {
             // Subscriptions //
             ///////////////////
 
+            /**
+             * @brief Receive the accounts and comments returned by get_accounts and get_content when they change
+             * @param cb Called once per block with the changed objects, a removed object is null
+             * @param clear_filter Forget the objects watched so far
+             */
             void set_subscribe_callback(std::function<void(const variant &)> cb, bool clear_filter);
 
             void set_pending_transaction_callback(std::function<void(const variant &)> cb);
 
             void set_block_applied_callback(std::function<void(const variant &block_header)> cb);
 
+            /**
+             * @brief Receive every block together with its real and virtual operations
+             * @param cb Called with {"block_num", "block", "operations"} per block, an empty callback stops the feed
+             * @param start_block First block to send, older blocks are read from the history, 0 for the next block
+             * @param irreversible_only Send blocks only once they are irreversible
+             *
+             * At most 64 blocks are sent beyond the last one confirmed with acknowledge_block_feed(). Without
+             * irreversible_only a block number is sent again when a fork replaced the block.
+             *
+             * The operations of older blocks come from the account_history plugin. A start_block up to the head
+             * block is rejected unless the plugin is enabled without track-account-range and filter-posting-ops,
+             * and without it a feed which falls far behind the head block is stopped.
+             */
+            void set_block_feed_callback(std::function<void(const variant &)> cb, uint32_t start_block,
+                                         bool irreversible_only);
+
+            /// Confirms the blocks of the feed up to @p block_num are processed
+            void acknowledge_block_feed(uint32_t block_num);
+
             /**
              * @brief Stop receiving any notifications
              *
@@ -144,6 +186,39 @@ namespace golos {
              */
             size_t get_free_memory() const;
 
+            /**
+             * @brief Retrieve the incremental checksum of the chain state after a block
+             * @param block_num Height of the block, only recently applied blocks are available
+             * @return the checksum, or null if state hashing is disabled or the block is too old
+             */
+            optional<uint64_t> get_state_hash(uint32_t block_num) const;
+
+            /**
+             * @brief Retrieve the time plugins spent handling database signals since the node start
+             */
+            std::vector<plugin_handler_stats> get_plugin_handler_stats() const;
+
+            /**
+             * @brief Retrieve the last block indexed by plugins, lags behind the head block by at most one
+             * block when deferred plugin indexing is enabled
+             */
+            uint32_t get_plugin_head_block_num() const;
+
+            /**
+             * @brief Retrieve the queue depth and wait times of the read API thread pool
+             */
+            api_thread_pool_stats get_api_thread_pool_stats() const;
+
+            /**
+             * @brief Retrieve the size and hit ratio of the discussion and trending tags response cache
+             */
+            api_response_cache_stats get_api_response_cache_stats() const;
+
+            /**
+             * @brief Retrieve the call counts, errors, latencies, reply sizes and read lock wait of the RPC methods
+             */
+            api_method_stats_result get_api_method_stats() const;
+
             /**
              * @brief Retrieve the current @ref dynamic_global_property_object
              */
@@ -209,7 +284,7 @@ namespace golos {
 
             optional<account_recovery_request_api_obj> get_recovery_request(std::string account) const;
 
-            optional<escrow_object> get_escrow(std::string from, uint32_t escrow_id) const;
+            optional<escrow_api_obj> get_escrow(std::string from, uint32_t escrow_id) const;
 
             std::vector<withdraw_route> get_withdraw_routes(std::string account, withdraw_route_type type = outgoing) const;
 
@@ -500,7 +575,7 @@ namespace golos {
                     typename CommentIndex,
                     typename Index,
                     typename StartItr
-            > std::multimap<Object, discussion, DiscussionIndex> get_discussions(
+            > discussion_candidates<Object, DiscussionIndex> get_discussions(
                     const discussion_query &query,
                     const std::string &tag,
                     comment_object::id_type parent,
@@ -517,7 +592,7 @@ namespace golos {
                     typename DiscussionIndex,
                     typename CommentIndex,
                     typename ...Args
-            > std::multimap<Object, discussion, DiscussionIndex> select(
+            > discussion_candidates<Object, DiscussionIndex> select(
                     const std::set<std::string> &select_set,
                     const discussion_query &query,
                     comment_object::id_type parent,
@@ -526,6 +601,13 @@ namespace golos {
                     const std::function<bool(const Object &)> &exit2,
                     Args... args) const;
 
+            /// Builds the discussions of the candidates selected by both the tags and the languages
+            template<typename TagIndex, typename LanguageIndex>
+            std::vector<discussion> materialize(
+                    const discussion_candidates<tags::tag_object, TagIndex> &tag_candidates,
+                    const discussion_candidates<languages::language_object, LanguageIndex> &language_candidates,
+                    const discussion_query &query) const;
+
             template<typename DatabaseIndex,
                     typename DiscussionIndex
             > std::vector<discussion> feed(const std::set<string> &select_set,
@@ -560,6 +642,8 @@ FC_API(golos::application::database_api,
         (set_subscribe_callback)
                 (set_pending_transaction_callback)
                 (set_block_applied_callback)
+                (set_block_feed_callback)
+                (acknowledge_block_feed)
                 (cancel_all_subscriptions)
 
                 // Tags
@@ -592,6 +676,12 @@ FC_API(golos::application::database_api,
                 // Globals
                 (get_config)
                 (get_free_memory)
+                (get_state_hash)
+                (get_plugin_handler_stats)
+                (get_plugin_head_block_num)
+                (get_api_thread_pool_stats)
+                (get_api_response_cache_stats)
+                (get_api_method_stats)
                 (get_dynamic_global_properties)
                 (get_chain_properties)
                 (get_feed_history)
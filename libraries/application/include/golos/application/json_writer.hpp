@@ -0,0 +1,263 @@
+#pragma once
+
+#include <golos/application/applied_operation.hpp>
+#include <golos/application/state.hpp>
+#include <golos/protocol/block.hpp>
+
+#include <fc/fixed_string.hpp>
+#include <fc/io/json.hpp>
+#include <fc/optional.hpp>
+#include <fc/reflect/reflect.hpp>
+#include <fc/reflect/variant.hpp>
+
+#include <boost/container/flat_set.hpp>
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace golos {
+    namespace application {
+
+        /**
+         * @brief Marks reflected types written member by member by json_writer
+         *
+         * Only types whose fc::variant form is the plain reflected object may be listed here: a type with
+         * its own to_variant (asset, static_variant, keys) has to go through the variant path to keep the
+         * output identical.
+         */
+        template<typename T>
+        struct fast_json : std::false_type {
+        };
+
+        template<> struct fast_json<comment_api_object> : std::true_type {};
+        template<> struct fast_json<discussion> : std::true_type {};
+        template<> struct fast_json<vote_state> : std::true_type {};
+        template<> struct fast_json<account_api_obj> : std::true_type {};
+        template<> struct fast_json<extended_account> : std::true_type {};
+        template<> struct fast_json<applied_operation> : std::true_type {};
+        template<> struct fast_json<protocol::block_header> : std::true_type {};
+        template<> struct fast_json<protocol::signed_block_header> : std::true_type {};
+        template<> struct fast_json<protocol::signed_block> : std::true_type {};
+        template<> struct fast_json<protocol::transaction> : std::true_type {};
+        template<> struct fast_json<protocol::signed_transaction> : std::true_type {};
+
+        /**
+         * @brief Writes API objects as JSON without building an fc::variant tree
+         *
+         * The output is byte for byte what fc::json::to_string(fc::variant(value)) produces: objects keep
+         * the reflection order and skip unset optionals, integers beyond 32 bits are quoted. Strings,
+         * integers, bools, containers and the types marked with fast_json are written directly, any
+         * other member is converted through fc::variant on its own, which keeps the result exact while
+         * large strings such as comment bodies are copied only once, into the output.
+         */
+        class json_writer {
+        public:
+            explicit json_writer(std::string &out) : _out(out) {
+            }
+
+            void write(const std::string &value) {
+                write_string(value.data(), value.size());
+            }
+
+            void write(const char *value) {
+                write_string(value, std::char_traits<char>::length(value));
+            }
+
+            void write(const fc::fixed_string<> &value) {
+                write(std::string(value));
+            }
+
+            void write(bool value) {
+                _out += value ? "true" : "false";
+            }
+
+            template<typename T>
+            typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+            write(T value) {
+                const int64_t v = value;
+                write_integer(std::to_string(v), v > 0xffffffff || v < -int64_t(0xffffffff));
+            }
+
+            template<typename T>
+            typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type
+            write(T value) {
+                const uint64_t v = value;
+                write_integer(std::to_string(v), v > 0xffffffff);
+            }
+
+            template<typename T>
+            void write(const fc::optional<T> &value) {
+                if (value.valid()) {
+                    write(*value);
+                } else {
+                    _out += "null";
+                }
+            }
+
+            template<typename T>
+            void write(const std::vector<T> &value) {
+                write_array(value);
+            }
+
+            template<typename T>
+            void write(const std::set<T> &value) {
+                write_array(value);
+            }
+
+            template<typename T>
+            void write(const boost::container::flat_set<T> &value) {
+                write_array(value);
+            }
+
+            template<typename K, typename V>
+            void write(const std::pair<K, V> &value) {
+                _out += '[';
+                write(value.first);
+                _out += ',';
+                write(value.second);
+                _out += ']';
+            }
+
+            /// fc writes maps as arrays of [key, value] pairs
+            template<typename K, typename V>
+            void write(const std::map<K, V> &value) {
+                write_array(value);
+            }
+
+            template<typename T>
+            typename std::enable_if<!std::is_integral<T>::value>::type
+            write(const T &value) {
+                write_object(value, fast_json<T>());
+            }
+
+        private:
+            template<typename Class>
+            class member_visitor {
+            public:
+                member_visitor(json_writer &writer, const Class &value, bool &first)
+                        : _writer(writer), _value(value), _first(first) {
+                }
+
+                template<typename Member, class Base, Member (Base::*member)>
+                void operator()(const char *name) const {
+                    add(name, _value.*member);
+                }
+
+            private:
+                template<typename M>
+                void add(const char *name, const fc::optional<M> &value) const {
+                    if (value.valid()) {
+                        add(name, *value);
+                    }
+                }
+
+                template<typename M>
+                void add(const char *name, const M &value) const {
+                    _writer._out += _first ? "{" : ",";
+                    _first = false;
+                    _writer.write(name);
+                    _writer._out += ':';
+                    _writer.write(value);
+                }
+
+                json_writer &_writer;
+                const Class &_value;
+                bool &_first;
+            };
+
+            template<typename T>
+            void write_object(const T &value, std::true_type) {
+                bool first = true;
+                fc::reflector<T>::visit(member_visitor<T>(*this, value, first));
+                _out += first ? "{}" : "}";
+            }
+
+            template<typename T>
+            void write_object(const T &value, std::false_type) {
+                _out += fc::json::to_string(fc::variant(value));
+            }
+
+            template<typename Container>
+            void write_array(const Container &value) {
+                _out += '[';
+                bool first = true;
+                for (const auto &item : value) {
+                    if (!first) {
+                        _out += ',';
+                    }
+                    first = false;
+                    write(item);
+                }
+                _out += ']';
+            }
+
+            void write_integer(const std::string &digits, bool quoted) {
+                if (quoted) {
+                    _out += '"';
+                    _out += digits;
+                    _out += '"';
+                } else {
+                    _out += digits;
+                }
+            }
+
+            void write_string(const char *data, size_t size) {
+                static const char hex[] = "0123456789abcdef";
+
+                _out.reserve(_out.size() + size + 2);
+                _out += '"';
+                for (size_t i = 0; i < size; ++i) {
+                    const char c = data[i];
+                    switch (c) {
+                        case '\b':
+                            _out += "\\b";
+                            break;
+                        case '\t':
+                            _out += "\\t";
+                            break;
+                        case '\n':
+                            _out += "\\n";
+                            break;
+                        case '\f':
+                            _out += "\\f";
+                            break;
+                        case '\r':
+                            _out += "\\r";
+                            break;
+                        case '\\':
+                            _out += "\\\\";
+                            break;
+                        case '"':
+                            _out += "\\\"";
+                            break;
+                        default:
+                            if (static_cast<unsigned char>(c) < 0x20) {
+                                _out += "\\u00";
+                                _out += hex[(c >> 4) & 0xf];
+                                _out += hex[c & 0xf];
+                            } else {
+                                _out += c;
+                            }
+                    }
+                }
+                _out += '"';
+            }
+
+            std::string &_out;
+        };
+
+        /// Same result as fc::json::to_string(fc::variant(value))
+        template<typename T>
+        std::string to_json(const T &value) {
+            std::string result;
+            json_writer(result).write(value);
+            return result;
+        }
+
+    }
+} // golos::application
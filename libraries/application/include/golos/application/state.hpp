@@ -111,7 +111,7 @@ namespace golos {
             vector<pair<account_name_type, uint32_t>> guest_bloggers;
 
             optional<map<uint32_t, extended_limit_order>> open_orders;
-            optional<vector<account_balance_object>> balances;
+            optional<vector<account_balance_api_obj>> balances;
             optional<vector<call_order_object>> call_orders;
             optional<vector<force_settlement_object>> settle_orders;
             optional<vector<asset_symbol_type>> assets;
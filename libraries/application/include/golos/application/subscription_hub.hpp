@@ -0,0 +1,254 @@
+#pragma once
+
+#include <golos/application/applied_operation.hpp>
+#include <golos/chain/database.hpp>
+#include <golos/chain/operation_notification.hpp>
+
+#include <fc/container/flat.hpp>
+#include <fc/thread/thread.hpp>
+#include <fc/variant.hpp>
+
+#include <boost/signals2.hpp>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace golos {
+    namespace application {
+
+        /**
+         * @brief Node-wide fan-out of chain events to API sessions
+         *
+         * The hub holds the only applied_block connection used by the API sessions. The header of an
+         * applied block is converted to a variant and its transaction ids are calculated once, and the
+         * subscribers are notified on a dedicated thread. The chain thread does not pay per connected
+         * client, and nothing is prepared while nobody is subscribed.
+         *
+         * Changed objects are tracked per block from the applied operations and matched against the
+         * watched keys of all sessions in one inverted index, so a session is only visited when one of
+         * its objects changed, and every changed object is serialized once per block.
+         *
+         * The block feed entry of a block, the block with all its real and virtual operations, is built
+         * once and shared by all feed subscribers. While there is a feed, the database emits all virtual
+         * operations, as it does with account_history enabled. The changed objects subscriptions only
+         * make it emit the virtual operations which change accounts and comments, except curation
+         * rewards. Feeds keep a cursor, so they can start from an older
+         * block, and wait for the consumer to acknowledge what it received before pushing further.
+         *
+         * Subscriptions are bound to the lifetime of their owner, usually the API object of a session.
+         * Subscriptions of expired owners and callbacks which throw are dropped.
+         */
+        class subscription_hub {
+        public:
+            typedef std::function<void(const fc::variant &)> block_header_callback;
+
+            /**
+             * @param block_num Block which includes the transaction, or the head block when it expired
+             * @param trx_num Position of the transaction in the block, -1 when it expired
+             */
+            typedef std::function<void(const protocol::transaction_id_type &id, int32_t block_num, int32_t trx_num,
+                                       bool expired)> confirmation_callback;
+
+            /// Called once per block with {"block_num", "objects"}, objects are {"type", "key", "object"}
+            typedef std::function<void(const fc::variant &)> changed_objects_callback;
+
+            /// Called once per block with {"block_num", "block", "operations"}, operations are applied_operation
+            typedef std::function<void(const fc::variant &)> block_feed_callback;
+
+            typedef std::pair<protocol::account_name_type, std::string> comment_key;
+
+            /// Objects a session watches, an object is null in the update when it has been removed
+            struct changed_object_keys {
+                fc::flat_set<protocol::account_name_type> accounts;
+                fc::flat_set<comment_key> comments;
+
+                bool empty() const {
+                    return accounts.empty() && comments.empty();
+                }
+            };
+
+            /// Upper bound of the keys watched by one owner, later keys are ignored
+            static constexpr std::size_t max_watched_keys = 10000;
+
+            /// Blocks a feed pushes beyond the last acknowledged one before it waits for the consumer
+            static constexpr uint32_t block_feed_window = 64;
+
+            /// Number of recent feed entries kept for the feeds behind the head block
+            static constexpr std::size_t block_feed_cache_size = 256;
+
+            subscription_hub(chain::database &db);
+
+            ~subscription_hub();
+
+            /**
+             * Calls @p callback with the signed_block_header of every applied block, replaces the previous
+             * header subscription of the owner
+             */
+            void subscribe_block_headers(const std::weak_ptr<void> &owner, block_header_callback callback);
+
+            /**
+             * Calls @p callback once, when a block includes the transaction, or when the transaction
+             * expires without being included
+             */
+            void subscribe_transaction(const std::weak_ptr<void> &owner, const protocol::transaction_id_type &id,
+                                       fc::time_point_sec expiration, confirmation_callback callback);
+
+            /**
+             * Sets the changed objects callback of the owner, an empty callback removes the subscription
+             * @param clear_keys Forget the keys watched so far
+             */
+            void subscribe_changed_objects(const std::weak_ptr<void> &owner, changed_objects_callback callback,
+                                           bool clear_keys);
+
+            /// Adds keys to the set watched by the owner, ignored when the owner has no changed objects subscription
+            void watch_changed_objects(const std::weak_ptr<void> &owner, changed_object_keys keys);
+
+            /**
+             * Declares whether the operation history, filled by the account_history plugin, holds every
+             * operation of the applied blocks. It is incomplete unless the plugin is enabled and tracks all
+             * accounts and operations.
+             */
+            void set_operation_history_complete(bool complete);
+
+            /**
+             * Sets the block feed of the owner, an empty callback removes it. Must be called on the chain thread.
+             *
+             * Blocks which are no longer cached are read from the block log, their operations from the
+             * operation history. So a feed can start at an older block only while the history is complete,
+             * and a feed which falls behind the cache without it is dropped. Blocks whose operations the
+             * deferred plugin indexing hasn't indexed yet are sent with a later block. When a fork replaces
+             * blocks already sent, the feed continues from the first replaced block.
+             *
+             * @param start_block First block to send, 0 to start with the next block
+             * @param irreversible_only Send a block only once it became irreversible
+             */
+            void subscribe_block_feed(const std::weak_ptr<void> &owner, block_feed_callback callback,
+                                      uint32_t start_block, bool irreversible_only);
+
+            /// Confirms the blocks up to @p block_num are processed, so the feed of the owner may send more
+            void acknowledge_block_feed(const std::weak_ptr<void> &owner, uint32_t block_num);
+
+            /// Waits until the hub thread has processed the subscriptions and the blocks queued so far
+            void flush();
+
+        private:
+            struct block_event {
+                uint32_t block_num = 0;
+                fc::time_point_sec timestamp;
+                fc::variant header;
+                std::vector<protocol::transaction_id_type> transactions;
+                changed_object_keys changes;
+                std::shared_ptr<protocol::signed_block> block;
+                std::vector<applied_operation> operations;
+                uint32_t irreversible_block_num = 0;
+            };
+
+            struct header_subscription {
+                std::weak_ptr<void> owner;
+                block_header_callback callback;
+            };
+
+            struct transaction_subscription {
+                std::weak_ptr<void> owner;
+                confirmation_callback callback;
+            };
+
+            struct changed_objects_subscription {
+                std::weak_ptr<void> owner;
+                changed_objects_callback callback;
+                changed_object_keys keys;
+            };
+
+            struct block_feed_subscription {
+                block_feed_callback callback;
+                bool irreversible_only = false;
+                /// Next block to send
+                uint32_t next_block = 0;
+                uint32_t acknowledged_block = 0;
+            };
+
+            typedef std::shared_ptr<const fc::variant> block_feed_entry;
+
+            typedef std::map<std::weak_ptr<void>, uint64_t, std::owner_less<std::weak_ptr<void>>> owner_index;
+
+            void on_applied_block(const protocol::signed_block &b);
+
+            /// Runs on the chain thread while someone watches changed objects
+            void on_applied_operation(const chain::operation_notification &note);
+
+            /// Runs on the chain thread while there are block feeds
+            void on_feed_operation(const chain::operation_notification &note);
+
+            /// Runs on the hub thread, which owns all subscriptions
+            void dispatch(const block_event &event);
+
+            void notify_transactions(const block_event &event);
+
+            void expire_transactions(const block_event &event);
+
+            void notify_changed_objects(const block_event &event);
+
+            void notify_block_feeds(const block_event &event);
+
+            static block_feed_entry make_block_feed_entry(const block_event &event);
+
+            /// Sends the blocks the feed may send, returns false when the feed failed
+            bool send_block_feed(block_feed_subscription &feed);
+
+            /**
+             * Reads the entries of past blocks missing in the cache on the chain thread
+             * @return Last block the entries up to which are available
+             */
+            uint32_t load_block_feed_entries(uint32_t first, uint32_t last);
+
+            void remove_changed_objects_subscription(uint64_t id);
+
+            /// Connects the operation handler while there are changed objects subscriptions
+            void update_operation_connection();
+
+            chain::database &_db;
+
+            fc::thread &_chain_thread;
+            fc::thread _thread;
+            boost::signals2::scoped_connection _applied_block_connection;
+
+            std::atomic<uint32_t> _header_subscription_count{0};
+            std::atomic<uint32_t> _transaction_subscription_count{0};
+            std::atomic<uint32_t> _changed_objects_subscription_count{0};
+            std::atomic<uint32_t> _block_feed_subscription_count{0};
+            std::atomic<bool> _operation_history_complete{false};
+
+            std::vector<header_subscription> _header_subscriptions;
+            std::multimap<protocol::transaction_id_type, transaction_subscription> _transaction_subscriptions;
+            std::multimap<fc::time_point_sec, protocol::transaction_id_type> _transaction_expirations;
+
+            /// Connected while there are changed objects subscriptions, changed by the hub thread
+            chain::database::operation_handler_id _operation_handler = 0;
+            /// Changes of the block being applied, owned by the chain thread
+            changed_object_keys _pending_changes;
+            /// Connected and disconnected by the chain thread, so it is known whether a block is complete
+            chain::database::operation_handler_id _feed_operation_handler = 0;
+            /// Operations of the block being applied, owned by the chain thread
+            std::vector<applied_operation> _pending_operations;
+
+            uint64_t _next_changed_objects_id = 0;
+            std::map<uint64_t, changed_objects_subscription> _changed_objects_subscriptions;
+            owner_index _changed_objects_owners;
+            /// Inverted index of the watched keys
+            std::map<protocol::account_name_type, std::set<uint64_t>> _account_watchers;
+            std::map<comment_key, std::set<uint64_t>> _comment_watchers;
+
+            std::map<std::weak_ptr<void>, block_feed_subscription, std::owner_less<std::weak_ptr<void>>> _block_feeds;
+            std::map<uint32_t, block_feed_entry> _block_feed_cache;
+            uint32_t _head_block_num = 0;
+            uint32_t _irreversible_block_num = 0;
+        };
+
+    }
+} // golos::application
@@ -0,0 +1,644 @@
+#include <golos/application/subscription_hub.hpp>
+#include <golos/application/impacted.hpp>
+#include <golos/application/api_objects/comment_api_object.hpp>
+#include <golos/application/api_objects/steem_api_objects.hpp>
+
+#include <fc/variant_object.hpp>
+
+#include <algorithm>
+
+namespace golos {
+    namespace application {
+
+        namespace {
+            using namespace golos::protocol;
+
+            /// Comments whose state an operation changes
+            struct changed_comments_visitor {
+                typedef void result_type;
+
+                fc::flat_set<subscription_hub::comment_key> &_comments;
+
+                changed_comments_visitor(fc::flat_set<subscription_hub::comment_key> &comments)
+                        : _comments(comments) {
+                }
+
+                void add(const account_name_type &author, const std::string &permlink) {
+                    _comments.emplace(author, permlink);
+                }
+
+                template<typename T>
+                void operator()(const T &) {
+                }
+
+                template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
+                void operator()(const comment_operation<Major, Hardfork, Release> &op) {
+                    add(op.author, op.permlink);
+                    if (op.parent_author.size()) {
+                        add(op.parent_author, op.parent_permlink);
+                    }
+                }
+
+                template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
+                void operator()(const comment_options_operation<Major, Hardfork, Release> &op) {
+                    add(op.author, op.permlink);
+                }
+
+                template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
+                void operator()(const delete_comment_operation<Major, Hardfork, Release> &op) {
+                    add(op.author, op.permlink);
+                }
+
+                template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
+                void operator()(const vote_operation<Major, Hardfork, Release> &op) {
+                    add(op.author, op.permlink);
+                }
+
+                template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
+                void operator()(const author_reward_operation<Major, Hardfork, Release> &op) {
+                    add(op.author, op.permlink);
+                }
+
+                template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
+                void operator()(const curation_reward_operation<Major, Hardfork, Release> &op) {
+                    add(op.comment_author, op.comment_permlink);
+                }
+
+                template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
+                void operator()(const comment_reward_operation<Major, Hardfork, Release> &op) {
+                    add(op.author, op.permlink);
+                }
+
+                template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
+                void operator()(const comment_payout_update_operation<Major, Hardfork, Release> &op) {
+                    add(op.author, op.permlink);
+                }
+
+                template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
+                void operator()(const comment_benefactor_reward_operation<Major, Hardfork, Release> &op) {
+                    add(op.author, op.permlink);
+                }
+            };
+
+            /**
+             * Operations which change watched accounts and comments. Curation rewards, one per vote of a
+             * paid out comment, are left out, so a watcher doesn't make the database build them: the
+             * comment is reported by the other payout operations, the accounts of the curators are not.
+             */
+            typedef chain::operations_except<chain::all_operations,
+                    chain::operation_templates<curation_reward_operation>> changed_objects_operations;
+
+            fc::variant changed_object(const char *type, const fc::variant &key, fc::variant object) {
+                return fc::mutable_variant_object()("type", type)("key", key)("object", std::move(object));
+            }
+
+            applied_operation to_applied_operation(const chain::operation_notification &note) {
+                applied_operation result;
+                result.trx_id = note.trx_id;
+                result.block = note.block;
+                result.trx_in_block = note.trx_in_block;
+                result.op_in_trx = note.op_in_trx;
+                result.virtual_op = note.virtual_op;
+                result.timestamp = note.timestamp;
+                result.op = note.op;
+                return result;
+            }
+        }
+
+        subscription_hub::subscription_hub(chain::database &db)
+                : _db(db), _chain_thread(fc::thread::current()), _thread("subscriptions") {
+            _applied_block_connection = db.applied_block.connect([this](const protocol::signed_block &b) {
+                on_applied_block(b);
+            });
+        }
+
+        subscription_hub::~subscription_hub() {
+            _applied_block_connection.disconnect();
+            _thread.quit();
+            // runs on the chain thread, so no operation is being applied
+            if (_operation_handler != 0) {
+                _db.disconnect_operation_handler(_operation_handler);
+            }
+            if (_feed_operation_handler != 0) {
+                _db.disconnect_operation_handler(_feed_operation_handler);
+            }
+        }
+
+        void subscription_hub::subscribe_block_headers(const std::weak_ptr<void> &owner,
+                                                       block_header_callback callback) {
+            _thread.async([this, owner, callback]() {
+                auto itr = std::find_if(_header_subscriptions.begin(), _header_subscriptions.end(),
+                                        [&](const header_subscription &s) {
+                                            return !s.owner.owner_before(owner) && !owner.owner_before(s.owner);
+                                        });
+                if (itr != _header_subscriptions.end()) {
+                    itr->callback = callback;
+                } else {
+                    _header_subscriptions.push_back({owner, callback});
+                    ++_header_subscription_count;
+                }
+            }, "subscribe_block_headers");
+        }
+
+        void subscription_hub::subscribe_transaction(const std::weak_ptr<void> &owner,
+                                                     const protocol::transaction_id_type &id,
+                                                     fc::time_point_sec expiration, confirmation_callback callback) {
+            // counted right away, so the block including the transaction is not skipped by on_applied_block()
+            ++_transaction_subscription_count;
+            _thread.async([this, owner, id, expiration, callback]() {
+                _transaction_subscriptions.emplace(id, transaction_subscription{owner, callback});
+                _transaction_expirations.emplace(expiration, id);
+            }, "subscribe_transaction");
+        }
+
+        void subscription_hub::subscribe_changed_objects(const std::weak_ptr<void> &owner,
+                                                         changed_objects_callback callback, bool clear_keys) {
+            _thread.async([this, owner, callback, clear_keys]() {
+                auto itr = _changed_objects_owners.find(owner);
+                if (itr != _changed_objects_owners.end()) {
+                    const auto id = itr->second;
+                    if (!callback || clear_keys) {
+                        remove_changed_objects_subscription(id);
+                    } else {
+                        _changed_objects_subscriptions[id].callback = callback;
+                    }
+                }
+
+                if (callback && _changed_objects_owners.find(owner) == _changed_objects_owners.end()) {
+                    const auto id = _next_changed_objects_id++;
+                    _changed_objects_subscriptions[id] = {owner, callback, {}};
+                    _changed_objects_owners[owner] = id;
+                    ++_changed_objects_subscription_count;
+                }
+
+                update_operation_connection();
+            }, "subscribe_changed_objects");
+        }
+
+        void subscription_hub::watch_changed_objects(const std::weak_ptr<void> &owner, changed_object_keys keys) {
+            if (keys.empty()) {
+                return;
+            }
+
+            _thread.async([this, owner, keys]() {
+                auto itr = _changed_objects_owners.find(owner);
+                if (itr == _changed_objects_owners.end()) {
+                    return;
+                }
+
+                const auto id = itr->second;
+                auto &watched = _changed_objects_subscriptions[id].keys;
+                for (const auto &name : keys.accounts) {
+                    if (watched.accounts.size() + watched.comments.size() >= max_watched_keys) {
+                        return;
+                    }
+                    if (watched.accounts.insert(name).second) {
+                        _account_watchers[name].insert(id);
+                    }
+                }
+                for (const auto &comment : keys.comments) {
+                    if (watched.accounts.size() + watched.comments.size() >= max_watched_keys) {
+                        return;
+                    }
+                    if (watched.comments.insert(comment).second) {
+                        _comment_watchers[comment].insert(id);
+                    }
+                }
+            }, "watch_changed_objects");
+        }
+
+        void subscription_hub::set_operation_history_complete(bool complete) {
+            _operation_history_complete = complete;
+        }
+
+        void subscription_hub::subscribe_block_feed(const std::weak_ptr<void> &owner, block_feed_callback callback,
+                                                    uint32_t start_block, bool irreversible_only) {
+            const uint32_t head_block_num = _db.head_block_num();
+            const uint32_t irreversible_block_num = _db.last_non_undoable_block_num();
+            FC_ASSERT(!callback || start_block == 0 || start_block > head_block_num || _operation_history_complete,
+                      "Feed can't start at an older block, the operation history of this node is incomplete");
+
+            // counted right away, so the next block already carries its operations
+            if (callback) {
+                ++_block_feed_subscription_count;
+            }
+            _thread.async([=]() {
+                _head_block_num = head_block_num;
+                _irreversible_block_num = irreversible_block_num;
+
+                auto itr = _block_feeds.find(owner);
+                if (itr != _block_feeds.end()) {
+                    _block_feeds.erase(itr);
+                    --_block_feed_subscription_count;
+                }
+                if (!callback) {
+                    return;
+                }
+
+                auto &feed = _block_feeds[owner];
+                feed.callback = callback;
+                feed.irreversible_only = irreversible_only;
+                feed.next_block = start_block ? start_block : head_block_num + 1;
+                feed.acknowledged_block = feed.next_block - 1;
+                if (!send_block_feed(feed)) {
+                    _block_feeds.erase(owner);
+                    --_block_feed_subscription_count;
+                }
+            }, "subscribe_block_feed");
+        }
+
+        void subscription_hub::acknowledge_block_feed(const std::weak_ptr<void> &owner, uint32_t block_num) {
+            _thread.async([this, owner, block_num]() {
+                auto itr = _block_feeds.find(owner);
+                if (itr == _block_feeds.end()) {
+                    return;
+                }
+
+                auto &feed = itr->second;
+                feed.acknowledged_block = std::max(feed.acknowledged_block, std::min(block_num, feed.next_block - 1));
+                if (!send_block_feed(feed)) {
+                    _block_feeds.erase(itr);
+                    --_block_feed_subscription_count;
+                }
+            }, "acknowledge_block_feed");
+        }
+
+        void subscription_hub::flush() {
+            _thread.async([]() {
+            }, "flush").wait();
+        }
+
+        void subscription_hub::remove_changed_objects_subscription(uint64_t id) {
+            auto itr = _changed_objects_subscriptions.find(id);
+            if (itr == _changed_objects_subscriptions.end()) {
+                return;
+            }
+
+            for (const auto &name : itr->second.keys.accounts) {
+                auto watchers = _account_watchers.find(name);
+                watchers->second.erase(id);
+                if (watchers->second.empty()) {
+                    _account_watchers.erase(watchers);
+                }
+            }
+            for (const auto &comment : itr->second.keys.comments) {
+                auto watchers = _comment_watchers.find(comment);
+                watchers->second.erase(id);
+                if (watchers->second.empty()) {
+                    _comment_watchers.erase(watchers);
+                }
+            }
+
+            _changed_objects_owners.erase(itr->second.owner);
+            _changed_objects_subscriptions.erase(itr);
+            --_changed_objects_subscription_count;
+        }
+
+        void subscription_hub::update_operation_connection() {
+            const bool connect = !_changed_objects_subscriptions.empty();
+            if (connect == (_operation_handler != 0)) {
+                return;
+            }
+
+            // the handlers are changed while no operation is being applied
+            _db.with_write_lock([&]() {
+                if (connect) {
+                    _operation_handler = _db.post_apply_operation_connect<changed_objects_operations>(
+                            [this](const chain::operation_notification &note) {
+                                on_applied_operation(note);
+                            });
+                } else {
+                    _db.disconnect_operation_handler(_operation_handler);
+                    _operation_handler = 0;
+                }
+            });
+        }
+
+        void subscription_hub::on_applied_operation(const chain::operation_notification &note) {
+            operation_get_impacted_accounts(note.op, _pending_changes.accounts);
+
+            changed_comments_visitor visitor(_pending_changes.comments);
+            note.op.visit(visitor);
+        }
+
+        void subscription_hub::on_feed_operation(const chain::operation_notification &note) {
+            _pending_operations.push_back(to_applied_operation(note));
+        }
+
+        void subscription_hub::on_applied_block(const protocol::signed_block &b) {
+            const bool headers = _header_subscription_count != 0;
+            const bool transactions = _transaction_subscription_count != 0;
+            const bool changes = _changed_objects_subscription_count != 0 && !_pending_changes.empty();
+            const bool feeds = _block_feed_subscription_count != 0;
+
+            // the operations are complete only when the handler was connected before the block was applied,
+            // it is called under the write lock of the block, so the handler may be changed here
+            const bool feed_operations = feeds && _feed_operation_handler != 0;
+            if (feeds && !feed_operations) {
+                _feed_operation_handler = _db.post_apply_operation_connect<chain::all_operations>(
+                        [this](const chain::operation_notification &note) {
+                            on_feed_operation(note);
+                        });
+            } else if (!feeds && _feed_operation_handler != 0) {
+                _db.disconnect_operation_handler(_feed_operation_handler);
+                _feed_operation_handler = 0;
+            }
+
+            if (!headers && !transactions && !changes && !feeds) {
+                _pending_changes = changed_object_keys();
+                _pending_operations.clear();
+                return;
+            }
+
+            auto event = std::make_shared<block_event>();
+            event->block_num = b.block_num();
+            event->timestamp = b.timestamp;
+            if (headers) {
+                event->header = fc::variant(protocol::signed_block_header(b));
+            }
+            if (transactions) {
+                event->transactions.reserve(b.transactions.size());
+                for (const auto &trx : b.transactions) {
+                    event->transactions.push_back(trx.id());
+                }
+            }
+            // changes of pending transactions are reported with the next block
+            std::swap(event->changes, _pending_changes);
+            _pending_changes = changed_object_keys();
+
+            // operations of pending transactions carry the number of the previous block and are dropped,
+            // a block applied while the handler was being connected is read from the history instead
+            if (feed_operations) {
+                event->block = std::make_shared<protocol::signed_block>(b);
+                for (auto &op : _pending_operations) {
+                    if (op.block == event->block_num) {
+                        event->operations.push_back(std::move(op));
+                    }
+                }
+            }
+            _pending_operations.clear();
+            event->irreversible_block_num = _db.last_non_undoable_block_num();
+
+            _thread.async([this, event]() {
+                dispatch(*event);
+            }, "dispatch_block");
+        }
+
+        void subscription_hub::dispatch(const block_event &event) {
+            if (!event.header.is_null()) {
+                for (auto itr = _header_subscriptions.begin(); itr != _header_subscriptions.end();) {
+                    bool keep = !itr->owner.expired();
+                    if (keep) {
+                        try {
+                            itr->callback(event.header);
+                        } catch (...) {
+                            keep = false;
+                        }
+                    }
+
+                    if (keep) {
+                        ++itr;
+                    } else {
+                        itr = _header_subscriptions.erase(itr);
+                        --_header_subscription_count;
+                    }
+                }
+            }
+
+            notify_transactions(event);
+            expire_transactions(event);
+            notify_changed_objects(event);
+            notify_block_feeds(event);
+        }
+
+        void subscription_hub::notify_transactions(const block_event &event) {
+            for (std::size_t trx_num = 0; trx_num < event.transactions.size(); ++trx_num) {
+                const auto &id = event.transactions[trx_num];
+                auto range = _transaction_subscriptions.equal_range(id);
+
+                for (auto itr = range.first; itr != range.second; ++itr) {
+                    if (itr->second.owner.expired()) {
+                        continue;
+                    }
+                    try {
+                        itr->second.callback(id, int32_t(event.block_num), int32_t(trx_num), false);
+                    } catch (...) {
+                    }
+                }
+
+                _transaction_subscription_count -= std::distance(range.first, range.second);
+                _transaction_subscriptions.erase(range.first, range.second);
+            }
+        }
+
+        void subscription_hub::expire_transactions(const block_event &event) {
+            while (!_transaction_expirations.empty() && _transaction_expirations.begin()->first < event.timestamp) {
+                const auto id = _transaction_expirations.begin()->second;
+                _transaction_expirations.erase(_transaction_expirations.begin());
+
+                // the subscription is gone when the transaction has been confirmed
+                auto range = _transaction_subscriptions.equal_range(id);
+                for (auto itr = range.first; itr != range.second; ++itr) {
+                    if (itr->second.owner.expired()) {
+                        continue;
+                    }
+                    try {
+                        itr->second.callback(id, int32_t(event.block_num), -1, true);
+                    } catch (...) {
+                    }
+                }
+
+                _transaction_subscription_count -= std::distance(range.first, range.second);
+                _transaction_subscriptions.erase(range.first, range.second);
+            }
+        }
+
+        void subscription_hub::notify_changed_objects(const block_event &event) {
+            // sessions which are gone are dropped on every block, not only when an object they watch changes,
+            // so the operation handler is disconnected as soon as the last session is gone
+            for (auto itr = _changed_objects_subscriptions.begin(); itr != _changed_objects_subscriptions.end();) {
+                const auto id = itr->first;
+                const bool expired = itr->second.owner.expired();
+                ++itr;
+                if (expired) {
+                    remove_changed_objects_subscription(id);
+                }
+            }
+
+            if (!_changed_objects_subscriptions.empty() && !event.changes.empty()) {
+                // every changed object is serialized once and shared by all sessions watching it
+                std::map<uint64_t, std::vector<fc::variant>> updates;
+                _db.with_read_lock([&]() {
+                    for (const auto &name : event.changes.accounts) {
+                        auto watchers = _account_watchers.find(name);
+                        if (watchers == _account_watchers.end()) {
+                            continue;
+                        }
+
+                        const auto *account = _db.find_account(name);
+                        auto update = changed_object("account", fc::variant(name),
+                                account ? fc::variant(account_api_obj(*account, _db)) : fc::variant());
+                        for (auto id : watchers->second) {
+                            updates[id].push_back(update);
+                        }
+                    }
+
+                    for (const auto &comment : event.changes.comments) {
+                        auto watchers = _comment_watchers.find(comment);
+                        if (watchers == _comment_watchers.end()) {
+                            continue;
+                        }
+
+                        const auto *object = _db.find_comment(comment.first, comment.second);
+                        auto update = changed_object("comment", fc::variant(comment),
+                                object ? fc::variant(comment_api_object(*object)) : fc::variant());
+                        for (auto id : watchers->second) {
+                            updates[id].push_back(update);
+                        }
+                    }
+                });
+
+                for (auto &update : updates) {
+                    auto itr = _changed_objects_subscriptions.find(update.first);
+                    bool keep = !itr->second.owner.expired();
+                    if (keep) {
+                        try {
+                            itr->second.callback(fc::mutable_variant_object()
+                                    ("block_num", event.block_num)
+                                    ("objects", std::move(update.second)));
+                        } catch (...) {
+                            keep = false;
+                        }
+                    }
+
+                    if (!keep) {
+                        remove_changed_objects_subscription(update.first);
+                    }
+                }
+            }
+
+            update_operation_connection();
+        }
+
+        subscription_hub::block_feed_entry subscription_hub::make_block_feed_entry(const block_event &event) {
+            return std::make_shared<const fc::variant>(fc::mutable_variant_object()
+                    ("block_num", event.block_num)
+                    ("block", *event.block)
+                    ("operations", event.operations));
+        }
+
+        void subscription_hub::notify_block_feeds(const block_event &event) {
+            _head_block_num = event.block_num;
+            _irreversible_block_num = event.irreversible_block_num;
+
+            if (_block_feeds.empty()) {
+                _block_feed_cache.clear();
+                return;
+            }
+
+            // a block replacing a sent one starts a fork, the later entries belong to the old branch
+            _block_feed_cache.erase(_block_feed_cache.lower_bound(event.block_num), _block_feed_cache.end());
+            if (event.block) {
+                _block_feed_cache[event.block_num] = make_block_feed_entry(event);
+            }
+
+            for (auto itr = _block_feeds.begin(); itr != _block_feeds.end();) {
+                auto &feed = itr->second;
+                if (!feed.irreversible_only && feed.next_block > event.block_num) {
+                    feed.next_block = event.block_num;
+                }
+
+                if (!itr->first.expired() && send_block_feed(feed)) {
+                    ++itr;
+                } else {
+                    itr = _block_feeds.erase(itr);
+                    --_block_feed_subscription_count;
+                }
+            }
+
+            while (_block_feed_cache.size() > block_feed_cache_size) {
+                _block_feed_cache.erase(_block_feed_cache.begin());
+            }
+        }
+
+        bool subscription_hub::send_block_feed(block_feed_subscription &feed) {
+            const uint32_t last_block = std::min(feed.irreversible_only ? _irreversible_block_num : _head_block_num,
+                                                 feed.acknowledged_block + block_feed_window);
+            if (feed.next_block > last_block) {
+                return true;
+            }
+
+            const uint32_t loaded_block = load_block_feed_entries(feed.next_block, last_block);
+            if (loaded_block < feed.next_block && !_operation_history_complete) {
+                return false;
+            }
+            try {
+                for (; feed.next_block <= loaded_block; ++feed.next_block) {
+                    auto itr = _block_feed_cache.find(feed.next_block);
+                    if (itr != _block_feed_cache.end()) {
+                        feed.callback(*itr->second);
+                    }
+                }
+            } catch (...) {
+                return false;
+            }
+            return true;
+        }
+
+        uint32_t subscription_hub::load_block_feed_entries(uint32_t first, uint32_t last) {
+            std::vector<uint32_t> missing;
+            for (auto block_num = first; block_num <= last; ++block_num) {
+                if (_block_feed_cache.find(block_num) == _block_feed_cache.end()) {
+                    missing.push_back(block_num);
+                }
+            }
+            if (missing.empty()) {
+                return last;
+            }
+            if (!_operation_history_complete) {
+                // the operations of the block are found nowhere
+                return missing.front() - 1;
+            }
+
+            // the block log is only read by the chain thread
+            uint32_t loaded_block = last;
+            auto events = _chain_thread.async([&]() {
+                std::vector<block_event> result;
+                // with deferred plugin indexing the history may lack the operations of the latest blocks
+                const uint32_t indexed_block = _db.with_read_lock([&]() {
+                    return _db.plugin_head_block_num();
+                });
+                for (auto block_num : missing) {
+                    if (block_num > indexed_block) {
+                        loaded_block = block_num - 1;
+                        break;
+                    }
+
+                    auto block = _db.fetch_block_by_number(block_num);
+                    if (!block.valid()) {
+                        continue;
+                    }
+
+                    block_event event;
+                    event.block_num = block_num;
+                    event.block = std::make_shared<protocol::signed_block>(std::move(*block));
+                    _db.with_read_lock([&]() {
+                        const auto &idx = _db.get_index<chain::operation_index>().indices().get<chain::by_location>();
+                        auto itr = idx.lower_bound(block_num);
+                        for (; itr != idx.end() && itr->block == block_num; ++itr) {
+                            event.operations.emplace_back(*itr);
+                        }
+                    });
+                    result.push_back(std::move(event));
+                }
+                return result;
+            }, "load_block_feed_entries").wait();
+
+            for (const auto &event : events) {
+                _block_feed_cache[event.block_num] = make_block_feed_entry(event);
+            }
+            return loaded_block;
+        }
+
+    }
+} // golos::application
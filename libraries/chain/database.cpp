@@ -7,6 +7,7 @@
 #include <golos/chain/database_exceptions.hpp>
 #include <golos/chain/db_with.hpp>
 #include <golos/chain/evaluator_registry.hpp>
+#include <golos/chain/invariant_checker.hpp>
 #include <golos/chain/objects/history_object.hpp>
 #include <golos/chain/objects/market_object.hpp>
 #include <golos/chain/objects/proposal_object.hpp>
@@ -27,6 +28,8 @@
 #include <fc/io/fstream.hpp>
 #include <fc/io/json.hpp>
 
+#include <fc/thread/thread.hpp>
+
 #include <golos/chain/evaluators/account_evaluator.hpp>
 #include <golos/chain/evaluators/market_evaluator.hpp>
 #include <golos/chain/evaluators/asset_evaluator.hpp>
@@ -91,6 +94,8 @@ namespace golos {
         }
 
         database::~database() {
+            stop_invariants_check();
+            stop_plugin_indexing();
             clear_pending();
         }
 
@@ -114,7 +119,8 @@ namespace golos {
         }
 
         void database::open(const fc::path &data_dir, const fc::path &shared_mem_dir, uint64_t initial_supply,
-                            uint64_t shared_file_size, uint32_t chainbase_flags) {
+                            uint64_t shared_file_size, uint32_t chainbase_flags, const fc::path &state_snapshot_dir,
+                            uint32_t state_snapshot_threads) {
             try {
                 init_schema();
                 chainbase::database::open(shared_mem_dir, chainbase_flags, shared_file_size);
@@ -124,9 +130,13 @@ namespace golos {
 
                 if (chainbase_flags & chainbase::database::read_write) {
                     if (!find<dynamic_global_property_object>()) {
-                        with_write_lock([&]() {
-                            init_genesis(initial_supply);
-                        });
+                        if (!state_snapshot_dir.empty()) {
+                            import_state_snapshot(state_snapshot_dir, state_snapshot_threads);
+                        } else {
+                            with_write_lock([&]() {
+                                init_genesis(initial_supply);
+                            });
+                        }
                     }
 
                     _block_log.open(data_dir / "block_log");
@@ -140,6 +150,11 @@ namespace golos {
                                   ("rev", revision())("head_block", head_block_num()));
                     });
 
+                    // the log is removed once the rebuild is done, so plugin indexes of this state are incomplete
+                    FC_ASSERT(_plugin_rebuild_log.empty() || !fc::exists(_plugin_rebuild_log),
+                              "Plugin indexes were not rebuilt after the last reindex. Please reindex blockchain.",
+                              ("log", _plugin_rebuild_log));
+
                     if (head_block_num()) {
                         auto head_block = _block_log.read_block_by_num(head_block_num());
                         // This assertion should be caught and a reindex should occur
@@ -151,10 +166,17 @@ namespace golos {
                 }
 
                 with_read_lock([&]() {
+                    init_core_asset_ids();
                     init_hardforks(); // Writes to local state, but reads from get_database
                 });
 
-            } FC_CAPTURE_LOG_AND_RETHROW((data_dir)(shared_mem_dir)(shared_file_size))
+                if (chainbase_flags & chainbase::database::read_write) {
+                    with_write_lock([&]() {
+                        reset_state_hash();
+                    });
+                }
+
+            } FC_CAPTURE_LOG_AND_RETHROW((data_dir)(shared_mem_dir)(shared_file_size)(state_snapshot_dir))
         }
 
         void database::reindex(const fc::path &data_dir, const fc::path &shared_mem_dir, uint64_t shared_file_size) {
@@ -177,24 +199,55 @@ namespace golos {
                         skip_validate | /// no need to validate operations
                         skip_validate_invariants | skip_block_log;
 
-                with_write_lock([&]() {
-                    auto itr = _block_log.read_block(0);
-                    auto last_block_num = _block_log.head()->block_num();
-
-                    while (itr.first.block_num() != last_block_num) {
-                        auto cur_block_num = itr.first.block_num();
-                        if (cur_block_num % 100000 == 0) {
-                            std::cerr << "   " << double(cur_block_num * 100) / last_block_num << "%   "
-                                      << cur_block_num << " of " << last_block_num << "   ("
-                                      << (get_free_memory() / (1024 * 1024)) << "M free)\n";
+                if (_plugin_rebuild_threads != 0 && !_deferred_apply_operation_handlers.empty()) {
+                    ilog("Plugin indexes will be rebuilt after the replay, collecting operations in ${f}",
+                         ("f", _plugin_rebuild_log));
+                    _plugin_rebuild_stream.reset(new std::ofstream(_plugin_rebuild_log.string(),
+                                                                   std::ios::binary | std::ios::trunc));
+                    FC_ASSERT(_plugin_rebuild_stream->good(), "Unable to create ${f}", ("f", _plugin_rebuild_log));
+                }
+
+                try {
+                    with_write_lock([&]() {
+                        auto itr = _block_log.read_block(0);
+                        auto last_block_num = _block_log.head()->block_num();
+
+                        while (itr.first.block_num() != last_block_num) {
+                            auto cur_block_num = itr.first.block_num();
+                            if (cur_block_num % 100000 == 0) {
+                                std::cerr << "   " << double(cur_block_num * 100) / last_block_num << "%   "
+                                          << cur_block_num << " of " << last_block_num << "   ("
+                                          << (get_free_memory() / (1024 * 1024)) << "M free)\n";
+                            }
+                            apply_block(itr.first, skip_flags);
+                            itr = _block_log.read_block(itr.second);
                         }
+
                         apply_block(itr.first, skip_flags);
-                        itr = _block_log.read_block(itr.second);
-                    }
+                        process_deferred_operations();
+                        set_revision(head_block_num());
 
-                    apply_block(itr.first, skip_flags);
-                    set_revision(head_block_num());
-                });
+                        if (_plugin_rebuild_stream) {
+                            _plugin_rebuild_stream.reset();
+                            ilog("Consensus replay done in ${t} sec, rebuilding plugin indexes",
+                                 ("t", double((fc::time_point::now() - start).count()) / 1000000.0));
+
+                            try {
+                                rebuild_plugin_indexes(_plugin_rebuild_log);
+                            } catch (const fc::exception &e) {
+                                // the log stays, so the next open() fails and asks for a reindex
+                                elog("Plugin index rebuild failed, the plugin indexes are incomplete: ${e}",
+                                     ("e", e.to_detail_string()));
+                                throw;
+                            }
+                            fc::remove(_plugin_rebuild_log);
+                        }
+                    });
+                } catch (...) {
+                    // operations must not be collected after a failed replay
+                    _plugin_rebuild_stream.reset();
+                    throw;
+                }
 
                 if (_block_log.head()->block_num()) {
                     _fork_db.start_block(*_block_log.head());
@@ -209,6 +262,9 @@ namespace golos {
         void database::wipe(const fc::path &data_dir, const fc::path &shared_mem_dir, bool include_blocks) {
             close();
             chainbase::database::wipe(shared_mem_dir);
+            if (!_plugin_rebuild_log.empty()) {
+                fc::remove(_plugin_rebuild_log);
+            }
             if (include_blocks) {
                 fc::remove_all(data_dir / "block_log");
                 fc::remove_all(data_dir / "block_log.index");
@@ -222,6 +278,13 @@ namespace golos {
                 // DB state (issue #336).
                 clear_pending();
 
+                stop_invariants_check();
+                stop_plugin_indexing();
+                process_deferred_operations();
+                _held_pending_tx.clear();
+                _pending_tx_held = false;
+                _state_hash_obj = nullptr;
+
                 chainbase::database::flush();
                 chainbase::database::close();
 
@@ -232,8 +295,21 @@ namespace golos {
         }
 
         asset<0, 17, 0> database::get_balance(account_name_type owner, asset_name_type asset_name) const {
+            asset_object::id_type asset_id;
+            if (asset_name == STEEM_SYMBOL_NAME) {
+                asset_id = _steem_asset_id;
+            } else if (asset_name == SBD_SYMBOL_NAME) {
+                asset_id = _sbd_asset_id;
+            } else {
+                const asset_object *asset_obj = find_asset(asset_name);
+                if (asset_obj == nullptr) {
+                    return protocol::asset<0, 17, 0>(0, asset_name);
+                }
+                asset_id = asset_obj->id;
+            }
+
             auto &index = get_index<account_balance_index>().indices().get<by_account_asset>();
-            auto itr = index.find(boost::make_tuple(owner, asset_name));
+            auto itr = index.find(boost::make_tuple(owner, asset_id));
             if (itr == index.end()) {
                 return protocol::asset<0, 17, 0>(0, asset_name);
             }
@@ -241,7 +317,12 @@ namespace golos {
         }
 
         asset<0, 17, 0> database::get_balance(const account_object &owner, const asset_object &asset_obj) const {
-            return get_balance(owner.name, asset_obj.asset_name);
+            auto &index = get_index<account_balance_index>().indices().get<by_account_asset>();
+            auto itr = index.find(boost::make_tuple(owner.name, asset_obj.id));
+            if (itr == index.end()) {
+                return protocol::asset<0, 17, 0>(0, asset_obj.asset_name);
+            }
+            return itr->get_balance();
         }
 
         bool database::is_authorized_asset(const account_object &acct, const asset_object &asset_obj) const {
@@ -387,6 +468,24 @@ namespace golos {
             return find<asset_object, by_asset_name>(name);
         }
 
+        asset_object::id_type database::get_asset_id(const asset_name_type &name) const {
+            if (name == STEEM_SYMBOL_NAME) {
+                return _steem_asset_id;
+            } else if (name == SBD_SYMBOL_NAME) {
+                return _sbd_asset_id;
+            }
+            return get_asset(name).id;
+        }
+
+        void database::init_core_asset_ids() {
+            const asset_object *steem_asset = find_asset(STEEM_SYMBOL_NAME);
+            const asset_object *sbd_asset = find_asset(SBD_SYMBOL_NAME);
+            if (steem_asset != nullptr && sbd_asset != nullptr) {
+                _steem_asset_id = steem_asset->id;
+                _sbd_asset_id = sbd_asset->id;
+            }
+        }
+
         const asset_dynamic_data_object &database::get_asset_dynamic_data(const asset_name_type &name) const {
             try {
                 return get<asset_dynamic_data_object, by_asset_name>(name);
@@ -421,22 +520,22 @@ namespace golos {
 
         const witness_object &database::get_witness(const account_name_type &name) const {
             try {
-                return get<witness_object, by_name>(name);
+                return get<witness_object, by_hashed_name>(name);
             } FC_CAPTURE_AND_RETHROW((name))
         }
 
         const witness_object *database::find_witness(const account_name_type &name) const {
-            return find<witness_object, by_name>(name);
+            return find<witness_object, by_hashed_name>(name);
         }
 
         const account_object &database::get_account(const account_name_type &name) const {
             try {
-                return get<account_object, by_name>(name);
+                return get<account_object, by_hashed_name>(name);
             } FC_CAPTURE_AND_RETHROW((name))
         }
 
         const account_object *database::find_account(const account_name_type &name) const {
-            return find<account_object, by_name>(name);
+            return find<account_object, by_hashed_name>(name);
         }
 
         const account_statistics_object &database::get_account_statistics(const account_name_type &name) const {
@@ -483,12 +582,23 @@ namespace golos {
 
         const escrow_object &database::get_escrow(const account_name_type &name, uint32_t escrow_id) const {
             try {
-                return get<escrow_object, by_from_id>(boost::make_tuple(name, escrow_id));
+                return get_escrow(get_account(name), escrow_id);
             } FC_CAPTURE_AND_RETHROW((name)(escrow_id))
         }
 
         const escrow_object *database::find_escrow(const account_name_type &name, uint32_t escrow_id) const {
-            return find<escrow_object, by_from_id>(boost::make_tuple(name, escrow_id));
+            const auto *from = find_account(name);
+            return from == nullptr ? nullptr : find_escrow(*from, escrow_id);
+        }
+
+        const escrow_object &database::get_escrow(const account_object &from, uint32_t escrow_id) const {
+            try {
+                return get<escrow_object, by_from_id>(boost::make_tuple(from.id, escrow_id));
+            } FC_CAPTURE_AND_RETHROW((from.name)(escrow_id))
+        }
+
+        const escrow_object *database::find_escrow(const account_object &from, uint32_t escrow_id) const {
+            return find<escrow_object, by_from_id>(boost::make_tuple(from.id, escrow_id));
         }
 
         const limit_order_object &database::get_limit_order(const account_name_type &name,
@@ -514,13 +624,26 @@ namespace golos {
         const savings_withdraw_object &database::get_savings_withdraw(const account_name_type &owner,
                                                                       uint32_t request_id) const {
             try {
-                return get<savings_withdraw_object, by_from_rid>(boost::make_tuple(owner, request_id));
+                return get_savings_withdraw(get_account(owner), request_id);
             } FC_CAPTURE_AND_RETHROW((owner)(request_id))
         }
 
         const savings_withdraw_object *database::find_savings_withdraw(const account_name_type &owner,
                                                                        uint32_t request_id) const {
-            return find<savings_withdraw_object, by_from_rid>(boost::make_tuple(owner, request_id));
+            const auto *from = find_account(owner);
+            return from == nullptr ? nullptr : find_savings_withdraw(*from, request_id);
+        }
+
+        const savings_withdraw_object &database::get_savings_withdraw(const account_object &owner,
+                                                                      uint32_t request_id) const {
+            try {
+                return get<savings_withdraw_object, by_from_rid>(boost::make_tuple(owner.id, request_id));
+            } FC_CAPTURE_AND_RETHROW((owner.name)(request_id))
+        }
+
+        const savings_withdraw_object *database::find_savings_withdraw(const account_object &owner,
+                                                                       uint32_t request_id) const {
+            return find<savings_withdraw_object, by_from_rid>(boost::make_tuple(owner.id, request_id));
         }
 
         const dynamic_global_property_object &database::get_dynamic_global_properties() const {
@@ -706,16 +829,34 @@ namespace golos {
             //fc::time_point begin_time = fc::time_point::now();
 
             bool result;
+            bool index_plugins = false;
             detail::with_skip_flags(*this, skip, [&]() {
                 with_write_lock([&]() {
-                    detail::without_pending_transactions(*this, std::move(_pending_tx), [&]() {
-                        try {
-                            result = _push_block(new_block);
-                        } FC_CAPTURE_AND_RETHROW((new_block))
-                    });
+                    finish_plugin_indexing();
+
+                    // pending transactions are restored by finish_plugin_indexing(), after the blocks are indexed
+                    _held_pending_tx = std::move(_pending_tx);
+                    _pending_tx_held = true;
+                    clear_pending();
+
+                    try {
+                        result = _push_block(new_block);
+                    } catch (...) {
+                        finish_plugin_indexing();
+                        throw;
+                    }
+
+                    index_plugins = !_deferred_blocks.empty();
+                    if (!index_plugins) {
+                        finish_plugin_indexing();
+                    }
                 });
             });
 
+            if (index_plugins) {
+                schedule_plugin_indexing();
+            }
+
             //fc::time_point end_time = fc::time_point::now();
             //fc::microseconds dt = end_time - begin_time;
             //if( ( new_block.block_num() % 10000 ) == 0 )
@@ -763,6 +904,7 @@ namespace golos {
                                 // ilog( "pushing blocks from fork ${n} ${id}", ("n",(*ritr)->data.block_num())("id",(*ritr)->data.id()) );
                                 optional<fc::exception> except;
                                 try {
+                                    process_deferred_operations();
                                     auto session = start_undo_session(true);
                                     apply_block((*ritr)->data, skip);
                                     session.push();
@@ -785,6 +927,7 @@ namespace golos {
 
                                     // restore all blocks from the good fork
                                     for (auto ritr = branches.second.rbegin(); ritr != branches.second.rend(); ++ritr) {
+                                        process_deferred_operations();
                                         auto session = start_undo_session(true);
                                         apply_block((*ritr)->data, skip);
                                         session.push();
@@ -800,6 +943,7 @@ namespace golos {
                 }
 
                 try {
+                    process_deferred_operations();
                     auto session = start_undo_session(true);
                     apply_block(new_block, skip);
                     session.push();
@@ -820,6 +964,7 @@ namespace golos {
                     set_producing(true);
                     detail::with_skip_flags(*this, skip, [&]() {
                         with_write_lock([&]() {
+                            finish_plugin_indexing();
                             _push_transaction(trx);
                         });
                     });
@@ -847,7 +992,6 @@ namespace golos {
             _apply_transaction(trx);
             _pending_tx.push_back(trx);
 
-            notify_changed_objects();
             // The transaction applied successfully. Merge its changes into the pending block session.
             temp_session.squash();
 
@@ -910,6 +1054,7 @@ namespace golos {
                 // the value of the "when" variable is known, which means we need to
                 // re-apply pending transactions in this method.
                 //
+                finish_plugin_indexing();
                 _pending_tx_session.reset();
                 _pending_tx_session = start_undo_session(true);
 
@@ -1009,6 +1154,7 @@ namespace golos {
         void database::pop_block() {
             try {
                 _pending_tx_session.reset();
+                process_deferred_operations();
                 auto head_id = head_block_id();
 
                 /// save the head block so we can recover its transactions
@@ -1037,19 +1183,130 @@ namespace golos {
             note.block = _current_block_num;
             note.trx_in_block = _current_trx_in_block;
             note.op_in_trx = _current_op_in_trx;
+            note.timestamp = head_block_time();
 
             STEEMIT_TRY_NOTIFY(pre_apply_operation, note)
+            notify_operation_handlers(_pre_apply_operation_handlers, note);
+
+            if (_plugin_rebuild_stream) {
+                if (has_deferred_handlers(note.op.which())) {
+                    fc::raw::pack(*_plugin_rebuild_stream, operation_record(note));
+                }
+            } else if (!_deferred_plugin_indexing) {
+                notify_deferred_handlers(note);
+            } else if (_applying_block) {
+                // operations of pending transactions are undone anyway, so they are not indexed
+                if (has_deferred_handlers(note.op.which())) {
+                    _deferred_block_operations.emplace_back(note);
+                }
+            }
+        }
+
+        bool database::has_deferred_handlers(std::size_t tag) const {
+            for (const auto &plugin : _deferred_apply_operation_handlers) {
+                if (tag < plugin.second.size() && !plugin.second[tag].empty()) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void database::notify_deferred_handlers(const operation_notification &note) {
+            for (const auto &plugin : _deferred_apply_operation_handlers) {
+                notify_operation_handlers(plugin.second, note);
+            }
         }
 
         void database::notify_post_apply_operation(const operation_notification &note) {
             STEEMIT_TRY_NOTIFY(post_apply_operation, note)
+            notify_operation_handlers(_post_apply_operation_handlers, note);
+        }
+
+        database::operation_handler_id database::connect_operation_handler(operation_handler_table &table,
+                                                                           const std::vector<std::size_t> &tags,
+                                                                           const operation_handler &handler) {
+            if (table.empty()) {
+                table.resize(operation::count());
+            }
+
+            const auto id = ++_next_operation_handler_id;
+            for (auto tag : tags) {
+                table[tag].push_back({id, handler});
+            }
+
+            _observed_operations.clear();
+            return id;
+        }
+
+        void database::disconnect_operation_handler(operation_handler_id id) {
+            for (auto *table : {&_pre_apply_operation_handlers, &_post_apply_operation_handlers}) {
+                for (auto &handlers : *table) {
+                    handlers.erase(std::remove_if(handlers.begin(), handlers.end(),
+                                                  [&](const tagged_operation_handler &h) {
+                                                      return h.id == id;
+                                                  }), handlers.end());
+                }
+            }
+
+            _observed_operations.clear();
+        }
+
+        void database::notify_operation_handlers(const operation_handler_table &table,
+                                                 const operation_notification &note) {
+            const auto tag = static_cast<std::size_t>(note.op.which());
+            if (tag >= table.size()) {
+                return;
+            }
+
+            for (const auto &entry : table[tag]) {
+                STEEMIT_TRY_NOTIFY(entry.handler, note)
+            }
+        }
+
+        void database::set_virtual_operations_mode(virtual_operations_mode mode) {
+            _virtual_operations_mode = mode;
+        }
+
+        void database::refresh_observed_operations() {
+            // a slot of the generic signals may look at any operation
+            const bool generic = !pre_apply_operation.empty() || !post_apply_operation.empty();
+            _observed_operations.assign(operation::count(), generic);
+
+            if (generic) {
+                return;
+            }
+
+            for (std::size_t tag = 0; tag < _observed_operations.size(); ++tag) {
+                for (const auto *table : {&_pre_apply_operation_handlers, &_post_apply_operation_handlers}) {
+                    if (tag < table->size() && !(*table)[tag].empty()) {
+                        _observed_operations[tag] = true;
+                    }
+                }
+                if (has_deferred_handlers(tag)) {
+                    _observed_operations[tag] = true;
+                }
+            }
+        }
+
+        bool database::is_virtual_operation_observed(int64_t tag) {
+            switch (_virtual_operations_mode) {
+                case virtual_operations_all:
+                    return true;
+                case virtual_operations_none:
+                    return false;
+                default:
+                    break;
+            }
+
+            if (_observed_operations.empty()) {
+                refresh_observed_operations();
+            }
+            return _observed_operations[tag];
         }
 
         inline const void database::push_virtual_operation(const operation &op, bool force) {
-            if (!force) {
-#if defined(STEEMIT_BUILD_LOW_MEMORY) && !defined(STEEMIT_BUILD_TESTNET)
+            if (!force && !is_virtual_operation_observed(op.which())) {
                 return;
-#endif
             }
 
             FC_ASSERT(is_virtual_operation(op));
@@ -1060,6 +1317,39 @@ namespace golos {
 
         void database::notify_applied_block(const signed_block &block) {
             STEEMIT_TRY_NOTIFY(applied_block, block)
+
+            if (_plugin_handler_stats_log_interval != 0 && block.block_num() % _plugin_handler_stats_log_interval == 0) {
+                log_plugin_handler_stats();
+            }
+        }
+
+        plugin_handler_stats &database::plugin_handler_stats_for(const std::string &plugin) {
+            auto &stats = _plugin_handler_stats[plugin];
+            stats.plugin = plugin;
+            return stats;
+        }
+
+        std::vector<plugin_handler_stats> database::get_plugin_handler_stats() const {
+            std::vector<plugin_handler_stats> result;
+            result.reserve(_plugin_handler_stats.size());
+            for (const auto &stats : _plugin_handler_stats) {
+                result.push_back(stats.second);
+            }
+            return result;
+        }
+
+        void database::set_plugin_handler_stats_log_interval(uint32_t interval) {
+            _plugin_handler_stats_log_interval = interval;
+        }
+
+        void database::log_plugin_handler_stats() const {
+            for (const auto &item : _plugin_handler_stats) {
+                const auto &stats = item.second;
+                ilog("Plugin ${p} handlers: ${c} calls, ${t} ms total, ${a} us average, ${m} us max, ${e} exceptions",
+                     ("p", stats.plugin)("c", stats.calls)("t", stats.total_time / 1000)
+                             ("a", stats.calls != 0 ? stats.total_time / stats.calls : 0)
+                             ("m", stats.max_time)("e", stats.exceptions));
+            }
         }
 
         void database::notify_on_pending_transaction(const signed_transaction &tx) {
@@ -1234,9 +1524,9 @@ namespace golos {
 
         void database::adjust_witness_votes(const account_object &a, share_type delta) {
             const auto &vidx = get_index<witness_vote_index>().indices().get<by_account_witness>();
-            auto itr = vidx.lower_bound(boost::make_tuple(a.name, account_name_type()));
-            while (itr != vidx.end() && itr->account == a.name) {
-                adjust_witness_vote(get_witness(itr->witness), delta);
+            auto itr = vidx.lower_bound(a.id);
+            while (itr != vidx.end() && itr->account == a.id) {
+                adjust_witness_vote(get(itr->witness), delta);
                 ++itr;
             }
         }
@@ -1277,22 +1567,29 @@ namespace golos {
                 const auto &current = *itr;
                 ++itr;
 
+                const auto &voter = get(current.account);
+                const auto &witness = get(current.witness);
+
                 if (has_hardfork(STEEMIT_HARDFORK_0_6__104)) { // TODO: this check can be removed after hard fork
-                    modify(get_account(current.account), [&](account_object &acc) {
+                    modify(voter, [&](account_object &acc) {
                         acc.witnesses_voted_for--;
                     });
                 }
 
+                const bool observed = is_virtual_operation_observed<expire_witness_vote_operation<0, 17, 0>>();
+                const auto created = current.created;
                 remove(current);
 
-                push_virtual_operation(expire_witness_vote_operation<0, 17 ,0>(current.account, current.witness, current.created));
+                if (observed) {
+                    push_virtual_operation(expire_witness_vote_operation<0, 17, 0>(voter.name, witness.owner, created));
+                }
             }
         }
 
         void database::clear_witness_votes(const account_object &a) {
             const auto &vidx = get_index<witness_vote_index>().indices().get<by_account_witness>();
-            auto itr = vidx.lower_bound(boost::make_tuple(a.name, account_name_type()));
-            while (itr != vidx.end() && itr->account == a.name) {
+            auto itr = vidx.lower_bound(a.id);
+            while (itr != vidx.end() && itr->account == a.id) {
                 const auto &current = *itr;
                 ++itr;
                 remove(current);
@@ -1455,11 +1752,14 @@ namespace golos {
 
                             adjust_proxied_witness_votes(to_account, to_deposit);
 
-                            push_virtual_operation(
-                                    fill_vesting_withdraw_operation<0, 17, 0>(from_account.name, to_account.name,
-                                                                              asset<0, 17, 0>(to_deposit, VESTS_SYMBOL),
-                                                                              asset<0, 17, 0>(to_deposit,
-                                                                                              VESTS_SYMBOL)));
+                            if (is_virtual_operation_observed<fill_vesting_withdraw_operation<0, 17, 0>>()) {
+                                push_virtual_operation(
+                                        fill_vesting_withdraw_operation<0, 17, 0>(from_account.name, to_account.name,
+                                                                                  asset<0, 17, 0>(to_deposit,
+                                                                                                  VESTS_SYMBOL),
+                                                                                  asset<0, 17, 0>(to_deposit,
+                                                                                                  VESTS_SYMBOL)));
+                            }
                         }
                     }
                 }
@@ -1484,10 +1784,13 @@ namespace golos {
                                 o.total_vesting_shares.amount -= to_deposit;
                             });
 
-                            push_virtual_operation(
-                                    fill_vesting_withdraw_operation<0, 17, 0>(from_account.name, to_account.name,
-                                                                              asset<0, 17, 0>(to_deposit, VESTS_SYMBOL),
-                                                                              converted_steem));
+                            if (is_virtual_operation_observed<fill_vesting_withdraw_operation<0, 17, 0>>()) {
+                                push_virtual_operation(
+                                        fill_vesting_withdraw_operation<0, 17, 0>(from_account.name, to_account.name,
+                                                                                  asset<0, 17, 0>(to_deposit,
+                                                                                                  VESTS_SYMBOL),
+                                                                                  converted_steem));
+                            }
                         }
                     }
                 }
@@ -1520,10 +1823,12 @@ namespace golos {
                     adjust_proxied_witness_votes(from_account, -to_withdraw);
                 }
 
-                push_virtual_operation(fill_vesting_withdraw_operation<0, 17, 0>(from_account.name, from_account.name,
-                                                                                 asset<0, 17, 0>(to_withdraw,
-                                                                                                 VESTS_SYMBOL),
-                                                                                 converted_steem));
+                if (is_virtual_operation_observed<fill_vesting_withdraw_operation<0, 17, 0>>()) {
+                    push_virtual_operation(
+                            fill_vesting_withdraw_operation<0, 17, 0>(from_account.name, from_account.name,
+                                                                      asset<0, 17, 0>(to_withdraw, VESTS_SYMBOL),
+                                                                      converted_steem));
+                }
             }
         }
 
@@ -1561,8 +1866,10 @@ namespace golos {
                             const auto &voter = get(itr->voter);
                             auto reward = create_vesting(voter, asset<0, 17, 0>(claim, STEEM_SYMBOL_NAME));
 
-                            push_virtual_operation(curation_reward_operation<0, 17, 0>(voter.name, reward, c.author,
-                                                                                       to_string(c.permlink)));
+                            if (is_virtual_operation_observed<curation_reward_operation<0, 17, 0>>()) {
+                                push_virtual_operation(curation_reward_operation<0, 17, 0>(voter.name, reward, c.author,
+                                                                                           to_string(c.permlink)));
+                            }
 
 #ifndef STEEMIT_BUILD_LOW_MEMORY
                             modify(voter, [&](account_object &a) {
@@ -1615,10 +1922,12 @@ namespace golos {
                             auto vest_created = create_vesting(get_account(b.account),
                                                                asset<0, 17, 0>(benefactor_tokens, STEEM_SYMBOL_NAME));
 
-                            push_virtual_operation(
-                                    comment_benefactor_reward_operation<0, 17, 0>(b.account, comment.author,
-                                                                                  to_string(comment.permlink),
-                                                                                  vest_created));
+                            if (is_virtual_operation_observed<comment_benefactor_reward_operation<0, 17, 0>>()) {
+                                push_virtual_operation(
+                                        comment_benefactor_reward_operation<0, 17, 0>(b.account, comment.author,
+                                                                                      to_string(comment.permlink),
+                                                                                      vest_created));
+                            }
                             total_beneficiary += benefactor_tokens;
                         }
 
@@ -1637,13 +1946,17 @@ namespace golos {
                                             to_sbd(asset<0, 17, 0>(curation_tokens, STEEM_SYMBOL_NAME)),
                                             to_sbd(asset<0, 17, 0>(total_beneficiary, STEEM_SYMBOL_NAME)));
 
-                        push_virtual_operation(
-                                author_reward_operation<0, 17, 0>(comment.author, to_string(comment.permlink),
-                                                                  sbd_payout.first, sbd_payout.second, vest_created));
-                        push_virtual_operation(
-                                comment_reward_operation<0, 17, 0>(comment.author, to_string(comment.permlink),
-                                                                   to_sbd(asset<0, 17, 0>(claimed_reward,
-                                                                                          STEEM_SYMBOL_NAME))));
+                        if (is_virtual_operation_observed<author_reward_operation<0, 17, 0>>()) {
+                            push_virtual_operation(
+                                    author_reward_operation<0, 17, 0>(comment.author, to_string(comment.permlink),
+                                                                      sbd_payout.first, sbd_payout.second, vest_created));
+                        }
+                        if (is_virtual_operation_observed<comment_reward_operation<0, 17, 0>>()) {
+                            push_virtual_operation(
+                                    comment_reward_operation<0, 17, 0>(comment.author, to_string(comment.permlink),
+                                                                       to_sbd(asset<0, 17, 0>(claimed_reward,
+                                                                                              STEEM_SYMBOL_NAME))));
+                        }
 
 #ifndef STEEMIT_BUILD_LOW_MEMORY
                         modify(comment, [&](comment_object &c) {
@@ -1697,8 +2010,10 @@ namespace golos {
                     c.last_payout = head_block_time();
                 });
 
-                push_virtual_operation(
-                        comment_payout_update_operation<0, 17, 0>(comment.author, to_string(comment.permlink)));
+                if (is_virtual_operation_observed<comment_payout_update_operation<0, 17, 0>>()) {
+                    push_virtual_operation(
+                            comment_payout_update_operation<0, 17, 0>(comment.author, to_string(comment.permlink)));
+                }
 
                 const auto &vote_idx = get_index<comment_vote_index>().indices().get<by_comment_voter>();
                 auto vote_itr = vote_idx.lower_bound(comment.id);
@@ -1921,15 +2236,20 @@ namespace golos {
                 if (itr->complete > head_block_time()) {
                     break;
                 }
-                adjust_balance(get_account(itr->to), itr->amount);
+                const auto &to = get(itr->to);
+                const auto &from = get(itr->from);
 
-                modify(get_account(itr->from), [&](account_object &a) {
+                adjust_balance(to, itr->amount);
+
+                modify(from, [&](account_object &a) {
                     a.savings_withdraw_requests--;
                 });
 
-                push_virtual_operation(
-                        fill_transfer_from_savings_operation<0, 17, 0>(itr->from, itr->to, itr->amount, itr->request_id,
-                                                                       to_string(itr->memo)));
+                if (is_virtual_operation_observed<fill_transfer_from_savings_operation<0, 17, 0>>()) {
+                    push_virtual_operation(
+                            fill_transfer_from_savings_operation<0, 17, 0>(from.name, to.name, itr->amount,
+                                                                           itr->request_id, to_string(itr->memo)));
+                }
 
                 remove(*itr);
                 itr = idx.begin();
@@ -2084,7 +2404,9 @@ namespace golos {
                         obj.weight = 0;
                     });
 
-                    push_virtual_operation(liquidity_reward_operation<0, 17, 0>(get(itr->owner).name, reward));
+                    if (is_virtual_operation_observed<liquidity_reward_operation<0, 17, 0>>()) {
+                        push_virtual_operation(liquidity_reward_operation<0, 17, 0>(get(itr->owner).name, reward));
+                    }
                 }
             }
         }
@@ -2144,8 +2466,10 @@ namespace golos {
                 net_sbd += itr->amount;
                 net_steem += amount_to_issue;
 
-                push_virtual_operation(fill_convert_request_operation<0, 17, 0>(user.name, itr->request_id, itr->amount,
-                                                                                amount_to_issue));
+                if (is_virtual_operation_observed<fill_convert_request_operation<0, 17, 0>>()) {
+                    push_virtual_operation(fill_convert_request_operation<0, 17, 0>(user.name, itr->request_id,
+                                                                                    itr->amount, amount_to_issue));
+                }
 
                 remove(*itr);
                 itr = request_by_date.begin();
@@ -2220,7 +2544,7 @@ namespace golos {
                 const auto &old_escrow = *escrow_itr;
                 ++escrow_itr;
 
-                const auto &from_account = get_account(old_escrow.from);
+                const auto &from_account = get(old_escrow.from);
                 adjust_balance(from_account, old_escrow.steem_balance);
                 adjust_balance(from_account, old_escrow.sbd_balance);
                 adjust_balance(from_account, old_escrow.pending_fee);
@@ -2386,52 +2710,58 @@ namespace golos {
         }
 
         void database::initialize_indexes() {
-            add_index<asset_index>();
-            add_index<asset_bitasset_data_index>();
-            add_index<asset_dynamic_data_index>();
-            add_index<account_balance_index>();
-            add_index<account_statistics_index>();
-            add_index<call_order_index>();
-            add_index<force_settlement_index>();
+            _index_infos.clear();
+
+            add_core_index<asset_index>();
+            add_core_index<asset_bitasset_data_index>();
+            add_core_index<asset_dynamic_data_index>();
+            add_core_index<account_balance_index>();
+            add_core_index<account_statistics_index>();
+            add_core_index<call_order_index>();
+            add_core_index<force_settlement_index>();
 
-            add_index<dynamic_global_property_index>();
+            add_core_index<dynamic_global_property_index>();
 
-            add_index<account_index>();
-            add_index<account_authority_index>();
+            add_core_index<account_index>();
+            add_core_index<account_authority_index>();
 
             //            add_index<account_index>()->add_secondary_index<account_referrer_index>();
             //            add_index<account_authority_index>()->add_secondary_index<account_member_index>();
 
-            add_index<account_bandwidth_index>();
-            add_index<witness_index>();
-            add_index<transaction_index>();
-            add_index<block_summary_index>();
-            add_index<witness_schedule_index>();
-            add_index<comment_index>();
-            add_index<comment_vote_index>();
-            add_index<witness_vote_index>();
-            add_index<limit_order_index>();
-            add_index<feed_history_index>();
-            add_index<convert_request_index>();
-            add_index<liquidity_reward_balance_index>();
-            add_index<operation_index>();
-            add_index<account_history_index>();
-            add_index<category_index>();
-            add_index<hardfork_property_index>();
-            add_index<withdraw_vesting_route_index>();
-            add_index<owner_authority_history_index>();
-            add_index<account_recovery_request_index>();
-            add_index<change_recovery_account_request_index>();
-            add_index<escrow_index>();
-            add_index<savings_withdraw_index>();
-            add_index<decline_voting_rights_request_index>();
-            add_index<vesting_delegation_index>();
-            add_index<vesting_delegation_expiration_index>();
-            add_index<reward_fund_index>();
+            add_core_index<account_bandwidth_index>();
+            add_core_index<witness_index>();
+            add_core_index<transaction_index>();
+            add_core_index<block_summary_index>();
+            add_core_index<witness_schedule_index>();
+            add_core_index<comment_index>();
+            add_core_index<comment_vote_index>();
+            add_core_index<witness_vote_index>();
+            add_core_index<limit_order_index>();
+            add_core_index<feed_history_index>();
+            add_core_index<convert_request_index>();
+            add_core_index<liquidity_reward_balance_index>();
+            add_core_index<operation_index>();
+            add_core_index<account_history_index>();
+            add_core_index<category_index>();
+            add_core_index<hardfork_property_index>();
+            add_core_index<withdraw_vesting_route_index>();
+            add_core_index<owner_authority_history_index>();
+            add_core_index<account_recovery_request_index>();
+            add_core_index<change_recovery_account_request_index>();
+            add_core_index<escrow_index>();
+            add_core_index<savings_withdraw_index>();
+            add_core_index<decline_voting_rights_request_index>();
+            add_core_index<vesting_delegation_index>();
+            add_core_index<vesting_delegation_expiration_index>();
+            add_core_index<reward_fund_index>();
             //            add_index<proposal_index>()->add_secondary_index<required_approval_index>();
-            add_index<proposal_index>();
+            add_core_index<proposal_index>();
 
-            add_index<collateral_bid_index>();
+            add_core_index<collateral_bid_index>();
+
+            // not a part of the state itself, so they have no index_info
+            add_index<state_hash_index>();
+            add_index<next_id_index>();
 
             _plugin_index_signal();
         }
@@ -2584,6 +2914,8 @@ namespace golos {
                     a.current_supply = 0;
                 });
 
+                init_core_asset_ids();
+
                 for (int i = 0; i < STEEMIT_NUM_INIT_MINERS; ++i) {
                     const account_object &account = create<account_object>([&](account_object &a) {
                         a.name = STEEMIT_INIT_MINER_NAME + (i ? fc::to_string(i) : std::string());
@@ -2648,30 +2980,79 @@ namespace golos {
             });
         }
 
-        void database::notify_changed_objects() {
-            try {
-                /*vector< golos::chainbase::generic_id > ids;
-        get_changed_ids( ids );
-        STEEMIT_TRY_NOTIFY( changed_objects, ids )*/
-                /*
-        if( _undo_db.enabled() )
-        {
-         const auto& head_undo = _undo_db.head();
-         vector<object_id_type> changed_ids;  changed_ids.reserve(head_undo.old_values.size());
-         for( const auto& item : head_undo.old_values ) changed_ids.push_back(item.first);
-         for( const auto& item : head_undo.new_ids ) changed_ids.push_back(item);
-         vector<const object*> removed;
-         removed.reserve( head_undo.removed.size() );
-         for( const auto& item : head_undo.removed )
-         {
-            changed_ids.push_back( item.first );
-            removed.emplace_back( item.second.get() );
-         }
-         STEEMIT_TRY_NOTIFY( changed_objects, changed_ids )
+        void database::set_state_hash(bool enabled, uint32_t log_interval) {
+            _state_hash_enabled = enabled;
+            _state_hash_log_interval = log_interval;
+        }
+
+        uint64_t database::get_state_hash() const {
+            FC_ASSERT(_state_hash_obj != nullptr, "State hash is disabled");
+            return _state_hash_obj->hash;
+        }
+
+        optional<uint64_t> database::get_state_hash(uint32_t block_num) const {
+            optional<uint64_t> result;
+            auto itr = _state_hash_history.find(block_num);
+            if (itr != _state_hash_history.end() && block_num <= head_block_num()) {
+                result = itr->second;
+            }
+            return result;
+        }
+
+        uint64_t database::calculate_state_hash() const {
+            uint64_t hash = 0;
+            for (const auto &info : _index_infos) {
+                hash ^= info->hash_objects();
+            }
+            return hash;
         }
-        */
-            } FC_CAPTURE_AND_RETHROW()
 
+        void database::update_state_hash(uint64_t delta) {
+            chainbase::database::modify(*_state_hash_obj, [&](state_hash_object &o) {
+                o.hash ^= delta;
+            });
+        }
+
+        void database::reset_state_hash() {
+            _state_hash_obj = nullptr;
+            _state_hash_history.clear();
+
+            if (!_state_hash_enabled) {
+                return;
+            }
+
+            auto start = fc::time_point::now();
+            uint64_t hash = calculate_state_hash();
+
+            const auto *obj = find<state_hash_object>();
+            if (obj == nullptr) {
+                obj = &chainbase::database::create<state_hash_object>([&](state_hash_object &o) {
+                    o.hash = hash;
+                });
+            } else {
+                chainbase::database::modify(*obj, [&](state_hash_object &o) {
+                    o.hash = hash;
+                });
+            }
+            _state_hash_obj = obj;
+
+            auto end = fc::time_point::now();
+            ilog("State hash at block ${b} is ${h}, calculated in ${t} sec",
+                 ("b", head_block_num())("h", hash)("t", double((end - start).count()) / 1000000.0));
+        }
+
+        std::vector<index_memory_usage> database::get_memory_usage() const {
+            std::vector<index_memory_usage> result;
+            result.reserve(_index_infos.size());
+
+            for (const auto &info : _index_infos) {
+                result.push_back(info->memory_usage());
+            }
+
+            std::sort(result.begin(), result.end(), [](const index_memory_usage &a, const index_memory_usage &b) {
+                return a.total_bytes > b.total_bytes;
+            });
+            return result;
         }
 
         void database::set_flush_interval(uint32_t flush_blocks) {
@@ -2702,9 +3083,25 @@ namespace golos {
                     }
                 }
 
-                detail::with_skip_flags(*this, skip, [&]() {
-                    _apply_block(next_block);
-                });
+                // no-op unless called without an undo session, e.g. by reindex()
+                process_deferred_operations();
+
+                _deferred_block_operations.clear();
+                _applying_block = true;
+                try {
+                    detail::with_skip_flags(*this, skip, [&]() {
+                        _apply_block(next_block);
+                    });
+                } catch (...) {
+                    _applying_block = false;
+                    throw;
+                }
+                _applying_block = false;
+
+                if (_deferred_plugin_indexing) {
+                    _deferred_blocks.push_back({block_num, std::move(_deferred_block_operations)});
+                    _deferred_block_operations.clear();
+                }
 
                 /*try
         {
@@ -2714,6 +3111,11 @@ namespace golos {
         }
         FC_CAPTURE_AND_RETHROW( (next_block) );*/
 
+                if (_invariants_check_interval != 0 && !(skip & skip_validate_invariants) &&
+                    block_num % _invariants_check_interval == 0) {
+                    schedule_invariants_check(block_num);
+                }
+
                 //fc::time_point end_time = fc::time_point::now();
                 //fc::microseconds dt = end_time - begin_time;
                 if (_flush_blocks != 0) {
@@ -2751,6 +3153,9 @@ namespace golos {
         void database::_apply_block(const signed_block &next_block) {
             try {
                 uint32_t next_block_num = next_block.block_num();
+
+                // slots of the generic operation signals may be connected at any time
+                _observed_operations.clear();
                 //block_id_type next_block_id = next_block.id();
 
                 uint32_t skip = get_node_properties().skip_flags;
@@ -2855,7 +3260,16 @@ namespace golos {
                 // notify observers that the block has been applied
                 notify_applied_block(next_block);
 
-                notify_changed_objects();
+                if (_state_hash_obj != nullptr) {
+                    _state_hash_history[next_block_num] = _state_hash_obj->hash;
+                    if (_state_hash_history.size() > STEEMIT_MAX_UNDO_HISTORY) {
+                        _state_hash_history.erase(_state_hash_history.begin());
+                    }
+
+                    if (_state_hash_log_interval != 0 && next_block_num % _state_hash_log_interval == 0) {
+                        ilog("State hash at block ${b} is ${h}", ("b", next_block_num)("h", _state_hash_obj->hash));
+                    }
+                }
             } //FC_CAPTURE_AND_RETHROW( (next_block.block_num()) )  }
             FC_CAPTURE_LOG_AND_RETHROW((next_block.block_num()))
         }
@@ -3155,7 +3569,9 @@ namespace golos {
                                 if (has_hardfork(STEEMIT_HARDFORK_0_14__278)) {
                                     if (head_block_num() - w.last_confirmed_block_num > STEEMIT_BLOCKS_PER_DAY) {
                                         w.signing_key = public_key_type();
-                                        push_virtual_operation(shutdown_witness_operation<0, 17, 0>(w.owner));
+                                        if (is_virtual_operation_observed<shutdown_witness_operation<0, 17, 0>>()) {
+                                            push_virtual_operation(shutdown_witness_operation<0, 17, 0>(w.owner));
+                                        }
                                     }
                                 }
                             });
@@ -3489,9 +3905,11 @@ namespace golos {
                 }
             }
 
-            push_virtual_operation(fill_order_operation<0, 17, 0>(new_order.seller, new_order.order_id, new_order_pays,
-                                                                  old_order.seller, old_order.order_id,
-                                                                  old_order_pays));
+            if (is_virtual_operation_observed<fill_order_operation<0, 17, 0>>()) {
+                push_virtual_operation(fill_order_operation<0, 17, 0>(new_order.seller, new_order.order_id,
+                                                                      new_order_pays, old_order.seller,
+                                                                      old_order.order_id, old_order_pays));
+            }
 
             int result = 0;
             result |= fill_order(new_order, new_order_pays, new_order_receives);
@@ -3547,7 +3965,7 @@ namespace golos {
                 const asset_object &recv_asset = get_asset(receives.symbol);
 
                 auto issuer_fees = pay_market_fees(recv_asset, receives);
-                pay_order(seller, receives - issuer_fees, pays);
+                pay_order(seller, receives - issuer_fees, pays, recv_asset);
 
                 if (pays == order.amount_for_sale()) {
                     remove(order);
@@ -3620,9 +4038,11 @@ namespace golos {
                 }
 
                 assert(pays.symbol != receives.symbol);
-                push_virtual_operation(
-                        fill_call_order_operation<0, 17, 0>(order.order_id, order.borrower, pays, receives,
-                                                            asset<0, 17, 0>(0, pays.symbol)));
+                if (is_virtual_operation_observed<fill_call_order_operation<0, 17, 0>>()) {
+                    push_virtual_operation(
+                            fill_call_order_operation<0, 17, 0>(order.order_id, order.borrower, pays, receives,
+                                                                asset<0, 17, 0>(0, pays.symbol)));
+                }
 
 
                 if (collateral_freed) {
@@ -3638,7 +4058,8 @@ namespace golos {
             try {
                 bool filled = false;
 
-                auto issuer_fees = pay_market_fees(get_asset(receives.symbol), receives);
+                const asset_object &recv_asset = get_asset(receives.symbol);
+                auto issuer_fees = pay_market_fees(recv_asset, receives);
 
                 if (pays < settle.balance) {
                     modify(settle, [&pays](force_settlement_object &s) {
@@ -3648,12 +4069,14 @@ namespace golos {
                 } else {
                     filled = true;
                 }
-                adjust_balance(get_account(settle.owner), receives - issuer_fees);
+                adjust_balance(get_account(settle.owner), receives - issuer_fees, recv_asset);
 
                 FC_ASSERT(pays.symbol != receives.symbol);
-                push_virtual_operation(
-                        fill_settlement_order_operation<0, 17, 0>(settle.settlement_id, settle.owner, pays, receives,
-                                                                  issuer_fees));
+                if (is_virtual_operation_observed<fill_settlement_order_operation<0, 17, 0>>()) {
+                    push_virtual_operation(
+                            fill_settlement_order_operation<0, 17, 0>(settle.settlement_id, settle.owner, pays,
+                                                                      receives, issuer_fees));
+                }
 
                 if (filled) {
                     remove(settle);
@@ -3773,11 +4196,13 @@ namespace golos {
 
                     auto old_limit_itr = filled_limit ? limit_itr++ : limit_itr;
                     fill_order(*old_limit_itr, order_pays, order_receives);
-                    push_virtual_operation(fill_order_operation<0, 17, 0>(limit_itr->seller, limit_itr->order_id,
-                                                                          limit_itr->amount_for_sale(),
-                                                                          old_limit_itr->seller,
-                                                                          old_limit_itr->order_id,
-                                                                          old_limit_itr->amount_for_sale()));
+                    if (is_virtual_operation_observed<fill_order_operation<0, 17, 0>>()) {
+                        push_virtual_operation(fill_order_operation<0, 17, 0>(limit_itr->seller, limit_itr->order_id,
+                                                                              limit_itr->amount_for_sale(),
+                                                                              old_limit_itr->seller,
+                                                                              old_limit_itr->order_id,
+                                                                              old_limit_itr->amount_for_sale()));
+                    }
                 } // whlie call_itr != call_end
 
                 return margin_called;
@@ -3839,13 +4264,13 @@ namespace golos {
         }
 
         void database::pay_order(const account_object &receiver, const asset<0, 17, 0> &receives,
-                                 const asset<0, 17, 0> &pays) {
+                                 const asset<0, 17, 0> &pays, const asset_object &receive_asset) {
             modify(get_account_statistics(receiver.name), [&](account_statistics_object &b) {
                 if (pays.symbol == STEEM_SYMBOL_NAME) {
                     b.total_core_in_orders -= pays.amount;
                 }
             });
-            adjust_balance(receiver, receives);
+            adjust_balance(receiver, receives, receive_asset);
         }
 
         asset<0, 17, 0> database::calculate_market_fee(const asset_object &trade_asset,
@@ -3899,7 +4324,7 @@ namespace golos {
                 adjust_balance(get_account(order.seller), refunded);
                 adjust_balance(get_account(order.seller), order.deferred_fee);
 
-                if (create_virtual_op) {
+                if (create_virtual_op && is_virtual_operation_observed<limit_order_cancel_operation<0, 17, 0>>()) {
                     limit_order_cancel_operation<0, 17, 0> vop;
                     vop.order_id = order.order_id;
                     vop.owner = order.seller;
@@ -3916,7 +4341,7 @@ namespace golos {
         void database::cancel_order(const force_settlement_object &order, bool create_virtual_op) {
             adjust_balance(get_account(order.owner), order.balance);
 
-            if (create_virtual_op) {
+            if (create_virtual_op && is_virtual_operation_observed<asset_settle_cancel_operation<0, 17, 0>>()) {
                 asset_settle_cancel_operation<0, 17, 0> vop;
                 vop.settlement = order.settlement_id;
                 vop.account = order.owner;
@@ -4053,8 +4478,10 @@ namespace golos {
                     a.delegated_vesting_shares -= itr->vesting_shares;
                 });
 
-                push_virtual_operation(
-                        return_vesting_delegation_operation<0, 17, 0>(itr->delegator, itr->vesting_shares));
+                if (is_virtual_operation_observed<return_vesting_delegation_operation<0, 17, 0>>()) {
+                    push_virtual_operation(
+                            return_vesting_delegation_operation<0, 17, 0>(itr->delegator, itr->vesting_shares));
+                }
 
                 remove(*itr);
                 itr = delegations_by_exp.begin();
@@ -4218,13 +4645,24 @@ namespace golos {
         }
 
         void database::adjust_balance(const account_object &a, const asset<0, 17, 0> &delta) {
+            _adjust_balance(a, delta, get_asset_id(delta.symbol));
+        }
+
+        void database::adjust_balance(const account_object &a, const asset<0, 17, 0> &delta,
+                                      const asset_object &asset_obj) {
+            assert(asset_obj.asset_name == delta.symbol);
+            _adjust_balance(a, delta, asset_obj.id);
+        }
+
+        void database::_adjust_balance(const account_object &a, const asset<0, 17, 0> &delta,
+                                       asset_object::id_type asset_id) {
             try {
                 if (delta.amount == 0) {
                     return;
                 }
 
                 auto &index = get_index<account_balance_index>().indices().get<by_account_asset>();
-                auto itr = index.find(boost::make_tuple(a.name, delta.symbol));
+                auto itr = index.find(boost::make_tuple(a.name, asset_id));
                 if (itr == index.end()) {
                     FC_ASSERT(delta.amount > 0,
                               "Insufficient Balance: ${a}'s balance of ${b} is less than required ${r}",
@@ -4234,6 +4672,7 @@ namespace golos {
                     create<account_balance_object>([&](account_balance_object &b) {
                         b.owner = a.name;
                         b.asset_name = delta.symbol;
+                        b.asset_id = asset_id;
 
                         if (delta.symbol == SBD_SYMBOL_NAME) {
                             adjust_sbd_balance(a, b);
@@ -4296,7 +4735,9 @@ namespace golos {
                         acnt.sbd_seconds = 0;
                         acnt.sbd_last_interest_payment = head_block_time();
 
-                        push_virtual_operation(interest_operation<0, 17, 0>(a.name, interest_paid));
+                        if (is_virtual_operation_observed<interest_operation<0, 17, 0>>()) {
+                            push_virtual_operation(interest_operation<0, 17, 0>(a.name, interest_paid));
+                        }
 
                         modify(get_dynamic_global_properties(), [&](dynamic_global_property_object &props) {
                             props.current_sbd_supply += interest_paid;
@@ -4334,7 +4775,9 @@ namespace golos {
                             acnt.savings_sbd_seconds = 0;
                             acnt.savings_sbd_last_interest_payment = head_block_time();
 
-                            push_virtual_operation(interest_operation<0, 17, 0>(a.name, interest_paid));
+                            if (is_virtual_operation_observed<interest_operation<0, 17, 0>>()) {
+                                push_virtual_operation(interest_operation<0, 17, 0>(a.name, interest_paid));
+                            }
 
                             modify(get_dynamic_global_properties(), [&](dynamic_global_property_object &props) {
                                 props.current_sbd_supply += interest_paid;
@@ -4382,7 +4825,7 @@ namespace golos {
         asset<0, 17, 0> database::get_balance(const account_object &a, const asset_name_type &asset_name) const {
             try {
                 const account_balance_object &b = get<account_balance_object, by_account_asset>(
-                        boost::make_tuple(a.name, asset_name));
+                        boost::make_tuple(a.name, get_asset_id(asset_name)));
                 return {b.balance, b.asset_name};
             } FC_CAPTURE_AND_RETHROW((asset_name))
         }
@@ -4802,120 +5245,251 @@ namespace golos {
          */
         void database::validate_invariants() const {
             try {
-                const auto &account_idx = get_index<account_index>().indices().get<by_name>();
-                asset<0, 17, 0> total_supply(0, STEEM_SYMBOL_NAME);
-                asset<0, 17, 0> total_sbd(0, SBD_SYMBOL_NAME);
-                asset<0, 17, 0> total_vesting(0, VESTS_SYMBOL);
-                share_type total_vsf_votes = share_type(0);
-
-                auto gpo = get_dynamic_global_properties();
-
-                /// verify no witness has too many votes
-                const auto &witness_idx = get_index<witness_index>().indices();
-                for (auto itr = witness_idx.begin(); itr != witness_idx.end(); ++itr) {
-                    FC_ASSERT(itr->votes < gpo.total_vesting_shares.amount, "", ("itr", *itr));
-                }
-
-                for (const auto &itr : account_idx) {
-                    total_supply += get_balance(itr.name, STEEM_SYMBOL_NAME);
-                    total_supply += itr.savings_balance;
-                    total_sbd += get_balance(itr.name, SBD_SYMBOL_NAME);
-                    total_sbd += itr.savings_sbd_balance;
-                    total_vesting += itr.vesting_shares;
-                    total_vsf_votes += (itr.proxy == STEEMIT_PROXY_TO_SELF_ACCOUNT ? itr.witness_vote_weight() : (
-                            STEEMIT_MAX_PROXY_RECURSION_DEPTH > 0 ? itr.proxied_vsf_votes[
-                                    STEEMIT_MAX_PROXY_RECURSION_DEPTH - 1] : itr.vesting_shares.amount));
-                }
-
-                const auto &convert_request_idx = get_index<convert_request_index>().indices();
-
-                for (const auto &itr : convert_request_idx) {
-                    if (itr.amount.symbol == STEEM_SYMBOL_NAME) {
-                        total_supply += itr.amount;
-                    } else if (itr.amount.symbol == SBD_SYMBOL_NAME) {
-                        total_sbd += itr.amount;
-                    } else {
-                        FC_ASSERT(false, "Encountered illegal symbol in convert_request_object");
-                    }
-                }
+                invariant_checker(*this).step();
+            } FC_CAPTURE_LOG_AND_RETHROW((head_block_num()));
+        }
+
+        void database::set_background_invariants_check(uint32_t interval, uint32_t chunk_size) {
+            _invariants_check_interval = interval;
+            _invariants_check_chunk_size = chunk_size;
+        }
+
+        void database::schedule_invariants_check(uint32_t block_num) {
+            if (_invariants_check_result.valid() && !_invariants_check_result.ready()) {
+                wlog("Skipping invariants check at block ${b}, the previous check is still running", ("b", block_num));
+                return;
+            }
+
+            if (!_invariants_check_thread) {
+                _invariants_check_thread = std::make_shared<fc::thread>("invariants");
+            }
+
+            _invariants_check_result = _invariants_check_thread->async([this, block_num]() {
+                check_invariants_in_background(block_num);
+            }, "validate_invariants");
+        }
 
-                const auto &limit_order_idx = get_index<limit_order_index>().indices();
+        void database::check_invariants_in_background(uint32_t block_num) {
+            // chunked walks are restarted when a block lands in between or they are inconclusive,
+            // this many restarts fall back to a walk under one read lock, and this many inconclusive
+            // walks fail the check
+            static const uint32_t max_chunked_attempts = 3;
 
-                for (const auto &itr : limit_order_idx) {
-                    if (itr.sell_price.base.symbol == STEEM_SYMBOL_NAME) {
-                        total_supply += asset<0, 17, 0>(itr.for_sale, STEEM_SYMBOL_NAME);
-                    } else if (itr.sell_price.base.symbol == SBD_SYMBOL_NAME) {
-                        total_sbd += asset<0, 17, 0>(itr.for_sale, SBD_SYMBOL_NAME);
+            auto start = fc::time_point::now();
+            uint32_t inconclusive_walks = 0;
+            try {
+                for (uint32_t attempt = 0;; ++attempt) {
+                    invariant_checker checker(*this, attempt < max_chunked_attempts ? _invariants_check_chunk_size : 0);
+
+                    bool first = true;
+                    bool restart = false;
+                    bool inconclusive = false;
+                    block_id_type head_id;
+                    uint64_t change_count = 0;
+
+                    while (!restart && !inconclusive && !checker.done()) {
+                        if (_invariants_check_stop) {
+                            return;
+                        }
+
+                        with_read_lock([&]() {
+                            if (first) {
+                                block_num = head_block_num();
+                                head_id = head_block_id();
+                                change_count = _state_change_count;
+                                first = false;
+                            } else if (head_id != head_block_id()) {
+                                restart = true;
+                                return;
+                            }
+
+                            // pending transactions applied between the chunks could have moved funds
+                            // between visited and unvisited objects, so neither a violation nor a pass is conclusive
+                            try {
+                                inconclusive = checker.step() && change_count != _state_change_count;
+                            } catch (const fc::exception &) {
+                                if (change_count == _state_change_count) {
+                                    throw;
+                                }
+                                inconclusive = true;
+                            }
+                        });
+                    }
+
+                    if (!restart && !inconclusive) {
+                        break;
+                    }
+                    if (inconclusive && ++inconclusive_walks >= max_chunked_attempts) {
+                        elog("Invariants check failed at block ${b}: pending transactions changed the state "
+                             "during ${n} walks, the result is inconclusive", ("b", block_num)("n", inconclusive_walks));
+                        return;
                     }
+                    dlog("State changed during invariants check at block ${b}, restarting", ("b", block_num));
                 }
 
-                const auto &escrow_idx = get_index<escrow_index>().indices().get<by_id>();
+                auto end = fc::time_point::now();
+                dlog("Invariants are valid at block ${b}, checked in ${t} sec",
+                     ("b", block_num)("t", double((end - start).count()) / 1000000.0));
+            } catch (const fc::exception &e) {
+                elog("Invariants check failed at block ${b}: ${e}", ("b", block_num)("e", e.to_detail_string()));
+            } catch (const std::exception &e) {
+                wlog("Unable to check invariants at block ${b}: ${e}", ("b", block_num)("e", e.what()));
+            }
+        }
+
+        void database::stop_invariants_check() {
+            if (!_invariants_check_thread) {
+                return;
+            }
 
-                for (const auto &itr : escrow_idx) {
-                    total_supply += itr.steem_balance;
-                    total_sbd += itr.sbd_balance;
+            _invariants_check_stop = true;
+            if (_invariants_check_result.valid()) {
+                _invariants_check_result.wait();
+            }
+            _invariants_check_thread->quit();
+            _invariants_check_thread.reset();
+            _invariants_check_result = fc::future<void>();
+            _invariants_check_stop = false;
+        }
 
-                    if (itr.pending_fee.symbol == STEEM_SYMBOL_NAME) {
-                        total_supply += itr.pending_fee;
-                    } else if (itr.pending_fee.symbol == SBD_SYMBOL_NAME) {
-                        total_sbd += itr.pending_fee;
-                    } else {
-                        FC_ASSERT(false, "found escrow pending fee that is not SBD or STEEM");
-                    }
+        void database::set_deferred_plugin_indexing(bool enabled) {
+            _deferred_plugin_indexing = enabled;
+        }
+
+        uint32_t database::plugin_head_block_num() const {
+            return _deferred_blocks.empty() ? head_block_num() : _deferred_blocks.front().block_num - 1;
+        }
+
+        void database::process_deferred_operations() {
+            while (!_deferred_blocks.empty()) {
+                const deferred_block block = std::move(_deferred_blocks.front());
+                _deferred_blocks.pop_front();
+
+                for (const auto &record : block.operations) {
+                    notify_deferred_handlers(record.notification());
                 }
+            }
+        }
+
+        void database::set_plugin_rebuild_after_reindex(const fc::path &operation_log, uint32_t threads) {
+            _plugin_rebuild_log = operation_log;
+            _plugin_rebuild_threads = threads;
+        }
 
-                const auto &savings_withdraw_idx = get_index<savings_withdraw_index>().indices().get<by_id>();
+        void database::rebuild_plugin_indexes(const fc::path &operation_log) {
+            std::vector<std::string> plugins;
+            for (const auto &plugin : _deferred_apply_operation_handlers) {
+                plugins.push_back(plugin.first);
+            }
 
-                for (const auto &itr : savings_withdraw_idx) {
-                    if (itr.amount.symbol == STEEM_SYMBOL_NAME) {
-                        total_supply += itr.amount;
-                    } else if (itr.amount.symbol == SBD_SYMBOL_NAME) {
-                        total_sbd += itr.amount;
-                    } else {
-                        FC_ASSERT(false, "found savings withdraw that is not SBD or STEEM");
+            // plugins write to their own indexes only, but the state checksum is shared by all objects
+            uint32_t thread_count = std::min<uint32_t>(_plugin_rebuild_threads, plugins.size());
+            if (_state_hash_obj != nullptr) {
+                thread_count = 1;
+            }
+
+            std::atomic<std::size_t> next_plugin{0};
+            std::atomic<bool> failed{false};
+            auto rebuild = [&]() {
+                for (std::size_t i = next_plugin++; i < plugins.size() && !failed; i = next_plugin++) {
+                    const auto &table = _deferred_apply_operation_handlers.at(plugins[i]);
+                    const auto start = fc::time_point::now();
+                    uint64_t count = 0;
+
+                    std::ifstream in(operation_log.string(), std::ios::binary);
+                    FC_ASSERT(in.good(), "Unable to open ${f}", ("f", operation_log));
+
+                    operation_record record;
+                    while (in.peek() != std::ifstream::traits_type::eof()) {
+                        fc::raw::unpack(in, record);
+
+                        const auto tag = static_cast<std::size_t>(record.op.which());
+                        if (tag < table.size() && !table[tag].empty()) {
+                            notify_operation_handlers(table, record.notification());
+                            ++count;
+                        }
                     }
+
+                    ilog("Rebuilt ${p} plugin indexes from ${c} operations in ${t} sec",
+                         ("p", plugins[i])("c", count)
+                                 ("t", double((fc::time_point::now() - start).count()) / 1000000.0));
                 }
+            };
 
-                fc::uint128_t total_rshares2;
-                fc::uint128_t total_children_rshares2;
+            // a failed plugin stops the others from starting, but the running ones are waited for
+            std::vector<optional<fc::exception>> errors(std::max<uint32_t>(thread_count, 1));
+            auto run = [&](optional<fc::exception> &error) {
+                try {
+                    rebuild();
+                } catch (const fc::exception &e) {
+                    failed = true;
+                    error = e;
+                } catch (const std::exception &e) {
+                    failed = true;
+                    error = fc::std_exception_wrapper::from_current_exception(e);
+                }
+            };
+
+            std::vector<std::shared_ptr<fc::thread>> threads;
+            std::vector<fc::future<void>> results;
+            for (uint32_t i = 1; i < thread_count; ++i) {
+                threads.push_back(std::make_shared<fc::thread>("plugin_rebuild"));
+                results.push_back(threads.back()->async([&, i]() {
+                    run(errors[i]);
+                }, "plugin_rebuild"));
+            }
 
-                const auto &comment_idx = get_index<comment_index>().indices();
+            run(errors[0]);
 
-                for (const auto &itr : comment_idx) {
-                    if (itr.net_rshares.value > 0) {
-                        auto delta = utilities::calculate_claims(itr.net_rshares.value);
-                        total_rshares2 += delta;
-                    }
-                    if (itr.parent_author == STEEMIT_ROOT_POST_PARENT) {
-                        total_children_rshares2 += itr.children_rshares2;
-                    }
+            for (auto &result : results) {
+                result.wait();
+            }
+            for (auto &thread : threads) {
+                thread->quit();
+            }
+
+            for (const auto &error : errors) {
+                if (error) {
+                    throw *error;
                 }
+            }
+        }
 
-                const auto &reward_idx = get_index<reward_fund_index, by_id>();
+        void database::schedule_plugin_indexing() {
+            // a running task picks up the queued blocks, the rest is indexed before the next block
+            if (_plugin_indexing_result.valid() && !_plugin_indexing_result.ready()) {
+                return;
+            }
 
-                for (const auto &itr : reward_idx) {
-                    total_supply += itr.reward_balance;
+            // runs on the thread that pushed the block under the write lock, once the caller yields,
+            // e.g. after relaying the block; the next block waits for it as well
+            _plugin_indexing_result = fc::async([this]() {
+                try {
+                    with_write_lock([&]() {
+                        finish_plugin_indexing();
+                    });
+                } catch (const fc::exception &e) {
+                    elog("Plugin indexing failed: ${e}", ("e", e.to_detail_string()));
                 }
+            }, "plugin_indexing");
+        }
 
-                total_supply += gpo.total_vesting_fund_steem + gpo.total_reward_fund_steem;
+        void database::finish_plugin_indexing() {
+            if (!_pending_tx_held) {
+                return;
+            }
 
-                FC_ASSERT(gpo.current_supply == total_supply, "",
-                          ("gpo.current_supply", gpo.current_supply)("total_supply", total_supply));
-                FC_ASSERT(gpo.current_sbd_supply == total_sbd, "",
-                          ("gpo.current_sbd_supply", gpo.current_sbd_supply)("total_sbd", total_sbd));
-                FC_ASSERT(gpo.total_vesting_shares == total_vesting, "",
-                          ("gpo.total_vesting_shares", gpo.total_vesting_shares)("total_vesting", total_vesting));
-                FC_ASSERT(gpo.total_vesting_shares.amount == total_vsf_votes, "",
-                          ("total_vesting_shares", gpo.total_vesting_shares)("total_vsf_votes", total_vsf_votes));
+            _pending_tx_held = false;
+            detail::without_pending_transactions(*this, std::move(_held_pending_tx), [&]() {
+                process_deferred_operations();
+            });
+        }
 
-                FC_ASSERT(gpo.virtual_supply >= gpo.current_supply);
-                if (!get_feed_history().current_median_history.is_null()) {
-                    FC_ASSERT(gpo.current_sbd_supply * get_feed_history().current_median_history + gpo.current_supply ==
-                              gpo.virtual_supply, "", ("gpo.current_sbd_supply", gpo.current_sbd_supply)(
-                            "get_feed_history().current_median_history", get_feed_history().current_median_history)(
-                            "gpo.current_supply", gpo.current_supply)("gpo.virtual_supply", gpo.virtual_supply));
-                }
-            } FC_CAPTURE_LOG_AND_RETHROW((head_block_num()));
+        void database::stop_plugin_indexing() {
+            if (_plugin_indexing_result.valid() && !_plugin_indexing_result.ready()) {
+                _plugin_indexing_result.cancel_and_wait("database::stop_plugin_indexing()");
+            }
+            _plugin_indexing_result = fc::future<void>();
         }
 
         void database::perform_vesting_share_split(uint32_t magnitude) {
@@ -5030,9 +5604,9 @@ namespace golos {
                 const auto &a = itr;
 
                 const auto &vidx = get_index<witness_vote_index>().indices().get<by_account_witness>();
-                auto wit_itr = vidx.lower_bound(boost::make_tuple(a.name, account_name_type()));
-                while (wit_itr != vidx.end() && wit_itr->account == a.name) {
-                    adjust_witness_vote(get_witness(wit_itr->witness), a.witness_vote_weight());
+                auto wit_itr = vidx.lower_bound(a.id);
+                while (wit_itr != vidx.end() && wit_itr->account == a.id) {
+                    adjust_witness_vote(get(wit_itr->witness), a.witness_vote_weight());
                     ++wit_itr;
                 }
             }
@@ -5046,8 +5620,8 @@ namespace golos {
                 uint16_t witnesses_voted_for = 0;
                 if (force || (a.proxy != STEEMIT_PROXY_TO_SELF_ACCOUNT)) {
                     const auto &vidx = get_index<witness_vote_index>().indices().get<by_account_witness>();
-                    auto wit_itr = vidx.lower_bound(boost::make_tuple(a.name, account_name_type()));
-                    while (wit_itr != vidx.end() && wit_itr->account == a.name) {
+                    auto wit_itr = vidx.lower_bound(a.id);
+                    while (wit_itr != vidx.end() && wit_itr->account == a.id) {
                         ++witnesses_voted_for;
                         ++wit_itr;
                     }
@@ -5141,7 +5715,7 @@ namespace golos {
         void database::cancel_bid(const collateral_bid_object &bid, bool create_virtual_op) {
             adjust_balance(get_account(bid.bidder), bid.inv_swan_price.base);
 
-            if (create_virtual_op) {
+            if (create_virtual_op && is_virtual_operation_observed<bid_collateral_operation<0, 17, 0>>()) {
                 bid_collateral_operation<0, 17, 0> vop;
                 vop.bidder = bid.bidder;
                 vop.additional_collateral = bid.inv_swan_price.base;
@@ -5227,10 +5801,13 @@ namespace golos {
                 });
             }
 
-            push_virtual_operation(execute_bid_operation<0, 17, 0>(bid.bidder, asset<0, 17, 0>(call_obj.collateral,
-                                                                                               bid.inv_swan_price.base.symbol),
-                                                                   asset<0, 17, 0>(debt_covered,
-                                                                                   bid.inv_swan_price.quote.symbol)));
+            if (is_virtual_operation_observed<execute_bid_operation<0, 17, 0>>()) {
+                push_virtual_operation(execute_bid_operation<0, 17, 0>(bid.bidder,
+                                                                       asset<0, 17, 0>(call_obj.collateral,
+                                                                                       bid.inv_swan_price.base.symbol),
+                                                                       asset<0, 17, 0>(debt_covered,
+                                                                                       bid.inv_swan_price.quote.symbol)));
+            }
 
             remove(bid);
         }
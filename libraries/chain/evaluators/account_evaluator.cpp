@@ -68,15 +68,17 @@ namespace golos {
 #endif
             });
 
-            this->db.template create<account_balance_object>([new_account](account_balance_object &b) {
+            this->db.template create<account_balance_object>([&](account_balance_object &b) {
                 b.owner = new_account.name;
                 b.asset_name = STEEM_SYMBOL_NAME;
+                b.asset_id = this->db.get_asset_id(STEEM_SYMBOL_NAME);
                 b.balance = 0;
             });
 
-            this->db.template create<account_balance_object>([new_account](account_balance_object &b) {
+            this->db.template create<account_balance_object>([&](account_balance_object &b) {
                 b.owner = new_account.name;
                 b.asset_name = SBD_SYMBOL_NAME;
+                b.asset_id = this->db.get_asset_id(SBD_SYMBOL_NAME);
                 b.balance = 0;
             });
 
@@ -183,15 +185,17 @@ namespace golos {
 #endif
             });
 
-            this->db.template create<account_balance_object>([new_account](account_balance_object &b) {
+            this->db.template create<account_balance_object>([&](account_balance_object &b) {
                 b.owner = new_account.name;
                 b.asset_name = STEEM_SYMBOL_NAME;
+                b.asset_id = this->db.get_asset_id(STEEM_SYMBOL_NAME);
                 b.balance = 0;
             });
 
-            this->db.template create<account_balance_object>([new_account](account_balance_object &b) {
+            this->db.template create<account_balance_object>([&](account_balance_object &b) {
                 b.owner = new_account.name;
                 b.asset_name = SBD_SYMBOL_NAME;
+                b.asset_id = this->db.get_asset_id(SBD_SYMBOL_NAME);
                 b.balance = 0;
             });
 
@@ -375,7 +375,7 @@ namespace golos {
             } FC_CAPTURE_AND_RETHROW((op))
 
             try {
-                this->db.adjust_balance(this->db.get_account(op.account), -op.amount);
+                this->db.adjust_balance(this->db.get_account(op.account), -op.amount, *asset_to_settle);
 
                 const auto &bitasset = this->db.get_asset_bitasset_data(asset_to_settle->asset_name);
                 if (bitasset.has_settlement()) {
@@ -421,7 +421,7 @@ namespace golos {
             } FC_CAPTURE_AND_RETHROW((op))
 
             try {
-                this->db.adjust_balance(this->db.get_account(op.account), -op.amount);
+                this->db.adjust_balance(this->db.get_account(op.account), -op.amount, *asset_to_settle);
 
                 const auto &bitasset = this->db.get_asset_bitasset_data(asset_to_settle->asset_name);
                 if (bitasset.has_settlement()) {
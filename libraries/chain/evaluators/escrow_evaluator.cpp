@@ -11,8 +11,8 @@ namespace golos {
         void escrow_transfer_evaluator<Major, Hardfork, Release>::do_apply(const operation_type &o) {
             try {
                 const auto &from_account = this->db.template get_account(o.from);
-                this->db.template get_account(o.to);
-                this->db.template get_account(o.agent);
+                const auto &to_account = this->db.template get_account(o.to);
+                const auto &agent_account = this->db.template get_account(o.agent);
 
                 FC_ASSERT(o.ratification_deadline > this->db.template head_block_time(),
                           "The escrow ratification deadline must be after head block time.");
@@ -40,9 +40,9 @@ namespace golos {
 
                 this->db.template create<escrow_object>([&](escrow_object &esc) {
                     esc.escrow_id = o.escrow_id;
-                    esc.from = o.from;
-                    esc.to = o.to;
-                    esc.agent = o.agent;
+                    esc.from = from_account.id;
+                    esc.to = to_account.id;
+                    esc.agent = agent_account.id;
                     esc.ratification_deadline = o.ratification_deadline;
                     esc.escrow_expiration = o.escrow_expiration;
                     esc.sbd_balance = protocol::asset<0, 17, 0>(o.sbd_amount.amount, o.sbd_amount.symbol_name());
@@ -56,12 +56,15 @@ namespace golos {
         void escrow_approve_evaluator<Major, Hardfork, Release>::do_apply(const operation_type &o) {
             try {
 
-                const auto &escrow = this->db.template get_escrow(o.from, o.escrow_id);
-
-                FC_ASSERT(escrow.to == o.to, "Operation 'to' (${o}) does not match escrow 'to' (${e}).",
-                          ("o", o.to)("e", escrow.to));
-                FC_ASSERT(escrow.agent == o.agent, "Operation 'agent' (${a}) does not match escrow 'agent' (${e}).",
-                          ("o", o.agent)("e", escrow.agent));
+                const auto &from_account = this->db.template get_account(o.from);
+                const auto &escrow = this->db.template get_escrow(from_account, o.escrow_id);
+                const auto &to_account = this->db.get(escrow.to);
+                const auto &agent_account = this->db.get(escrow.agent);
+
+                FC_ASSERT(to_account.name == o.to, "Operation 'to' (${o}) does not match escrow 'to' (${e}).",
+                          ("o", o.to)("e", to_account.name));
+                FC_ASSERT(agent_account.name == o.agent, "Operation 'agent' (${a}) does not match escrow 'agent' (${e}).",
+                          ("o", o.agent)("e", agent_account.name));
                 FC_ASSERT(escrow.ratification_deadline >= this->db.template head_block_time(),
                           "The escrow ratification deadline has passed. Escrow can no longer be ratified.");
 
@@ -88,14 +91,12 @@ namespace golos {
                 }
 
                 if (reject_escrow) {
-                    const auto &from_account = this->db.template get_account(o.from);
                     this->db.template adjust_balance(from_account, escrow.steem_balance);
                     this->db.template adjust_balance(from_account, escrow.sbd_balance);
                     this->db.template adjust_balance(from_account, escrow.pending_fee);
 
                     this->db.template remove(escrow);
                 } else if (escrow.to_approved && escrow.agent_approved) {
-                    const auto &agent_account = this->db.template get_account(o.agent);
                     this->db.template adjust_balance(agent_account, escrow.pending_fee);
 
                     this->db.template modify(escrow, [&](escrow_object &esc) {
@@ -109,18 +110,20 @@ namespace golos {
         void escrow_dispute_evaluator<Major, Hardfork, Release>::do_apply(const operation_type &o) {
             try {
 
-                this->db.template get_account(o.from); // Verify from account exists
+                const auto &from_account = this->db.template get_account(o.from);
 
-                const auto &e = this->db.template get_escrow(o.from, o.escrow_id);
+                const auto &e = this->db.template get_escrow(from_account, o.escrow_id);
+                const auto &to_account = this->db.get(e.to);
+                const auto &agent_account = this->db.get(e.agent);
                 FC_ASSERT(this->db.template head_block_time() < e.escrow_expiration,
                           "Disputing the escrow must happen before expiration.");
                 FC_ASSERT(e.to_approved && e.agent_approved,
                           "The escrow must be approved by all parties before a dispute can be raised.");
                 FC_ASSERT(!e.disputed, "The escrow is already under dispute.");
-                FC_ASSERT(e.to == o.to, "Operation 'to' (${o}) does not match escrow 'to' (${e}).",
-                          ("o", o.to)("e", e.to));
-                FC_ASSERT(e.agent == o.agent, "Operation 'agent' (${a}) does not match escrow 'agent' (${e}).",
-                          ("o", o.agent)("e", e.agent));
+                FC_ASSERT(to_account.name == o.to, "Operation 'to' (${o}) does not match escrow 'to' (${e}).",
+                          ("o", o.to)("e", to_account.name));
+                FC_ASSERT(agent_account.name == o.agent, "Operation 'agent' (${a}) does not match escrow 'agent' (${e}).",
+                          ("o", o.agent)("e", agent_account.name));
 
                 this->db.template modify(e, [&](escrow_object &esc) {
                     esc.disputed = true;
@@ -132,41 +135,44 @@ namespace golos {
         void escrow_release_evaluator<Major, Hardfork, Release>::do_apply(const operation_type &o) {
             try {
 
-                this->db.template get_account(o.from); // Verify from account exists
+                const auto &from_account = this->db.template get_account(o.from);
                 const auto &receiver_account = this->db.template get_account(o.receiver);
 
-                const auto &e = this->db.template get_escrow(o.from, o.escrow_id);
+                const auto &e = this->db.template get_escrow(from_account, o.escrow_id);
+                const auto &from = from_account.name;
+                const auto &to = this->db.get(e.to).name;
+                const auto &agent = this->db.get(e.agent).name;
                 FC_ASSERT(e.steem_balance >= typename BOOST_IDENTITY_TYPE((protocol::asset<0, 17, 0>))(o.steem_amount.amount, o.steem_amount.symbol_name()),
                           "Release amount exceeds escrow balance. Amount: ${a}, Balance: ${b}",
                           ("a", o.steem_amount)("b", e.steem_balance));
                 FC_ASSERT(e.sbd_balance >= typename BOOST_IDENTITY_TYPE((protocol::asset<0, 17, 0>))(o.sbd_amount.amount, o.sbd_amount.symbol_name()),
                           "Release amount exceeds escrow balance. Amount: ${a}, Balance: ${b}",
                           ("a", o.sbd_amount)("b", e.sbd_balance));
-                FC_ASSERT(e.to == o.to, "Operation 'to' (${o}) does not match escrow 'to' (${e}).",
-                          ("o", o.to)("e", e.to));
-                FC_ASSERT(e.agent == o.agent, "Operation 'agent' (${a}) does not match escrow 'agent' (${e}).",
-                          ("o", o.agent)("e", e.agent));
-                FC_ASSERT(o.receiver == e.from || o.receiver == e.to,
-                          "Funds must be released to 'from' (${f}) or 'to' (${t})", ("f", e.from)("t", e.to));
+                FC_ASSERT(to == o.to, "Operation 'to' (${o}) does not match escrow 'to' (${e}).",
+                          ("o", o.to)("e", to));
+                FC_ASSERT(agent == o.agent, "Operation 'agent' (${a}) does not match escrow 'agent' (${e}).",
+                          ("o", o.agent)("e", agent));
+                FC_ASSERT(o.receiver == from || o.receiver == to,
+                          "Funds must be released to 'from' (${f}) or 'to' (${t})", ("f", from)("t", to));
                 FC_ASSERT(e.to_approved && e.agent_approved, "Funds cannot be released prior to escrow approval.");
 
                 // If there is a dispute regardless of expiration, the agent can release funds to either party
                 if (e.disputed) {
-                    FC_ASSERT(o.who == e.agent, "Only 'agent' (${a}) can release funds in a disputed escrow.",
-                              ("a", e.agent));
+                    FC_ASSERT(o.who == agent, "Only 'agent' (${a}) can release funds in a disputed escrow.",
+                              ("a", agent));
                 } else {
-                    FC_ASSERT(o.who == e.from || o.who == e.to,
+                    FC_ASSERT(o.who == from || o.who == to,
                               "Only 'from' (${f}) and 'to' (${t}) can release funds from a non-disputed escrow",
-                              ("f", e.from)("t", e.to));
+                              ("f", from)("t", to));
 
                     if (e.escrow_expiration > this->db.template head_block_time()) {
                         // If there is no dispute and escrow has not expired, either party can release funds to the other.
-                        if (o.who == e.from) {
-                            FC_ASSERT(o.receiver == e.to, "Only 'from' (${f}) can release funds to 'to' (${t}).",
-                                      ("f", e.from)("t", e.to));
-                        } else if (o.who == e.to) {
-                            FC_ASSERT(o.receiver == e.from, "Only 'to' (${t}) can release funds to 'from' (${t}).",
-                                      ("f", e.from)("t", e.to));
+                        if (o.who == from) {
+                            FC_ASSERT(o.receiver == to, "Only 'from' (${f}) can release funds to 'to' (${t}).",
+                                      ("f", from)("t", to));
+                        } else if (o.who == to) {
+                            FC_ASSERT(o.receiver == from, "Only 'to' (${t}) can release funds to 'from' (${t}).",
+                                      ("f", from)("t", to));
                         }
                     }
                 }
@@ -134,7 +134,7 @@ namespace golos {
 
                 asset<0, 17, 0> delta(o.amount_to_sell.amount, o.amount_to_sell.symbol_name());
 
-                this->db.adjust_balance(this->db.get_account(o.owner), -delta);
+                this->db.adjust_balance(*seller, -delta, *sell_asset);
 
                 bool filled = this->db.apply_order(
                         this->db.template create<limit_order_object>([&](limit_order_object &obj) {
@@ -194,7 +194,7 @@ namespace golos {
 
                 asset<0, 17, 0> delta(o.amount_to_sell.amount, o.amount_to_sell.symbol_name());
 
-                this->db.adjust_balance(this->db.get_account(o.owner), -delta);
+                this->db.adjust_balance(*seller, -delta, *sell_asset);
 
                 bool filled = this->db.apply_order(
                         this->db.template create<limit_order_object>([&](limit_order_object &obj) {
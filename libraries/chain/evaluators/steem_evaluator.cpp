@@ -1079,12 +1079,14 @@ namespace golos {
                 db.template create<account_balance_object>([&](account_balance_object &b) {
                     b.owner = o.get_worker_account();
                     b.asset_name = STEEM_SYMBOL_NAME;
+                    b.asset_id = db.get_asset_id(STEEM_SYMBOL_NAME);
                     b.balance = 0;
                 });
 
                 db.template create<account_balance_object>([&](account_balance_object &b) {
                     b.owner = o.get_worker_account();
                     b.asset_name = SBD_SYMBOL_NAME;
+                    b.asset_id = db.get_asset_id(SBD_SYMBOL_NAME);
                     b.balance = 0;
                 });
 
@@ -1214,12 +1216,14 @@ namespace golos {
                 this->db.template create<account_balance_object>([&](account_balance_object &b) {
                     b.owner = worker_account;
                     b.asset_name = STEEM_SYMBOL_NAME;
+                    b.asset_id = this->db.get_asset_id(STEEM_SYMBOL_NAME);
                     b.balance = 0;
                 });
 
                 this->db.template create<account_balance_object>([&](account_balance_object &b) {
                     b.owner = worker_account;
                     b.asset_name = SBD_SYMBOL_NAME;
+                    b.asset_id = this->db.get_asset_id(SBD_SYMBOL_NAME);
                     b.balance = 0;
                 });
 
@@ -84,7 +84,7 @@ namespace golos {
         void transfer_from_savings_evaluator<Major, Hardfork, Release>::do_apply(
                 const protocol::transfer_from_savings_operation<Major, Hardfork, Release> &o) {
             const auto &from = this->db.template get_account(o.from);
-            this->db.template get_account(o.to); // Verify to account exists
+            const auto &to = this->db.template get_account(o.to);
 
             FC_ASSERT(from.savings_withdraw_requests < STEEMIT_SAVINGS_WITHDRAW_REQUEST_LIMIT,
                       "Account has reached limit for pending withdraw requests.");
@@ -94,8 +94,8 @@ namespace golos {
             FC_ASSERT(this->db.template get_savings_balance(from, o.amount.symbol_name()) >= required_amount);
             this->db.template adjust_savings_balance(from, -required_amount);
             this->db.template create<savings_withdraw_object>([&](savings_withdraw_object &s) {
-                s.from = o.from;
-                s.to = o.to;
+                s.from = from.id;
+                s.to = to.id;
                 s.amount = required_amount;
 #ifndef STEEMIT_BUILD_LOW_MEMORY
                 from_string(s.memo, o.memo);
@@ -112,11 +112,11 @@ namespace golos {
         template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
         void cancel_transfer_from_savings_evaluator<Major, Hardfork, Release>::do_apply(
                 const protocol::cancel_transfer_from_savings_operation<Major, Hardfork, Release> &o) {
-            const auto &swo = this->db.template get_savings_withdraw(o.from, o.request_id);
-            this->db.template adjust_savings_balance(this->db.template get_account(swo.from), swo.amount);
+            const auto &from = this->db.template get_account(o.from);
+            const auto &swo = this->db.template get_savings_withdraw(from, o.request_id);
+            this->db.template adjust_savings_balance(from, swo.amount);
             this->db.template remove(swo);
 
-            const auto &from = this->db.template get_account(o.from);
             this->db.template modify(from, [&](account_object &a) {
                 a.savings_withdraw_requests--;
             });
@@ -144,8 +144,8 @@ namespace golos {
                                                        this->db.template get_balance(from_account, asset_type).amount));
                 protocol::asset<0, 17, 0> required_amount(o.amount.amount, o.amount.symbol_name());
 
-                this->db.template adjust_balance(this->db.template get_account(o.from), -required_amount);
-                this->db.template adjust_balance(this->db.template get_account(o.to), required_amount);
+                this->db.template adjust_balance(from_account, -required_amount, asset_type);
+                this->db.template adjust_balance(to_account, required_amount, asset_type);
             } FC_CAPTURE_AND_RETHROW((o))
         }
     }
@@ -114,7 +114,7 @@ namespace golos {
 
             const auto &by_account_witness_idx = this->db.template get_index<witness_vote_index>().indices().
                     template get<by_account_witness>();
-            auto itr = by_account_witness_idx.find(boost::make_tuple(voter.name, witness.owner));
+            auto itr = by_account_witness_idx.find(boost::make_tuple(voter.id, witness.id));
 
             if (itr == by_account_witness_idx.end()) {
                 FC_ASSERT(o.approve, "Vote doesn't exist, user must indicate a desire to approve witness.");
@@ -124,8 +124,8 @@ namespace golos {
                               "Account has voted for too many witnesses."); // TODO: Remove after hardfork 2
 
                     this->db.template create<witness_vote_object>([&](witness_vote_object &v) {
-                        v.witness = witness.owner;
-                        v.account = voter.name;
+                        v.witness = witness.id;
+                        v.account = voter.id;
                         v.created = this->db.head_block_time();
                     });
 
@@ -138,8 +138,8 @@ namespace golos {
                 } else {
 
                     this->db.template create<witness_vote_object>([&](witness_vote_object &v) {
-                        v.witness = witness.owner;
-                        v.account = voter.name;
+                        v.witness = witness.id;
+                        v.account = voter.id;
                         v.created = this->db.head_block_time();
                     });
                     this->db.modify(witness, [&](witness_object &w) {
@@ -8,17 +8,27 @@
 #include <golos/chain/objects/node_property_object.hpp>
 #include <golos/chain/fork_database.hpp>
 #include <golos/chain/block_log.hpp>
+#include <golos/chain/index_info.hpp>
+#include <golos/chain/operation_notification.hpp>
+#include <golos/chain/plugin_handler_stats.hpp>
 #include <golos/chain/objects/asset_object.hpp>
 #include <golos/chain/objects/comment_object.hpp>
 #include <golos/chain/objects/steem_objects.hpp>
 #include <golos/chain/objects/market_object.hpp>
+#include <golos/chain/objects/next_id_object.hpp>
+#include <golos/chain/objects/state_hash_object.hpp>
 
 #include <golos/protocol/protocol.hpp>
 
 #include <fc/signals.hpp>
 
 #include <fc/log/logger.hpp>
+#include <fc/thread/future.hpp>
 
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <functional>
 #include <map>
 
 namespace golos {
@@ -35,8 +45,6 @@ namespace golos {
 
         class custom_operation_interpreter;
 
-        struct operation_notification;
-
         namespace utilities {
             struct comment_reward_context;
         }
@@ -88,10 +96,14 @@ namespace golos {
              * will be initialized with the default state.
              *
              * @param data_dir Path to open or create database in
+             * @param state_snapshot_dir If set and the database is empty, its state is loaded from this snapshot
+             *        instead of being initialized from genesis
+             * @param state_snapshot_threads Number of threads verifying the snapshot, 0 means the number of cores
              */
             void open(const fc::path &data_dir, const fc::path &shared_mem_dir,
                       uint64_t initial_supply = STEEMIT_INIT_SUPPLY, uint64_t shared_file_size = 0,
-                      uint32_t chainbase_flags = 0);
+                      uint32_t chainbase_flags = 0, const fc::path &state_snapshot_dir = fc::path(),
+                      uint32_t state_snapshot_threads = 0);
 
             /**
              * @brief Rebuild object graph from block history and open detabase
@@ -112,6 +124,40 @@ namespace golos {
 
             void close(bool rewind = true);
 
+            /**
+             * @brief Write all registered indexes, including plugin ones, into a state snapshot
+             *
+             * Every index is serialized into its own file by a pool of threads, the manifest with the
+             * head block and checksums of the files is written last.
+             *
+             * @param snapshot_dir Directory to write the snapshot to
+             * @param threads Number of writer threads, 0 means the number of cores
+             */
+            void export_state_snapshot(const fc::path &snapshot_dir, uint32_t threads = 0);
+
+            /**
+             * @brief Load the state written by @ref export_state_snapshot into an empty database
+             *
+             * Checksums of all files are verified before loading. The block log must contain the
+             * head block of the snapshot, the node continues syncing from it.
+             */
+            void import_state_snapshot(const fc::path &snapshot_dir, uint32_t threads = 0);
+
+            /**
+             * @brief Rewrite all registered indexes into a fresh shared memory file
+             *
+             * Objects are copied with their ids into a new chainbase database in @p dest_dir, which leaves
+             * behind the fragmentation accumulated by creates and removes. The new file is shrunk to the
+             * used size, chainbase grows it back to the configured size when it is opened. The next ids
+             * of the indexes are carried over, see index_info::next_id().
+             * Only reads the state, so the database should be opened read_only. The undo history has
+             * to be rewound by an earlier read_write open, a read_only open can not rewind it.
+             *
+             * @param dest_dir Directory for the new shared memory file, it must not contain one already
+             * @param shared_file_size Initial size of the new file, must fit the whole state
+             */
+            void compact_shared_memory(const fc::path &dest_dir, uint64_t shared_file_size);
+
             /**
              * @brief Retrieve a particular account's balance in a given asset
              * @param owner Account whose balance should be retrieved
@@ -155,6 +201,14 @@ namespace golos {
 
             const asset_object *find_asset(const asset_name_type &name) const;
 
+            /**
+             * @brief Id of the asset with the given name
+             *
+             * The ids of STEEM and SBD are cached when the database is opened, so balance lookups in the
+             * core assets do not search the asset index by name.
+             */
+            asset_object::id_type get_asset_id(const asset_name_type &name) const;
+
             const asset_dynamic_data_object &get_asset_dynamic_data(const asset_name_type &name) const;
 
             const asset_dynamic_data_object *find_asset_dynamic_data(const asset_name_type &name) const;
@@ -195,6 +249,10 @@ namespace golos {
 
             const escrow_object *find_escrow(const account_name_type &name, uint32_t escrow_id) const;
 
+            const escrow_object &get_escrow(const account_object &from, uint32_t escrow_id) const;
+
+            const escrow_object *find_escrow(const account_object &from, uint32_t escrow_id) const;
+
             const limit_order_object &get_limit_order(const account_name_type &owner, integral_id_type id) const;
 
             const limit_order_object *find_limit_order(const account_name_type &owner, integral_id_type id) const;
@@ -205,6 +263,12 @@ namespace golos {
             const savings_withdraw_object *find_savings_withdraw(const account_name_type &owner,
                                                                  uint32_t request_id) const;
 
+            const savings_withdraw_object &get_savings_withdraw(const account_object &owner,
+                                                                uint32_t request_id) const;
+
+            const savings_withdraw_object *find_savings_withdraw(const account_object &owner,
+                                                                 uint32_t request_id) const;
+
             const dynamic_global_property_object &get_dynamic_global_properties() const;
 
             const node_property_object &get_node_properties() const;
@@ -294,7 +358,34 @@ namespace golos {
             void notify_post_apply_operation(const operation_notification &note);
 
             inline const void push_virtual_operation(const operation &op,
-                                                     bool force = false); // vops are not needed for low mem. Force will push them on low mem.
+                                                     bool force = false); // vops nobody receives are dropped. Force always pushes them.
+
+            /**
+             * Controls emission of virtual operations:
+             * - virtual_operations_auto: only the operations which have a subscriber, either a handler
+             *   connected with pre/post_apply_operation_connect() or a slot of the generic signals
+             * - virtual_operations_all: all virtual operations
+             * - virtual_operations_none: only the forced ones (hardfork_operation)
+             */
+            enum virtual_operations_mode {
+                virtual_operations_auto,
+                virtual_operations_all,
+                virtual_operations_none
+            };
+
+            void set_virtual_operations_mode(virtual_operations_mode mode);
+
+            /**
+             * Checks whether a virtual operation of the type would be emitted, so code producing
+             * virtual operations in bulk may skip constructing the ones which would be dropped
+             */
+            template<typename Operation>
+            bool is_virtual_operation_observed() {
+                return is_virtual_operation_observed(operation::tag<Operation>::value);
+            }
+
+            bool is_virtual_operation_observed(int64_t tag);
+
             void notify_applied_block(const signed_block &block);
 
             void notify_on_pending_transaction(const signed_transaction &tx);
@@ -307,6 +398,92 @@ namespace golos {
             fc::signal<void(const operation_notification &)> pre_apply_operation;
             fc::signal<void(const operation_notification &)> post_apply_operation;
 
+            typedef std::function<void(const operation_notification &)> operation_handler;
+
+            /// Identifies a connected operation handler, 0 is never used
+            typedef uint64_t operation_handler_id;
+
+            /**
+             *  Connects a handler which is invoked only for the operations of OperationSet, see
+             *  operation_templates and operation_types. The handlers are kept in per operation tag
+             *  lists, so operations a plugin does not handle cost it neither a signal invocation
+             *  nor a variant visit. Unlike a slot of the generic signals, the handler makes the
+             *  database emit only the virtual operations of OperationSet.
+             */
+            template<typename OperationSet>
+            operation_handler_id pre_apply_operation_connect(operation_handler handler) {
+                return connect_operation_handler(_pre_apply_operation_handlers, operation_set_tags<OperationSet>(),
+                                                 handler);
+            }
+
+            template<typename OperationSet>
+            operation_handler_id post_apply_operation_connect(operation_handler handler) {
+                return connect_operation_handler(_post_apply_operation_handlers, operation_set_tags<OperationSet>(),
+                                                 handler);
+            }
+
+            /**
+             *  Disconnects a handler connected with pre/post_apply_operation_connect(). The caller holds
+             *  the write lock, so no operation is being applied.
+             */
+            void disconnect_operation_handler(operation_handler_id id);
+
+            /**
+             *  Connects an index update handler of @p plugin for the operations of OperationSet. It is
+             *  notified in the order of pre_apply_operation. With deferred plugin indexing enabled it is
+             *  notified only about the operations of applied blocks, after the whole block is applied, and
+             *  a replay may rebuild its indexes in a separate pass, see set_plugin_rebuild_after_reindex().
+             *  So it may rely on the notification and the plugin's own indexes only.
+             */
+            template<typename OperationSet>
+            void deferred_apply_operation_connect(const std::string &plugin, operation_handler handler) {
+                connect_operation_handler(_deferred_apply_operation_handlers[plugin],
+                                          operation_set_tags<OperationSet>(),
+                                          measure_plugin_handler<const operation_notification &>(plugin, handler));
+            }
+
+            /**
+             * Runs deferred operation handlers in a task scheduled after push_block() returns, so
+             * push_block() and relaying the block do not wait for plugin indexing. The task is not a
+             * separate thread: it runs on the thread that pushed the block under the write lock, and the
+             * queued blocks are indexed before the next block or transaction is applied or a block is
+             * popped. So plugin work is postponed, not taken off the chain thread, and it still delays
+             * the next write. Plugin indexes lag behind the head block by at most one block, and the
+             * pending transactions are not applied again until the task has run.
+             */
+            void set_deferred_plugin_indexing(bool enabled);
+
+            /// Last block processed by the deferred operation handlers
+            uint32_t plugin_head_block_num() const;
+
+            /**
+             * Makes reindex() skip the deferred operation handlers. Their operations are written to
+             * @p operation_log instead, and after the replay the indexes of every plugin are rebuilt
+             * from it in a separate pass, plugins run in parallel on up to @p threads threads.
+             * The log is removed when the rebuild is done. If it is left behind by a failed rebuild,
+             * open() fails with an assert, which makes the application reindex, and wipe() removes it.
+             * @param threads Number of rebuild threads, 0 notifies the handlers during the replay
+             */
+            void set_plugin_rebuild_after_reindex(const fc::path &operation_log, uint32_t threads);
+
+            /**
+             *  Wraps a handler of @p plugin, so its calls are accounted in get_plugin_handler_stats(), e.g.
+             *  db.applied_block.connect(db.measure_plugin_handler<const signed_block &>(plugin_name(), ...))
+             */
+            template<typename... Args, typename Handler>
+            std::function<void(Args...)> measure_plugin_handler(const std::string &plugin, Handler &&handler) {
+                return measured_handler<Args...>(plugin_handler_stats_for(plugin),
+                                                 std::function<void(Args...)>(std::forward<Handler>(handler)));
+            }
+
+            /// Cost of the measured plugin handlers since the start of the node, ordered by plugin name
+            std::vector<plugin_handler_stats> get_plugin_handler_stats() const;
+
+            /**
+             * Logs get_plugin_handler_stats() every @p interval blocks, 0 disables logging
+             */
+            void set_plugin_handler_stats_log_interval(uint32_t interval);
+
             /**
              *  This signal is emitted after all operations and virtual operation for a
              *  block have been applied but before the get_applied_operations() are cleared.
@@ -329,17 +506,6 @@ namespace golos {
              */
             fc::signal<void(const signed_transaction &)> on_applied_transaction;
 
-            /**
-             *  Emitted After a block has been applied and committed.  The callback
-             *  should not yield and should execute quickly.
-             */
-            //fc::signal<void(const vector< golos::db2::generic_id >&)> changed_objects;
-
-            /** this signal is emitted any time an object is removed and contains a
-             * pointer to the last value of every object that was removed.
-             */
-            //fc::signal<void(const vector<const object*>&)>  removed_objects;
-
             //////////////////// db_witness_schedule.cpp ////////////////////
 
             /**
@@ -411,6 +577,9 @@ namespace golos {
 
             void adjust_balance(const account_object &a, const asset<0, 17, 0> &delta);
 
+            /// This is an overloaded method, @p asset_obj has to be the asset named by the delta symbol.
+            void adjust_balance(const account_object &a, const asset<0, 17, 0> &delta, const asset_object &asset_obj);
+
             void adjust_savings_balance(const account_object &a, const asset<0, 17, 0> &delta);
 
             void adjust_supply(const asset<0, 17, 0> &delta, bool adjust_vesting = false);
@@ -633,7 +802,8 @@ namespace golos {
             bool check_call_orders(const asset_object &mia, bool enable_black_swan = true);
 
             // helpers to fill_order
-            void pay_order(const account_object &receiver, const asset<0, 17, 0> &receives, const asset<0, 17, 0> &pays);
+            void pay_order(const account_object &receiver, const asset<0, 17, 0> &receives, const asset<0, 17, 0> &pays,
+                           const asset_object &receive_asset);
 
             asset<0, 17, 0> calculate_market_fee(const asset_object &recv_asset, const asset<0, 17, 0> &trade_amount);
 
@@ -675,17 +845,120 @@ namespace golos {
             bool skip_transaction_delta_check = true;
 #endif
 
+            /**
+             * Adds the index to chainbase and registers its @ref index_info,
+             * so the index is covered by state snapshots
+             */
+            template<typename MultiIndexType>
+            void add_core_index() {
+                add_index<MultiIndexType>();
+                _index_infos.push_back(std::make_shared<index_info<MultiIndexType>>(*this));
+            }
+
             template<typename MultiIndexType>
             void add_plugin_index() {
                 _plugin_index_signal.connect([&]() {
-                    add_index<MultiIndexType>();
+                    add_core_index<MultiIndexType>();
                 });
             }
 
+            const std::vector<std::shared_ptr<abstract_index_info>> &get_index_infos() const {
+                return _index_infos;
+            }
+
+            /**
+             * Estimates the shared memory taken by every registered index, including plugin indexes.
+             * Walks all objects, so the caller should hold the read lock and expect it to take a while.
+             * @return indexes ordered by total bytes, largest first
+             */
+            std::vector<index_memory_usage> get_memory_usage() const;
+
+            /**
+             * @name Incremental state checksum
+             *
+             * While enabled, every create/modify/remove of an object goes through the overloads below and
+             * updates the XOR checksum of the whole state, so two builds can be compared block by block
+             * on the same block_log. The checksum includes plugin indexes, so nodes should be compared
+             * with the same set of plugins enabled. The overloads also count state changes, which lets
+             * the background invariants check detect that the state moved between its read locks.
+             */
+            ///@{
+            template<typename ObjectType, typename Constructor>
+            const ObjectType &create(Constructor &&con) {
+                ++_state_change_count;
+                const auto &obj = chainbase::database::create<ObjectType>(std::forward<Constructor>(con));
+                if (_state_hash_obj != nullptr) {
+                    update_state_hash(object_state_hash(obj));
+                }
+                return obj;
+            }
+
+            template<typename ObjectType, typename Modifier>
+            void modify(const ObjectType &obj, Modifier &&m) {
+                ++_state_change_count;
+                if (_state_hash_obj == nullptr) {
+                    chainbase::database::modify(obj, std::forward<Modifier>(m));
+                    return;
+                }
+
+                uint64_t old_hash = object_state_hash(obj);
+                chainbase::database::modify(obj, std::forward<Modifier>(m));
+                update_state_hash(old_hash ^ object_state_hash(obj));
+            }
+
+            template<typename ObjectType>
+            void remove(const ObjectType &obj) {
+                ++_state_change_count;
+                if (_state_hash_obj != nullptr) {
+                    update_state_hash(object_state_hash(obj));
+                }
+
+                // the id of a removed last object is not reused, see next_id_object
+                const auto &indices = get_index<typename chainbase::get_index_type<ObjectType>::type>().indices();
+                if (indices.rbegin()->id == obj.id) {
+                    record_next_id(*this, ObjectType::type_id, obj.id._id + 1);
+                }
+
+                chainbase::database::remove(obj);
+            }
+
+            /**
+             * Enables or disables state hashing, takes effect on the next open(). The checksum is
+             * recalculated from scratch on open, so it may be enabled on an existing state.
+             * @param log_interval Log the checksum every this many blocks, 0 disables logging
+             */
+            void set_state_hash(bool enabled, uint32_t log_interval = 0);
+
+            bool is_state_hash_enabled() const {
+                return _state_hash_obj != nullptr;
+            }
+
+            /// Checksum of the current state, throws if state hashing is disabled
+            uint64_t get_state_hash() const;
+
+            /// Checksum of the state after the block, for recently applied blocks only
+            optional<uint64_t> get_state_hash(uint32_t block_num) const;
+
+            /// Calculates the checksum of the whole state by walking all registered indexes
+            uint64_t calculate_state_hash() const;
+            ///@}
+
+            /**
+             * Runs validate_invariants() on a background thread after every @p interval blocks.
+             * The check takes the read lock for at most @p chunk_size objects at a time, so block
+             * application is not stalled for the whole walk. When a block is applied between two chunks,
+             * the check starts over, after a few such restarts it is done under a single read lock.
+             * Pending transactions applied in between do not stop the walk, but its result is then not
+             * conclusive, so the check starts over. When a few walks are inconclusive, the check is logged
+             * as failed.
+             * Blocks applied with skip_validate_invariants (replay, checkpoints) do not trigger the check.
+             * @param interval Check every this many blocks, 0 disables the check
+             */
+            void set_background_invariants_check(uint32_t interval, uint32_t chunk_size = 10000);
+
         protected:
             //Mark pop_undo() as protected -- we do not want outside calling pop_undo(); it should call pop_block() instead
             //void pop_undo() { object_database::pop_undo(); }
-            void notify_changed_objects();
 
         private:
             optional<chainbase::database::session> _pending_tx_session;
@@ -706,6 +979,14 @@ namespace golos {
 
             void adjust_sbd_balance(const account_object &a, account_balance_object &b);
 
+            void _adjust_balance(const account_object &a, const asset<0, 17, 0> &delta, asset_object::id_type asset_id);
+
+            /// Fills _steem_asset_id and _sbd_asset_id, they never change once genesis created the assets
+            void init_core_asset_ids();
+
+            asset_object::id_type _steem_asset_id;
+            asset_object::id_type _sbd_asset_id;
+
             ///Steps involved in applying a new block
             ///@{
 
@@ -767,6 +1048,108 @@ namespace golos {
 
             fc::signal<void()> _plugin_index_signal;
 
+            std::vector<std::shared_ptr<abstract_index_info>> _index_infos;
+
+            void update_state_hash(uint64_t delta);
+
+            void reset_state_hash();
+
+            struct tagged_operation_handler {
+                operation_handler_id id;
+                operation_handler handler;
+            };
+
+            typedef std::vector<std::vector<tagged_operation_handler>> operation_handler_table;
+
+            operation_handler_id connect_operation_handler(operation_handler_table &table,
+                                                           const std::vector<std::size_t> &tags,
+                                                           const operation_handler &handler);
+
+            operation_handler_id _next_operation_handler_id = 0;
+
+            void notify_operation_handlers(const operation_handler_table &table, const operation_notification &note);
+
+            operation_handler_table _pre_apply_operation_handlers;
+            operation_handler_table _post_apply_operation_handlers;
+
+            /// Recalculates _observed_operations from the connected handlers and signal slots
+            void refresh_observed_operations();
+
+            virtual_operations_mode _virtual_operations_mode = virtual_operations_auto;
+
+            /// Operation tags having a subscriber, empty when it has to be recalculated
+            std::vector<bool> _observed_operations;
+
+            plugin_handler_stats &plugin_handler_stats_for(const std::string &plugin);
+
+            struct deferred_block {
+                uint32_t block_num;
+                std::vector<operation_record> operations;
+            };
+
+            bool has_deferred_handlers(std::size_t tag) const;
+
+            void notify_deferred_handlers(const operation_notification &note);
+
+            /// Notifies the deferred handlers of every plugin about the operations from the log
+            void rebuild_plugin_indexes(const fc::path &operation_log);
+
+            /**
+             * Notifies deferred operation handlers about the queued blocks, the caller holds the write lock.
+             * Plugin updates are recorded in the undo state on top of the stack, so this has to be called
+             * before an undo session for another block or pending transactions is started.
+             */
+            void process_deferred_operations();
+
+            void schedule_plugin_indexing();
+
+            /**
+             * Indexes the queued blocks and restores the pending transactions push_block() set aside for
+             * the time, the caller holds the write lock. Every write path calls it first, so pending
+             * transactions are applied once per block and always on top of the plugin updates.
+             */
+            void finish_plugin_indexing();
+
+            void stop_plugin_indexing();
+
+            std::map<std::string, operation_handler_table> _deferred_apply_operation_handlers;
+            bool _deferred_plugin_indexing = false;
+            bool _applying_block = false;
+            std::vector<operation_record> _deferred_block_operations;
+            std::deque<deferred_block> _deferred_blocks;
+            std::vector<signed_transaction> _held_pending_tx;
+            bool _pending_tx_held = false;
+            fc::future<void> _plugin_indexing_result;
+
+            fc::path _plugin_rebuild_log;
+            uint32_t _plugin_rebuild_threads = 0;
+            /// Open while reindex() collects the operations for the plugin rebuild
+            std::unique_ptr<std::ofstream> _plugin_rebuild_stream;
+
+            void log_plugin_handler_stats() const;
+
+            /// Handlers keep references to the elements, so they must stay in place
+            std::map<std::string, plugin_handler_stats> _plugin_handler_stats;
+            uint32_t _plugin_handler_stats_log_interval = 0;
+
+            void schedule_invariants_check(uint32_t block_num);
+
+            void check_invariants_in_background(uint32_t block_num);
+
+            void stop_invariants_check();
+
+            uint32_t _invariants_check_interval = 0;
+            uint32_t _invariants_check_chunk_size = 0;
+            std::shared_ptr<fc::thread> _invariants_check_thread;
+            fc::future<void> _invariants_check_result;
+            std::atomic<bool> _invariants_check_stop{false};
+            std::atomic<uint64_t> _state_change_count{0};
+
+            bool _state_hash_enabled = false;
+            uint32_t _state_hash_log_interval = 0;
+            const state_hash_object *_state_hash_obj = nullptr;
+            std::map<uint32_t, uint64_t> _state_hash_history;
+
             transaction_id_type _current_trx_id;
             uint32_t _current_block_num = 0;
             uint16_t _current_trx_in_block = 0;
@@ -59,6 +59,10 @@ namespace golos {
                 template<uint32_t Code = 4110000,
                         typename What = boost::mpl::string<'block log exception'>> using block_log = basic<Code, What>;
 
+                template<uint32_t Code = 4120000,
+                        typename What = boost::mpl::string<'state snapshot exception'>> using state_snapshot = basic<
+                        Code, What>;
+
                 template<uint32_t Code = 37006,
                         typename What = boost::mpl::string<'insuffucient feeds'>> using insufficient_feeds = basic<Code,
                         What>;
@@ -0,0 +1,374 @@
+#pragma once
+
+#include <golos/chain/steem_object_types.hpp>
+#include <golos/chain/objects/next_id_object.hpp>
+
+#include <fc/crypto/city.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/reflect/typename.hpp>
+
+#include <boost/container/deque.hpp>
+#include <boost/container/flat_map.hpp>
+#include <boost/container/flat_set.hpp>
+#include <boost/container/string.hpp>
+#include <boost/container/vector.hpp>
+#include <boost/mpl/size.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace golos {
+    namespace chain {
+
+        /**
+         * @brief Hash of a chain object used by the incremental state checksum
+         *
+         * The object type is hashed together with the packed object, so objects of different types with
+         * equal representations do not cancel each other out in the XOR accumulator.
+         */
+        template<typename ObjectType>
+        uint64_t object_state_hash(const ObjectType &obj) {
+            const uint16_t type_id = ObjectType::type_id;
+            std::vector<char> data(sizeof(type_id) + fc::raw::pack_size(obj));
+            fc::datastream<char *> ds(data.data(), data.size());
+            fc::raw::pack(ds, type_id);
+            fc::raw::pack(ds, obj);
+            return fc::city_hash64(data.data(), data.size());
+        }
+
+        /**
+         * @brief Approximate shared memory footprint of an index
+         */
+        struct index_memory_usage {
+            std::string name;
+            uint64_t count = 0;
+            /// count * sizeof(object)
+            uint64_t object_bytes = 0;
+            /// Buffers owned by the objects: shared_string payloads and shared containers
+            uint64_t dynamic_bytes = 0;
+            /// multi_index node overhead, three pointers per object for each of its indices
+            uint64_t node_bytes = 0;
+            uint64_t total_bytes = 0;
+        };
+
+        namespace detail {
+
+            /**
+             * Bytes allocated in shared memory by the members of an object beyond sizeof(object).
+             * Reflected structs are walked member by member, other types are assumed to own no buffers.
+             */
+            template<typename T>
+            uint64_t dynamic_size(const T &v);
+
+            template<typename CharT, typename Traits, typename Allocator>
+            uint64_t dynamic_size(const boost::container::basic_string<CharT, Traits, Allocator> &s);
+
+            template<typename T, typename Allocator>
+            uint64_t dynamic_size(const boost::container::vector<T, Allocator> &v);
+
+            template<typename T, typename Allocator>
+            uint64_t dynamic_size(const boost::container::deque<T, Allocator> &v);
+
+            template<typename K, typename V, typename Compare, typename Allocator>
+            uint64_t dynamic_size(const boost::container::flat_map<K, V, Compare, Allocator> &v);
+
+            template<typename K, typename Compare, typename Allocator>
+            uint64_t dynamic_size(const boost::container::flat_set<K, Compare, Allocator> &v);
+
+            template<typename A, typename B>
+            uint64_t dynamic_size(const std::pair<A, B> &v);
+
+            template<typename T>
+            struct dynamic_size_visitor {
+                dynamic_size_visitor(const T &o, uint64_t &s) : obj(o), size(s) {
+                }
+
+                template<typename Member, class Class, Member (Class::*member)>
+                void operator()(const char *) const {
+                    size += dynamic_size(obj.*member);
+                }
+
+                const T &obj;
+                uint64_t &size;
+            };
+
+            template<typename T,
+                    bool Reflected = fc::reflector<T>::is_defined::value && !std::is_enum<T>::value>
+            struct dynamic_size_impl {
+                static uint64_t get(const T &) {
+                    return 0;
+                }
+            };
+
+            template<typename T>
+            struct dynamic_size_impl<T, true> {
+                static uint64_t get(const T &v) {
+                    uint64_t size = 0;
+                    fc::reflector<T>::visit(dynamic_size_visitor<T>(v, size));
+                    return size;
+                }
+            };
+
+            template<typename Container>
+            uint64_t dynamic_size_of_elements(const Container &v) {
+                uint64_t size = 0;
+                for (const auto &e : v) {
+                    size += dynamic_size(e);
+                }
+                return size;
+            }
+
+            template<typename T>
+            uint64_t dynamic_size(const T &v) {
+                return dynamic_size_impl<T>::get(v);
+            }
+
+            template<typename CharT, typename Traits, typename Allocator>
+            uint64_t dynamic_size(const boost::container::basic_string<CharT, Traits, Allocator> &s) {
+                // short strings are kept inside the string object itself
+                if (s.capacity() * sizeof(CharT) < sizeof(s)) {
+                    return 0;
+                }
+                return (s.capacity() + 1) * sizeof(CharT);
+            }
+
+            template<typename T, typename Allocator>
+            uint64_t dynamic_size(const boost::container::vector<T, Allocator> &v) {
+                return v.capacity() * sizeof(T) + dynamic_size_of_elements(v);
+            }
+
+            template<typename T, typename Allocator>
+            uint64_t dynamic_size(const boost::container::deque<T, Allocator> &v) {
+                return v.size() * sizeof(T) + dynamic_size_of_elements(v);
+            }
+
+            template<typename K, typename V, typename Compare, typename Allocator>
+            uint64_t dynamic_size(const boost::container::flat_map<K, V, Compare, Allocator> &v) {
+                return v.capacity() * sizeof(typename boost::container::flat_map<K, V, Compare, Allocator>::value_type) +
+                       dynamic_size_of_elements(v);
+            }
+
+            template<typename K, typename Compare, typename Allocator>
+            uint64_t dynamic_size(const boost::container::flat_set<K, Compare, Allocator> &v) {
+                return v.capacity() * sizeof(K) + dynamic_size_of_elements(v);
+            }
+
+            template<typename A, typename B>
+            uint64_t dynamic_size(const std::pair<A, B> &v) {
+                return dynamic_size(v.first) + dynamic_size(v.second);
+            }
+
+        }
+
+        /**
+         * @brief Type-erased access to a registered chainbase index
+         *
+         * chainbase only knows the indexes through their concrete multi_index types, so every index
+         * added with database::add_core_index() or database::add_plugin_index() gets an index_info
+         * companion which knows how to walk and (de)serialize its objects. Everything that has to
+         * iterate over the whole state without knowing the object types (state snapshots, state
+         * checksum) goes through this interface.
+         */
+        class abstract_index_info {
+        public:
+            virtual ~abstract_index_info() {
+            }
+
+            /// Stable name of the object type, used as a key in state snapshots
+            virtual std::string name() const = 0;
+
+            virtual uint16_t type_id() const = 0;
+
+            virtual std::size_t size() const = 0;
+
+            /**
+             * Id the next object created in the index gets. It is one past the id of the last object,
+             * or the id recorded in @ref next_id_object when the last objects were removed. Only reads
+             * the state, so it works on a database opened read_only.
+             */
+            virtual int64_t next_id() const = 0;
+
+            /**
+             * Serializes all objects of the index in id order, each object is prefixed with the size
+             * of its packed representation.
+             * @return number of exported objects
+             */
+            virtual uint64_t export_objects(std::ostream &out) const = 0;
+
+            /**
+             * Loads objects produced by export_objects() into an empty index. Object ids are preserved,
+             * ids of objects which were removed before the export are skipped.
+             * @param next_id The value of next_id() at the export, the next object created gets this id
+             * @return number of imported objects
+             */
+            virtual uint64_t import_objects(std::istream &in, uint64_t count, int64_t next_id) = 0;
+
+            /**
+             * Adds the index to another chainbase database and copies all objects into it preserving
+             * their ids, the destination index must be empty.
+             * @return number of copied objects
+             */
+            virtual uint64_t copy_objects(chainbase::database &dest) const = 0;
+
+            /// XOR of @ref object_state_hash of all objects of the index
+            virtual uint64_t hash_objects() const = 0;
+
+            /// Walks all objects of the index to estimate its shared memory footprint
+            virtual index_memory_usage memory_usage() const = 0;
+        };
+
+        template<typename MultiIndexType>
+        class index_info : public abstract_index_info {
+        public:
+            typedef typename MultiIndexType::value_type value_type;
+
+            index_info(chainbase::database &db) : _db(db) {
+            }
+
+            std::string name() const override {
+                return fc::get_typename<value_type>::name();
+            }
+
+            uint16_t type_id() const override {
+                return value_type::type_id;
+            }
+
+            std::size_t size() const override {
+                return _db.get_index<MultiIndexType>().indices().size();
+            }
+
+            int64_t next_id() const override {
+                const auto &indices = _db.get_index<MultiIndexType>().indices();
+                int64_t next = indices.empty() ? 0 : indices.rbegin()->id._id + 1;
+                return std::max(next, recorded_next_id(_db, type_id()));
+            }
+
+            uint64_t export_objects(std::ostream &out) const override {
+                uint64_t count = 0;
+                std::vector<char> buffer;
+
+                for (const auto &obj : _db.get_index<MultiIndexType>().indices()) {
+                    buffer = fc::raw::pack(obj);
+                    fc::raw::pack(out, fc::unsigned_int(buffer.size()));
+                    out.write(buffer.data(), buffer.size());
+                    ++count;
+                }
+
+                return count;
+            }
+
+            uint64_t import_objects(std::istream &in, uint64_t count, int64_t next_id) override {
+                skip_removed_ids(_db, count, next_id);
+
+                std::vector<char> buffer;
+                for (uint64_t i = 0; i < count; ++i) {
+                    fc::unsigned_int size;
+                    fc::raw::unpack(in, size);
+                    buffer.resize(size.value);
+                    in.read(buffer.data(), buffer.size());
+                    FC_ASSERT(in.good(), "Unexpected end of data in index ${i}", ("i", name()));
+
+                    load_object(_db, buffer, next_id);
+                }
+
+                restore_next_id(_db, next_id);
+                return count;
+            }
+
+            uint64_t copy_objects(chainbase::database &dest) const override {
+                dest.add_index<MultiIndexType>();
+
+                const auto &indices = _db.get_index<MultiIndexType>().indices();
+                const int64_t next = next_id();
+                skip_removed_ids(dest, indices.size(), next);
+
+                uint64_t count = 0;
+                std::vector<char> buffer;
+
+                // objects are copied through their packed form, because the shared buffers of an object
+                // have to be allocated in the segment of the destination database
+                for (const auto &obj : indices) {
+                    buffer = fc::raw::pack(obj);
+                    load_object(dest, buffer, next);
+                    ++count;
+                }
+
+                restore_next_id(dest, next);
+                return count;
+            }
+
+            uint64_t hash_objects() const override {
+                uint64_t hash = 0;
+                for (const auto &obj : _db.get_index<MultiIndexType>().indices()) {
+                    hash ^= object_state_hash(obj);
+                }
+                return hash;
+            }
+
+            index_memory_usage memory_usage() const override {
+                static const uint64_t indices_count =
+                        boost::mpl::size<typename MultiIndexType::index_specifier_type_list>::value;
+
+                index_memory_usage result;
+                result.name = name();
+
+                for (const auto &obj : _db.get_index<MultiIndexType>().indices()) {
+                    result.dynamic_bytes += detail::dynamic_size(obj);
+                    ++result.count;
+                }
+
+                result.object_bytes = result.count * sizeof(value_type);
+                result.node_bytes = result.count * indices_count * 3 * sizeof(void *);
+                result.total_bytes = result.object_bytes + result.dynamic_bytes + result.node_bytes;
+                return result;
+            }
+
+        private:
+            /**
+             * chainbase moves its id counter only when an object is created, and loaded objects keep their
+             * ids, so the counter is moved past the ids of removed objects first. The placeholders are
+             * created while the index is still empty, where they can not violate a unique key, and they
+             * are not unpacked.
+             */
+            void skip_removed_ids(chainbase::database &db, uint64_t count, int64_t next_id) const {
+                FC_ASSERT(db.get_index<MultiIndexType>().indices().empty(), "Index ${i} is not empty", ("i", name()));
+                FC_ASSERT(next_id >= int64_t(count), "Index ${i} has more objects than ids", ("i", name()));
+
+                for (int64_t i = count; i < next_id; ++i) {
+                    db.remove(db.create<value_type>([](value_type &) {
+                    }));
+                }
+            }
+
+            /// Records the next id in the loaded index, if its last objects were removed before the export
+            void restore_next_id(chainbase::database &db, int64_t next_id) const {
+                const auto &indices = db.get_index<MultiIndexType>().indices();
+                int64_t next = indices.empty() ? 0 : indices.rbegin()->id._id + 1;
+                if (next < next_id) {
+                    record_next_id(db, type_id(), next_id);
+                }
+            }
+
+            void load_object(chainbase::database &db, const std::vector<char> &buffer, int64_t next_id) const {
+                // the packed object overwrites the id assigned by chainbase
+                const value_type &obj = db.create<value_type>([&](value_type &o) {
+                    fc::datastream<const char *> ds(buffer.data(), buffer.size());
+                    fc::raw::unpack(ds, o);
+                });
+
+                FC_ASSERT(obj.id._id < next_id, "Object ${o} of index ${i} is beyond the next id ${n}",
+                          ("o", obj.id._id)("i", name())("n", next_id));
+            }
+
+            chainbase::database &_db;
+        };
+
+    }
+} // golos::chain
+
+FC_REFLECT((golos::chain::index_memory_usage), (name)(count)(object_bytes)(dynamic_bytes)(node_bytes)(total_bytes))
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <golos/protocol/asset.hpp>
+#include <golos/protocol/types.hpp>
+
+namespace golos {
+    namespace chain {
+
+        class database;
+
+        /**
+         * @brief Incremental evaluation of database::validate_invariants()
+         *
+         * The objects participating in the supply invariants are walked in id order, at most
+         * @ref chunk_size objects per call of step(). Totals are accumulated between the calls and
+         * compared with the dynamic global properties by the last step, so the caller may release
+         * the database lock between steps as long as the state does not change in between.
+         */
+        class invariant_checker {
+        public:
+            /**
+             * @param chunk_size Maximum number of objects visited by one step(), 0 means the whole
+             *                   check is done by a single step()
+             */
+            invariant_checker(const database &db, uint32_t chunk_size = 0);
+
+            /**
+             * Visits the next chunk of objects, throws fc::exception when an invariant is violated
+             * @return true when the check is complete
+             */
+            bool step();
+
+            bool done() const {
+                return _stage == finished;
+            }
+
+        private:
+            enum stage_type {
+                witnesses,
+                accounts,
+                convert_requests,
+                limit_orders,
+                escrows,
+                savings_withdraws,
+                reward_funds,
+                totals,
+                finished
+            };
+
+            template<typename MultiIndexType, typename Visitor>
+            bool walk(uint32_t &budget, Visitor &&visit);
+
+            const database &_db;
+            const uint32_t _chunk_size;
+
+            stage_type _stage = witnesses;
+            int64_t _next_id = 0;
+
+            protocol::asset<0, 17, 0> _total_supply;
+            protocol::asset<0, 17, 0> _total_sbd;
+            protocol::asset<0, 17, 0> _total_vesting;
+            protocol::share_type _total_vsf_votes = 0;
+        };
+
+    }
+} // golos::chain
@@ -6,6 +6,7 @@
 #include <golos/protocol/authority.hpp>
 #include <golos/protocol/operations/steem_operations.hpp>
 
+#include <golos/chain/objects/asset_object.hpp>
 #include <golos/chain/objects/operation_history_object.hpp>
 #include <golos/chain/steem_object_types.hpp>
 #include <golos/chain/shared_authority.hpp>
@@ -90,6 +91,13 @@ namespace golos {
          *
          * This object is indexed on owner and asset_type so that black swan
          * events in asset_type can be processed quickly.
+         *
+         * The indexes are keyed by @ref asset_id, the id of the asset_object with
+         * the name @ref asset_name, so lookups compare integers instead of symbol
+         * names. The name is kept to build the API representation of the balance.
+         *
+         * asset_id is reflected, state snapshots need it. The APIs return
+         * account_balance_api_obj, which leaves it out.
          */
         class account_balance_object
                 : public object<account_balance_object_type, account_balance_object> {
@@ -107,6 +115,7 @@ namespace golos {
 
             account_name_type owner;
             protocol::asset_name_type asset_name;
+            asset_object::id_type asset_id;
             share_type balance = 0; ///< total liquid shares held by this account
 
             protocol::asset<0, 17, 0> get_balance() const {
@@ -139,31 +148,26 @@ namespace golos {
 
             /// The account's name. This name must be unique among all account names on the graph. May not be empty.
             account_name_type name;
-            public_key_type memo_key;
-            shared_string json_metadata;
             account_name_type proxy;
 
-            time_point_sec last_account_update;
+            /**
+             * Members are declared hot first: the fields below are touched by votes, transfers and vesting
+             * changes and are kept together in the leading cache lines, the rarely used ones follow.
+             * The serialized order is defined by FC_REFLECT and does not depend on the declaration order.
+             */
+            protocol::asset<0, 17, 0> balance = protocol::asset<0, 17, 0>(0, STEEM_SYMBOL_NAME);  ///< total liquid shares held by this account
+            protocol::asset<0, 17, 0> vesting_shares = protocol::asset<0, 17, 0>(0, VESTS_SYMBOL); ///< total vesting shares held by this account, controls its voting power
+            protocol::asset<0, 17, 0> delegated_vesting_shares = protocol::asset<0, 17, 0>(0, VESTS_SYMBOL);
+            protocol::asset<0, 17, 0> received_vesting_shares = protocol::asset<0, 17, 0>(0, VESTS_SYMBOL);
 
-            time_point_sec created;
-            bool mined = true;
-            bool owner_challenged = false;
-            bool active_challenged = false;
-            time_point_sec last_owner_proved = time_point_sec::min();
-            time_point_sec last_active_proved = time_point_sec::min();
-            account_name_type recovery_account;
-            account_name_type reset_account = STEEMIT_NULL_ACCOUNT;
-            time_point_sec last_account_recovery;
-            uint32_t comment_count = 0;
-            uint32_t lifetime_vote_count = 0;
-            uint32_t post_count = 0;
+            fc::array<share_type, STEEMIT_MAX_PROXY_RECURSION_DEPTH> proxied_vsf_votes;// = std::vector<share_type>( STEEMIT_MAX_PROXY_RECURSION_DEPTH, 0 ); ///< the total VFS votes proxied to this account
 
-            bool can_vote = true;
-            uint16_t voting_power = STEEMIT_100_PERCENT;   ///< current voting power of this account, it falls after every vote
             time_point_sec last_vote_time; ///< used to increase the voting power of this account the longer it goes without voting.
+            uint16_t voting_power = STEEMIT_100_PERCENT;   ///< current voting power of this account, it falls after every vote
+            uint16_t witnesses_voted_for = 0;
+            bool can_vote = true;
 
-            protocol::asset<0, 17, 0> balance = protocol::asset<0, 17, 0>(0, STEEM_SYMBOL_NAME);  ///< total liquid shares held by this account
-            protocol::asset<0, 17, 0> savings_balance = protocol::asset<0, 17, 0>(0, STEEM_SYMBOL_NAME);  ///< total liquid shares held by this account
+            time_point_sec last_post;
 
             /**
              *  SBD Deposits pay interest based upon the interest rate set by witnesses. The purpose of these
@@ -193,12 +197,7 @@ namespace golos {
             uint8_t savings_withdraw_requests = 0;
             ///@}
 
-            share_type curation_rewards = 0;
-            share_type posting_rewards = 0;
-
-            protocol::asset<0, 17, 0> vesting_shares = protocol::asset<0, 17, 0>(0, VESTS_SYMBOL); ///< total vesting shares held by this account, controls its voting power
-            protocol::asset<0, 17, 0> delegated_vesting_shares = protocol::asset<0, 17, 0>(0, VESTS_SYMBOL);
-            protocol::asset<0, 17, 0> received_vesting_shares = protocol::asset<0, 17, 0>(0, VESTS_SYMBOL);
+            protocol::asset<0, 17, 0> savings_balance = protocol::asset<0, 17, 0>(0, STEEM_SYMBOL_NAME);  ///< total liquid shares held by this account
 
             protocol::asset<0, 17, 0> vesting_withdraw_rate = protocol::asset<0, 17, 0>(0, VESTS_SYMBOL); ///< at the time this is updated it can be at most vesting_shares/104
             time_point_sec next_vesting_withdrawal = fc::time_point_sec::maximum(); ///< after every withdrawal this is incremented by 1 week
@@ -206,11 +205,27 @@ namespace golos {
             share_type to_withdraw = 0; /// Might be able to look this up with operation history.
             uint16_t withdraw_routes = 0;
 
-            fc::array<share_type, STEEMIT_MAX_PROXY_RECURSION_DEPTH> proxied_vsf_votes;// = std::vector<share_type>( STEEMIT_MAX_PROXY_RECURSION_DEPTH, 0 ); ///< the total VFS votes proxied to this account
+            share_type curation_rewards = 0;
+            share_type posting_rewards = 0;
 
-            uint16_t witnesses_voted_for = 0;
+            uint32_t comment_count = 0;
+            uint32_t lifetime_vote_count = 0;
+            uint32_t post_count = 0;
 
-            time_point_sec last_post;
+            public_key_type memo_key;
+            shared_string json_metadata;
+
+            time_point_sec last_account_update;
+
+            time_point_sec created;
+            time_point_sec last_owner_proved = time_point_sec::min();
+            time_point_sec last_active_proved = time_point_sec::min();
+            bool mined = true;
+            bool owner_challenged = false;
+            bool active_challenged = false;
+            account_name_type recovery_account;
+            account_name_type reset_account = STEEMIT_NULL_ACCOUNT;
+            time_point_sec last_account_recovery;
 
             /**
              * This is a set of assets which the account is allowed to have.
@@ -419,18 +434,18 @@ namespace golos {
                                 composite_key<
                                         account_balance_object,
                                         member<account_balance_object, account_name_type, &account_balance_object::owner>,
-                                        member<account_balance_object, protocol::asset_name_type, &account_balance_object::asset_name>
+                                        member<account_balance_object, asset_object::id_type, &account_balance_object::asset_id>
                                 >
                         >,
                         ordered_unique<tag<by_asset_balance>,
                                 composite_key<
                                         account_balance_object,
-                                        member<account_balance_object, protocol::asset_name_type, &account_balance_object::asset_name>,
+                                        member<account_balance_object, asset_object::id_type, &account_balance_object::asset_id>,
                                         member<account_balance_object, share_type, &account_balance_object::balance>,
                                         member<account_balance_object, account_name_type, &account_balance_object::owner>
                                 >,
                                 composite_key_compare<
-                                        std::less<protocol::asset_name_type>,
+                                        std::less<asset_object::id_type>,
                                         std::greater<share_type>,
                                         std::less<account_name_type>
                                 >
@@ -467,6 +482,9 @@ namespace golos {
                         ordered_unique<tag<by_name>,
                                 member<account_object, account_name_type, &account_object::name>,
                                 protocol::string_less>,
+                        hashed_unique<tag<by_hashed_name>,
+                                member<account_object, account_name_type, &account_object::name>,
+                                account_name_hash>,
                         ordered_unique<tag<by_proxy>,
                                 composite_key<account_object,
                                         member<account_object, account_name_type, &account_object::proxy>,
@@ -539,14 +557,9 @@ namespace golos {
                 indexed_by<
                         ordered_unique<tag<by_id>,
                                 member<account_authority_object, account_authority_object::id_type, &account_authority_object::id>>,
-                        ordered_unique<tag<by_account>,
-                                composite_key<account_authority_object,
-                                        member<account_authority_object, account_name_type, &account_authority_object::account>,
-                                        member<account_authority_object, account_authority_object::id_type, &account_authority_object::id>
-                                >,
-                                composite_key_compare<
-                                        std::less<account_name_type>, std::less<account_authority_object::id_type>>
-                        >,
+                        hashed_unique<tag<by_account>,
+                                member<account_authority_object, account_name_type, &account_authority_object::account>,
+                                account_name_hash>,
                         ordered_unique<tag<by_last_owner_update>,
                                 composite_key<account_authority_object,
                                         member<account_authority_object, time_point_sec, &account_authority_object::last_owner_update>,
@@ -773,7 +786,7 @@ FC_REFLECT((golos::chain::change_recovery_account_request_object),
         (id)(account_to_recover)(recovery_account)(effective_on))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::change_recovery_account_request_object, golos::chain::change_recovery_account_request_index)
 
-FC_REFLECT((golos::chain::account_balance_object), (id)(owner)(asset_name)(balance))
+FC_REFLECT((golos::chain::account_balance_object), (id)(owner)(asset_name)(asset_id)(balance))
 CHAINBASE_SET_INDEX_TYPE(golos::chain::account_balance_object, golos::chain::account_balance_index)
 
 FC_REFLECT((golos::chain::account_statistics_object),
@@ -8,6 +8,8 @@
 
 #include <boost/multi_index/composite_key.hpp>
 
+#include <cstring>
+
 
 namespace golos {
     namespace chain {
@@ -31,6 +33,36 @@ namespace golos {
             }
         };
 
+        struct strcmp_equal {
+            bool operator()(const shared_string &a, const shared_string &b) const {
+                return equal(a.data(), a.size(), b.data(), b.size());
+            }
+
+            bool operator()(const shared_string &a, const string &b) const {
+                return equal(a.data(), a.size(), b.data(), b.size());
+            }
+
+            bool operator()(const string &a, const shared_string &b) const {
+                return equal(a.data(), a.size(), b.data(), b.size());
+            }
+
+        private:
+            inline bool equal(const char *a, std::size_t a_size, const char *b, std::size_t b_size) const {
+                return a_size == b_size && std::memcmp(a, b, a_size) == 0;
+            }
+        };
+
+        /// Hash matching strcmp_equal, shared_string and string keys with equal contents hash equally
+        struct strcmp_hash {
+            std::size_t operator()(const shared_string &s) const {
+                return fc::city_hash64(s.data(), s.size());
+            }
+
+            std::size_t operator()(const string &s) const {
+                return fc::city_hash64(s.data(), s.size());
+            }
+        };
+
         /**
          *  Used to track the trending categories
          */
@@ -100,9 +132,9 @@ namespace golos {
 
             template<typename Constructor, typename Allocator>
             comment_object(Constructor &&c, allocator <Allocator> a)
-                    : category(a),
+                    : permlink(a),
+                      category(a),
                       parent_permlink(a),
-                      permlink(a),
                       title(a),
                       body(a),
                       json_metadata(a),
@@ -112,29 +144,14 @@ namespace golos {
 
             id_type id;
 
-            shared_string category;
-            account_name_type parent_author;
-            shared_string parent_permlink;
             account_name_type author;
             shared_string permlink;
 
-            shared_string title;
-            shared_string body;
-            shared_string json_metadata;
-            time_point_sec last_update;
-            time_point_sec created;
-            time_point_sec active; ///< the last time this post was "touched" by voting or reply
-            time_point_sec last_payout;
-
-            uint16_t depth = 0; ///< used to track max nested depth
-            uint32_t children = 0; ///< used to track the total number of children, grandchildren, etc...
-
             /**
-             *  Used to track the total rshares^2 of all children, this is used for indexing purposes. A discussion
-             *  that has a nested comment of high value should promote the entire discussion so that the comment can
-             *  be reviewed.
+             * Members are declared hot first: the fields below are read or updated by votes and by
+             * the cashout processing and are kept together in the leading cache lines, the content
+             * and the payout statistics follow. The serialized order is defined by FC_REFLECT.
              */
-            fc::uint128_t children_rshares2;
 
             /// index on pending_payout for "things happning now... needs moderation"
             /// TRENDING = UNCLAIMED + PENDING
@@ -147,7 +164,38 @@ namespace golos {
             time_point_sec max_cashout_time;
             uint64_t total_vote_weight = 0; /// the total weight of voting rewards, used to calculate pro-rata share of curation payouts
 
+            time_point_sec active; ///< the last time this post was "touched" by voting or reply
+            int32_t net_votes = 0;
             uint16_t reward_weight = 0;
+            uint16_t percent_steem_dollars = STEEMIT_100_PERCENT; /// the percent of Golos Dollars to key, unkept amounts will be received as Golos Power
+            bool allow_replies = true;      /// allows a post to disable replies.
+            bool allow_votes = true;      /// allows a post to receive votes;
+            bool allow_curation_rewards = true;
+
+            id_type root_comment;
+
+            /**
+             *  Used to track the total rshares^2 of all children, this is used for indexing purposes. A discussion
+             *  that has a nested comment of high value should promote the entire discussion so that the comment can
+             *  be reviewed.
+             */
+            fc::uint128_t children_rshares2;
+
+            protocol::asset<0, 17, 0> max_accepted_payout = protocol::asset<0, 17, 0>(1000000000, SBD_SYMBOL_NAME);       /// SBD value of the maximum payout this post will receive
+
+            uint16_t depth = 0; ///< used to track max nested depth
+            uint32_t children = 0; ///< used to track the total number of children, grandchildren, etc...
+
+            shared_string category;
+            account_name_type parent_author;
+            shared_string parent_permlink;
+
+            shared_string title;
+            shared_string body;
+            shared_string json_metadata;
+            time_point_sec last_update;
+            time_point_sec created;
+            time_point_sec last_payout;
 
             /** tracks the total payout this comment has received over time, measured in SBD */
             protocol::asset<0, 17, 0> total_payout_value = protocol::asset<0, 17, 0>(0, SBD_SYMBOL_NAME);
@@ -157,16 +205,6 @@ namespace golos {
 
             share_type author_rewards = 0;
 
-            int32_t net_votes = 0;
-
-            id_type root_comment;
-
-            protocol::asset<0, 17, 0> max_accepted_payout = protocol::asset<0, 17, 0>(1000000000, SBD_SYMBOL_NAME);       /// SBD value of the maximum payout this post will receive
-            uint16_t percent_steem_dollars = STEEMIT_100_PERCENT; /// the percent of Golos Dollars to key, unkept amounts will be received as Golos Power
-            bool allow_replies = true;      /// allows a post to disable replies.
-            bool allow_votes = true;      /// allows a post to receive votes;
-            bool allow_curation_rewards = true;
-
             boost::interprocess::vector <protocol::beneficiary_route_type, allocator<protocol::beneficiary_route_type>> beneficiaries;
         };
 
@@ -272,13 +310,15 @@ namespace golos {
         member<comment_object, comment_object::id_type, &comment_object::id>
         >
         >,
-        ordered_unique <tag<by_permlink>, /// used by consensus to find posts referenced in ops
+        /// used by consensus to find posts referenced in ops, point lookups only so it is hashed
+        hashed_unique <tag<by_permlink>,
         composite_key<comment_object,
                 member <
                 comment_object, account_name_type, &comment_object::author>,
         member<comment_object, shared_string, &comment_object::permlink>
         >,
-        composite_key_compare <std::less<account_name_type>, strcmp_less>
+        composite_key_hash <account_name_hash, strcmp_hash>,
+        composite_key_equal_to <std::equal_to<account_name_type>, strcmp_equal>
         >,
         ordered_unique <tag<by_root>,
         composite_key<comment_object,
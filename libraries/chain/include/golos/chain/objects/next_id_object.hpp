@@ -0,0 +1,76 @@
+#pragma once
+
+#include <golos/chain/steem_object_types.hpp>
+
+namespace golos {
+    namespace chain {
+
+        /**
+         *  @brief Holds the next object id of an index whose last object was removed
+         *  @ingroup object
+         *
+         *  chainbase never reuses the ids of removed objects and keeps its id counter private, so once
+         *  the object with the highest id is removed the next id can not be told from the index itself.
+         *  database::remove() records it here. The object lives in chainbase, so undo restores it
+         *  together with the objects. It is not a part of the consensus state and is never included
+         *  into the checksum or state snapshots, snapshots carry the next ids in their manifest.
+         */
+        class next_id_object
+                : public object<next_id_object_type, next_id_object> {
+        public:
+            template<typename Constructor, typename Allocator>
+            next_id_object(Constructor &&c, allocator <Allocator> a) {
+                c(*this);
+            }
+
+            next_id_object() {
+            };
+
+            id_type id;
+            /// type_id of the objects of the index
+            uint16_t object_type = 0;
+            int64_t next_id = 0;
+        };
+
+        struct by_object_type;
+
+        typedef multi_index_container <
+        next_id_object,
+        indexed_by<
+                ordered_unique < tag < by_id>,
+        member<next_id_object, next_id_object::id_type, &next_id_object::id>>,
+        ordered_unique <tag<by_object_type>,
+        member<next_id_object, uint16_t, &next_id_object::object_type>>
+        >,
+        allocator <next_id_object>
+        >
+        next_id_index;
+
+        /// Next id recorded for the index of the object type, 0 when none was recorded
+        inline int64_t recorded_next_id(const chainbase::database &db, uint16_t object_type) {
+            const auto &idx = db.get_index<next_id_index>().indices().get<by_object_type>();
+            auto itr = idx.find(object_type);
+            return itr == idx.end() ? 0 : itr->next_id;
+        }
+
+        /// Raises the next id recorded for the index of the object type
+        inline void record_next_id(chainbase::database &db, uint16_t object_type, int64_t next_id) {
+            const auto &idx = db.get_index<next_id_index>().indices().get<by_object_type>();
+            auto itr = idx.find(object_type);
+            if (itr == idx.end()) {
+                db.create<next_id_object>([&](next_id_object &o) {
+                    o.object_type = object_type;
+                    o.next_id = next_id;
+                });
+            } else if (itr->next_id < next_id) {
+                db.modify(*itr, [&](next_id_object &o) {
+                    o.next_id = next_id;
+                });
+            }
+        }
+
+    }
+} // golos::chain
+
+FC_REFLECT((golos::chain::next_id_object), (id)(object_type)(next_id))
+CHAINBASE_SET_INDEX_TYPE(golos::chain::next_id_object, golos::chain::next_id_index)
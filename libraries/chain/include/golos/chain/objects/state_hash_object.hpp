@@ -0,0 +1,47 @@
+#pragma once
+
+#include <golos/chain/steem_object_types.hpp>
+
+namespace golos {
+    namespace chain {
+
+        /**
+         *  @brief Holds the incremental checksum of the chain state
+         *  @ingroup object
+         *
+         *  The checksum is the XOR of hashes of all objects in the registered indexes, it is
+         *  updated on every create/modify/remove while state hashing is enabled. The object
+         *  itself lives in chainbase, so undoing a block or a pending transaction restores the
+         *  checksum together with the objects. It is not a part of the consensus state and is
+         *  never included into the checksum or state snapshots.
+         */
+        class state_hash_object
+                : public object<state_hash_object_type, state_hash_object> {
+        public:
+            template<typename Constructor, typename Allocator>
+            state_hash_object(Constructor &&c, allocator <Allocator> a) {
+                c(*this);
+            }
+
+            state_hash_object() {
+            };
+
+            id_type id;
+            uint64_t hash = 0;
+        };
+
+        typedef multi_index_container <
+        state_hash_object,
+        indexed_by<
+                ordered_unique < tag < by_id>,
+        member<state_hash_object, state_hash_object::id_type, &state_hash_object::id>>
+        >,
+        allocator <state_hash_object>
+        >
+        state_hash_index;
+
+    }
+} // golos::chain
+
+FC_REFLECT((golos::chain::state_hash_object), (id)(hash))
+CHAINBASE_SET_INDEX_TYPE(golos::chain::state_hash_object, golos::chain::state_hash_index)
@@ -53,9 +53,10 @@ namespace golos {
             id_type id;
 
             uint32_t escrow_id = 20;
-            account_name_type from;
-            account_name_type to;
-            account_name_type agent;
+            /// Parties are keyed by object ids, names are resolved once per operation by the caller
+            object_id<account_object> from;
+            object_id<account_object> to;
+            object_id<account_object> agent;
             time_point_sec ratification_deadline;
             time_point_sec escrow_expiration;
             protocol::asset<0, 17, 0>  sbd_balance;
@@ -83,8 +84,9 @@ namespace golos {
 
             id_type id;
 
-            account_name_type from;
-            account_name_type to;
+            /// Accounts are keyed by object ids, names are resolved once per operation by the caller
+            object_id<account_object> from;
+            object_id<account_object> to;
             shared_string memo;
             uint32_t request_id = 0;
             protocol::asset<0, 17, 0>  amount;
@@ -293,13 +295,13 @@ namespace golos {
         struct by_sbd_balance;
         typedef multi_index_container <escrow_object, indexed_by<ordered_unique < tag < by_id>, member<escrow_object,
                 escrow_object::id_type, &escrow_object::id>>,
-        ordered_unique <tag<by_from_id>, composite_key<escrow_object, member < escrow_object, account_name_type,
+        ordered_unique <tag<by_from_id>, composite_key<escrow_object, member < escrow_object, object_id<account_object>,
                 &escrow_object::from>, member<escrow_object, uint32_t, &escrow_object::escrow_id>>
         >,
-        ordered_unique <tag<by_to>, composite_key<escrow_object, member < escrow_object, account_name_type,
+        ordered_unique <tag<by_to>, composite_key<escrow_object, member < escrow_object, object_id<account_object>,
                 &escrow_object::to>, member<escrow_object, escrow_object::id_type, &escrow_object::id>>
         >,
-        ordered_unique <tag<by_agent>, composite_key<escrow_object, member < escrow_object, account_name_type,
+        ordered_unique <tag<by_agent>, composite_key<escrow_object, member < escrow_object, object_id<account_object>,
                 &escrow_object::agent>, member<escrow_object, escrow_object::id_type, &escrow_object::id>>
         >,
         ordered_unique <tag<by_ratification_deadline>, composite_key<escrow_object, const_mem_fun < escrow_object, bool,
@@ -323,17 +325,17 @@ namespace golos {
         typedef multi_index_container <savings_withdraw_object, indexed_by<ordered_unique < tag < by_id>, member<
                 savings_withdraw_object, savings_withdraw_object::id_type, &savings_withdraw_object::id>>,
         ordered_unique <tag<by_from_rid>, composite_key<savings_withdraw_object, member < savings_withdraw_object,
-                account_name_type, &savings_withdraw_object::from>, member<savings_withdraw_object, uint32_t,
+                object_id<account_object>, &savings_withdraw_object::from>, member<savings_withdraw_object, uint32_t,
                 &savings_withdraw_object::request_id>>
         >,
         ordered_unique <tag<by_to_complete>, composite_key<savings_withdraw_object, member < savings_withdraw_object,
-                account_name_type, &savings_withdraw_object::to>, member<savings_withdraw_object, time_point_sec,
+                object_id<account_object>, &savings_withdraw_object::to>, member<savings_withdraw_object, time_point_sec,
                 &savings_withdraw_object::complete>, member<savings_withdraw_object, savings_withdraw_object::id_type,
                 &savings_withdraw_object::id>>
         >,
         ordered_unique <tag<by_complete_from_rid>, composite_key<savings_withdraw_object,
                 member < savings_withdraw_object, time_point_sec, &savings_withdraw_object::complete>, member<
-                savings_withdraw_object, account_name_type, &savings_withdraw_object::from>, member<
+                savings_withdraw_object, object_id<account_object>, &savings_withdraw_object::from>, member<
                 savings_withdraw_object, uint32_t, &savings_withdraw_object::request_id>>
         >
         >,
@@ -125,8 +125,9 @@ namespace golos {
 
             id_type id;
 
-            account_name_type witness;
-            account_name_type account;
+            /// Votes are keyed by object ids, names are resolved once per operation by the caller
+            object_id<witness_object> witness;
+            object_id<account_object> account;
 
             fc::time_point_sec created;
         };
@@ -173,6 +174,8 @@ namespace golos {
                 ordered_unique<tag<by_id>, member<witness_object, witness_object::id_type, &witness_object::id>>,
                 ordered_non_unique<tag<by_work>, member<witness_object, digest_type, &witness_object::last_work>>,
                 ordered_unique<tag<by_name>, member<witness_object, account_name_type, &witness_object::owner>>,
+                hashed_unique<tag<by_hashed_name>, member<witness_object, account_name_type, &witness_object::owner>,
+                        account_name_hash>,
                 ordered_non_unique<tag<by_pow>, member<witness_object, uint64_t, &witness_object::pow_worker>>,
                 ordered_unique<tag<by_vote_name>,
                         composite_key<witness_object, member<witness_object, share_type, &witness_object::votes>,
@@ -191,13 +194,13 @@ namespace golos {
         typedef multi_index_container<witness_vote_object, indexed_by<ordered_unique<tag<by_id>,
                 member<witness_vote_object, witness_vote_object::id_type, &witness_vote_object::id>>,
                 ordered_unique<tag<by_account_witness>, composite_key<witness_vote_object,
-                        member<witness_vote_object, account_name_type, &witness_vote_object::account>,
-                        member<witness_vote_object, account_name_type, &witness_vote_object::witness> >,
-                        composite_key_compare<std::less<account_name_type>, std::less<account_name_type>>>,
+                        member<witness_vote_object, object_id<account_object>, &witness_vote_object::account>,
+                        member<witness_vote_object, object_id<witness_object>, &witness_vote_object::witness> >,
+                        composite_key_compare<std::less<object_id<account_object>>, std::less<object_id<witness_object>>>>,
                 ordered_unique<tag<by_witness_account>, composite_key<witness_vote_object,
-                        member<witness_vote_object, account_name_type, &witness_vote_object::witness>,
-                        member<witness_vote_object, account_name_type, &witness_vote_object::account> >,
-                        composite_key_compare<std::less<account_name_type>, std::less<account_name_type>>>,
+                        member<witness_vote_object, object_id<witness_object>, &witness_vote_object::witness>,
+                        member<witness_vote_object, object_id<account_object>, &witness_vote_object::account> >,
+                        composite_key_compare<std::less<object_id<witness_object>>, std::less<object_id<account_object>>>>,
                 ordered_non_unique<tag<by_created_time>,
                         member<witness_vote_object, fc::time_point_sec, &witness_vote_object::created>>>,
                 allocator<witness_vote_object> > witness_vote_index;
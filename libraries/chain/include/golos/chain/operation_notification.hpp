@@ -4,6 +4,9 @@
 
 #include <golos/chain/steem_object_types.hpp>
 
+#include <type_traits>
+#include <vector>
+
 namespace golos {
     namespace chain {
 
@@ -16,8 +19,152 @@ namespace golos {
             uint32_t trx_in_block = 0;
             uint16_t op_in_trx = 0;
             uint64_t virtual_op = 0;
+            /// Head block time when the operation was applied
+            fc::time_point_sec timestamp;
             const operation &op;
         };
 
+        /**
+         * Copy of an operation_notification owning the operation, used to hand operations over to
+         * plugins after the block is applied
+         */
+        struct operation_record {
+            operation_record() = default;
+
+            operation_record(const operation_notification &note)
+                    : trx_id(note.trx_id), block(note.block), trx_in_block(note.trx_in_block),
+                      op_in_trx(note.op_in_trx), virtual_op(note.virtual_op), timestamp(note.timestamp), op(note.op) {
+            }
+
+            /// The notification refers to the operation of the record, so it must not outlive the record
+            operation_notification notification() const {
+                operation_notification note(op);
+                note.trx_id = trx_id;
+                note.block = block;
+                note.trx_in_block = trx_in_block;
+                note.op_in_trx = op_in_trx;
+                note.virtual_op = virtual_op;
+                note.timestamp = timestamp;
+                return note;
+            }
+
+            transaction_id_type trx_id;
+            uint32_t block = 0;
+            uint32_t trx_in_block = 0;
+            uint16_t op_in_trx = 0;
+            uint64_t virtual_op = 0;
+            fc::time_point_sec timestamp;
+            operation op;
+        };
+
+        namespace detail {
+            template<bool... Values>
+            struct any_of : std::false_type {
+            };
+
+            template<bool First, bool... Rest>
+            struct any_of<First, Rest...> : std::integral_constant<bool, First || any_of<Rest...>::value> {
+            };
+
+            template<template<uint8_t, uint8_t, uint16_t> class A, template<uint8_t, uint8_t, uint16_t> class B>
+            struct is_same_operation_template : std::false_type {
+            };
+
+            template<template<uint8_t, uint8_t, uint16_t> class A>
+            struct is_same_operation_template<A, A> : std::true_type {
+            };
+
+            template<typename Operation>
+            struct is_virtual : std::false_type {
+            };
+
+            template<template<uint8_t, uint8_t, uint16_t> class Operation, uint8_t Major, uint8_t Hardfork, uint16_t Release>
+            struct is_virtual<Operation<Major, Hardfork, Release>>
+                    : std::is_base_of<protocol::virtual_operation<Major, Hardfork, Release>,
+                                      Operation<Major, Hardfork, Release>> {
+            };
+
+            template<typename OperationSet, typename Variant>
+            struct operation_set_tags;
+
+            template<typename OperationSet, typename... Operations>
+            struct operation_set_tags<OperationSet, fc::static_variant<Operations...>> {
+                static std::vector<std::size_t> get() {
+                    const bool matches[] = {OperationSet::template contains<Operations>::value...};
+
+                    std::vector<std::size_t> result;
+                    for (std::size_t i = 0; i < sizeof...(Operations); ++i) {
+                        if (matches[i]) {
+                            result.push_back(i);
+                        }
+                    }
+                    return result;
+                }
+            };
+        }
+
+        /**
+         * Compile time set of operations matching all versions of the listed operation templates,
+         * e.g. operation_templates<comment_operation, vote_operation>
+         */
+        template<template<uint8_t, uint8_t, uint16_t> class... Operations>
+        struct operation_templates {
+            template<typename Operation>
+            struct contains : std::false_type {
+            };
+
+            template<template<uint8_t, uint8_t, uint16_t> class Operation, uint8_t Major, uint8_t Hardfork, uint16_t Release>
+            struct contains<Operation<Major, Hardfork, Release>>
+                    : detail::any_of<detail::is_same_operation_template<Operation, Operations>::value...> {
+            };
+        };
+
+        /// Compile time set of the listed unversioned operation types, e.g. operation_types<custom_json_operation>
+        template<typename... Types>
+        struct operation_types {
+            template<typename Operation>
+            struct contains : detail::any_of<std::is_same<Operation, Types>::value...> {
+            };
+        };
+
+        /// Set of all operations
+        struct all_operations {
+            template<typename Operation>
+            struct contains : std::true_type {
+            };
+        };
+
+        /// Set of the operations transactions may contain, without the virtual operations
+        struct real_operations {
+            template<typename Operation>
+            struct contains : std::integral_constant<bool, !detail::is_virtual<Operation>::value> {
+            };
+        };
+
+        /// Operations of Set which are not in Excluded
+        template<typename Set, typename Excluded>
+        struct operations_except {
+            template<typename Operation>
+            struct contains : std::integral_constant<bool, Set::template contains<Operation>::value &&
+                                                           !Excluded::template contains<Operation>::value> {
+            };
+        };
+
+        /// Union of operation sets
+        template<typename... Sets>
+        struct operation_sets {
+            template<typename Operation>
+            struct contains : detail::any_of<Sets::template contains<Operation>::value...> {
+            };
+        };
+
+        /// Tags of the operation variant alternatives which belong to OperationSet
+        template<typename OperationSet>
+        std::vector<std::size_t> operation_set_tags() {
+            return detail::operation_set_tags<OperationSet, operation>::get();
+        }
+
     }
 }
+
+FC_REFLECT((golos::chain::operation_record), (trx_id)(block)(trx_in_block)(op_in_trx)(virtual_op)(timestamp)(op))
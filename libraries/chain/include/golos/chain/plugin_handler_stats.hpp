@@ -0,0 +1,68 @@
+#pragma once
+
+#include <fc/reflect/reflect.hpp>
+#include <fc/time.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <string>
+
+namespace golos {
+    namespace chain {
+
+        /**
+         * @brief Cost of the handlers a plugin connected to the database signals
+         */
+        struct plugin_handler_stats {
+            std::string plugin;
+            /// Number of handler invocations
+            uint64_t calls = 0;
+            /// Number of invocations which ended with an exception
+            uint64_t exceptions = 0;
+            /// Total time spent in the handlers, microseconds
+            uint64_t total_time = 0;
+            /// Longest single invocation, microseconds
+            uint64_t max_time = 0;
+        };
+
+        namespace detail {
+            class plugin_handler_timer {
+            public:
+                plugin_handler_timer(plugin_handler_stats &stats) : _stats(stats), _start(fc::time_point::now()) {
+                }
+
+                ~plugin_handler_timer() {
+                    const uint64_t elapsed = (fc::time_point::now() - _start).count();
+                    ++_stats.calls;
+                    _stats.total_time += elapsed;
+                    _stats.max_time = std::max(_stats.max_time, elapsed);
+                }
+
+            private:
+                plugin_handler_stats &_stats;
+                const fc::time_point _start;
+            };
+        }
+
+        /**
+         * Wraps a signal handler to account its invocations to @p stats. Exceptions are counted and
+         * rethrown, so STEEMIT_TRY_NOTIFY handles them as before.
+         */
+        template<typename... Args>
+        std::function<void(Args...)> measured_handler(plugin_handler_stats &stats,
+                                                      std::function<void(Args...)> handler) {
+            return [&stats, handler](Args... args) {
+                detail::plugin_handler_timer timer(stats);
+                try {
+                    handler(args...);
+                } catch (...) {
+                    ++stats.exceptions;
+                    throw;
+                }
+            };
+        }
+
+    }
+} // golos::chain
+
+FC_REFLECT((golos::chain::plugin_handler_stats), (plugin)(calls)(exceptions)(total_time)(max_time))
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <golos/protocol/types.hpp>
+
+#include <fc/crypto/sha256.hpp>
+#include <fc/filesystem.hpp>
+#include <fc/reflect/reflect.hpp>
+#include <fc/time.hpp>
+
+#include <string>
+#include <vector>
+
+#define STATE_SNAPSHOT_VERSION 3
+#define STATE_SNAPSHOT_MANIFEST "manifest.json"
+
+namespace golos {
+    namespace chain {
+
+        /**
+         * @brief Describes one index file of a state snapshot
+         */
+        struct state_snapshot_index {
+            std::string name;
+            uint16_t type_id = 0;
+            std::string file;
+            uint64_t count = 0;
+            /// Id of the next object created in the index, ids of removed objects are not reused
+            int64_t next_id = 0;
+            uint64_t size = 0;
+            fc::sha256 checksum;
+        };
+
+        /**
+         * @brief Manifest of a state snapshot
+         *
+         * A snapshot is a directory with one binary file per registered index and this manifest.
+         * Objects are stored with fc::raw, so a snapshot does not depend on the shared memory
+         * layout of the build which produced it, only on the reflected object fields.
+         */
+        struct state_snapshot_manifest {
+            uint32_t version = STATE_SNAPSHOT_VERSION;
+            protocol::chain_id_type chain_id;
+            std::string blockchain_version;
+            uint32_t head_block_num = 0;
+            protocol::block_id_type head_block_id;
+            fc::time_point_sec head_block_time;
+            std::vector<state_snapshot_index> indexes;
+        };
+
+        /**
+         * @brief Calculates sha256 of a file reading it in chunks
+         */
+        fc::sha256 state_snapshot_checksum(const fc::path &file);
+
+    }
+} // golos::chain
+
+FC_REFLECT((golos::chain::state_snapshot_index), (name)(type_id)(file)(count)(next_id)(size)(checksum))
+FC_REFLECT((golos::chain::state_snapshot_manifest),
+        (version)(chain_id)(blockchain_version)(head_block_num)(head_block_id)(head_block_time)(indexes))
@@ -3,10 +3,15 @@
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/mem_fun.hpp>
 
+#include <boost/interprocess/containers/deque.hpp>
+
 #include <chainbase/chainbase.hpp>
 
+#include <fc/crypto/city.hpp>
+
 #include <golos/protocol/types.hpp>
 #include <golos/protocol/authority.hpp>
 
@@ -40,8 +45,21 @@ namespace golos {
 
         typedef boost::interprocess::vector<char, allocator<char>> buffer_type;
 
+        /**
+         * Hash for hashed indexes keyed by account name. fixed_string keeps the name inline and
+         * compares it bytewise, so hashing the raw representation is consistent with operator==.
+         */
+        struct account_name_hash {
+            std::size_t operator()(const account_name_type &name) const {
+                return fc::city_hash64(reinterpret_cast<const char *>(&name), sizeof(name));
+            }
+        };
+
         struct by_id;
 
+        /// Hashed account name index used for point lookups, ordered by_name indexes serve range scans
+        struct by_hashed_name;
+
         enum object_type {
             dynamic_global_property_object_type,
             account_object_type,
@@ -88,7 +106,10 @@ namespace golos {
             operation_history_object_type,
             account_transaction_history_object_type,
 
-            collateral_bid_object_type
+            collateral_bid_object_type,
+
+            state_hash_object_type,
+            next_id_object_type
         };
 
         class dynamic_global_property_object;
@@ -190,6 +211,41 @@ namespace fc {
         }
     }
 
+    namespace raw {
+        template<typename Stream>
+        inline void pack(Stream &s, const golos::chain::shared_string &ss) {
+            std::string str = golos::chain::to_string(ss);
+            fc::raw::pack(s, str);
+        }
+
+        template<typename Stream>
+        inline void unpack(Stream &s, golos::chain::shared_string &ss) {
+            std::string str;
+            fc::raw::unpack(s, str);
+            golos::chain::from_string(ss, str);
+        }
+
+        template<typename Stream, typename T, typename A>
+        inline void pack(Stream &s, const boost::interprocess::deque<T, A> &dq) {
+            fc::raw::pack(s, unsigned_int(dq.size()));
+            for (const auto &item : dq) {
+                fc::raw::pack(s, item);
+            }
+        }
+
+        template<typename Stream, typename T, typename A>
+        inline void unpack(Stream &s, boost::interprocess::deque<T, A> &dq) {
+            unsigned_int size;
+            fc::raw::unpack(s, size);
+            dq.clear();
+            for (uint32_t i = 0; i < size.value; ++i) {
+                T item;
+                fc::raw::unpack(s, item);
+                dq.push_back(std::move(item));
+            }
+        }
+    }
+
     namespace raw {
         using chainbase::allocator;
 
@@ -259,6 +315,8 @@ FC_REFLECT_ENUM(golos::chain::object_type,
                 (account_transaction_history_object_type)
                 (proposal_object_type)
                 (collateral_bid_object_type)
+                (state_hash_object_type)
+                (next_id_object_type)
 )
 
 FC_REFLECT_TYPENAME((golos::chain::shared_string))
@@ -0,0 +1,164 @@
+#include <golos/chain/invariant_checker.hpp>
+#include <golos/chain/database.hpp>
+#include <golos/chain/objects/account_object.hpp>
+#include <golos/chain/objects/market_object.hpp>
+#include <golos/chain/objects/steem_objects.hpp>
+
+namespace golos {
+    namespace chain {
+
+        invariant_checker::invariant_checker(const database &db, uint32_t chunk_size)
+                : _db(db), _chunk_size(chunk_size),
+                  _total_supply(0, STEEM_SYMBOL_NAME), _total_sbd(0, SBD_SYMBOL_NAME),
+                  _total_vesting(0, VESTS_SYMBOL) {
+        }
+
+        template<typename MultiIndexType, typename Visitor>
+        bool invariant_checker::walk(uint32_t &budget, Visitor &&visit) {
+            typedef typename MultiIndexType::value_type value_type;
+
+            const auto &idx = _db.get_index<MultiIndexType>().indices().template get<by_id>();
+            for (auto itr = idx.lower_bound(typename value_type::id_type(_next_id)); itr != idx.end(); ++itr) {
+                if (_chunk_size != 0 && budget == 0) {
+                    _next_id = itr->id._id;
+                    return false;
+                }
+                visit(*itr);
+                --budget;
+            }
+
+            _next_id = 0;
+            return true;
+        }
+
+        bool invariant_checker::step() {
+            uint32_t budget = _chunk_size;
+            const auto &gpo = _db.get_dynamic_global_properties();
+
+            while (_stage != finished && (_chunk_size == 0 || budget > 0)) {
+                switch (_stage) {
+                    case witnesses:
+                        /// verify no witness has too many votes
+                        if (walk<witness_index>(budget, [&](const witness_object &w) {
+                            FC_ASSERT(w.votes < gpo.total_vesting_shares.amount, "", ("witness", w));
+                        })) {
+                            _stage = accounts;
+                        }
+                        break;
+
+                    case accounts:
+                        if (walk<account_index>(budget, [&](const account_object &a) {
+                            _total_supply += _db.get_balance(a.name, STEEM_SYMBOL_NAME);
+                            _total_supply += a.savings_balance;
+                            _total_sbd += _db.get_balance(a.name, SBD_SYMBOL_NAME);
+                            _total_sbd += a.savings_sbd_balance;
+                            _total_vesting += a.vesting_shares;
+                            _total_vsf_votes += (a.proxy == STEEMIT_PROXY_TO_SELF_ACCOUNT ? a.witness_vote_weight() : (
+                                    STEEMIT_MAX_PROXY_RECURSION_DEPTH > 0 ? a.proxied_vsf_votes[
+                                            STEEMIT_MAX_PROXY_RECURSION_DEPTH - 1] : a.vesting_shares.amount));
+                        })) {
+                            _stage = convert_requests;
+                        }
+                        break;
+
+                    case convert_requests:
+                        if (walk<convert_request_index>(budget, [&](const convert_request_object &r) {
+                            if (r.amount.symbol == STEEM_SYMBOL_NAME) {
+                                _total_supply += r.amount;
+                            } else if (r.amount.symbol == SBD_SYMBOL_NAME) {
+                                _total_sbd += r.amount;
+                            } else {
+                                FC_ASSERT(false, "Encountered illegal symbol in convert_request_object");
+                            }
+                        })) {
+                            _stage = limit_orders;
+                        }
+                        break;
+
+                    case limit_orders:
+                        if (walk<limit_order_index>(budget, [&](const limit_order_object &o) {
+                            if (o.sell_price.base.symbol == STEEM_SYMBOL_NAME) {
+                                _total_supply += asset<0, 17, 0>(o.for_sale, STEEM_SYMBOL_NAME);
+                            } else if (o.sell_price.base.symbol == SBD_SYMBOL_NAME) {
+                                _total_sbd += asset<0, 17, 0>(o.for_sale, SBD_SYMBOL_NAME);
+                            }
+                        })) {
+                            _stage = escrows;
+                        }
+                        break;
+
+                    case escrows:
+                        if (walk<escrow_index>(budget, [&](const escrow_object &e) {
+                            _total_supply += e.steem_balance;
+                            _total_sbd += e.sbd_balance;
+
+                            if (e.pending_fee.symbol == STEEM_SYMBOL_NAME) {
+                                _total_supply += e.pending_fee;
+                            } else if (e.pending_fee.symbol == SBD_SYMBOL_NAME) {
+                                _total_sbd += e.pending_fee;
+                            } else {
+                                FC_ASSERT(false, "found escrow pending fee that is not SBD or STEEM");
+                            }
+                        })) {
+                            _stage = savings_withdraws;
+                        }
+                        break;
+
+                    case savings_withdraws:
+                        if (walk<savings_withdraw_index>(budget, [&](const savings_withdraw_object &w) {
+                            if (w.amount.symbol == STEEM_SYMBOL_NAME) {
+                                _total_supply += w.amount;
+                            } else if (w.amount.symbol == SBD_SYMBOL_NAME) {
+                                _total_sbd += w.amount;
+                            } else {
+                                FC_ASSERT(false, "found savings withdraw that is not SBD or STEEM");
+                            }
+                        })) {
+                            _stage = reward_funds;
+                        }
+                        break;
+
+                    case reward_funds:
+                        if (walk<reward_fund_index>(budget, [&](const reward_fund_object &f) {
+                            _total_supply += f.reward_balance;
+                        })) {
+                            _stage = totals;
+                        }
+                        break;
+
+                    case totals: {
+                        _total_supply += gpo.total_vesting_fund_steem + gpo.total_reward_fund_steem;
+
+                        FC_ASSERT(gpo.current_supply == _total_supply, "",
+                                  ("gpo.current_supply", gpo.current_supply)("total_supply", _total_supply));
+                        FC_ASSERT(gpo.current_sbd_supply == _total_sbd, "",
+                                  ("gpo.current_sbd_supply", gpo.current_sbd_supply)("total_sbd", _total_sbd));
+                        FC_ASSERT(gpo.total_vesting_shares == _total_vesting, "",
+                                  ("gpo.total_vesting_shares", gpo.total_vesting_shares)("total_vesting", _total_vesting));
+                        FC_ASSERT(gpo.total_vesting_shares.amount == _total_vsf_votes, "",
+                                  ("total_vesting_shares", gpo.total_vesting_shares)("total_vsf_votes", _total_vsf_votes));
+
+                        FC_ASSERT(gpo.virtual_supply >= gpo.current_supply);
+
+                        const auto &feed = _db.get_feed_history();
+                        if (!feed.current_median_history.is_null()) {
+                            FC_ASSERT(gpo.current_sbd_supply * feed.current_median_history + gpo.current_supply ==
+                                      gpo.virtual_supply, "", ("gpo.current_sbd_supply", gpo.current_sbd_supply)(
+                                    "get_feed_history().current_median_history", feed.current_median_history)(
+                                    "gpo.current_supply", gpo.current_supply)("gpo.virtual_supply", gpo.virtual_supply));
+                        }
+
+                        _stage = finished;
+                        break;
+                    }
+
+                    case finished:
+                        break;
+                }
+            }
+
+            return done();
+        }
+
+    }
+} // golos::chain
@@ -0,0 +1,238 @@
+#include <golos/chain/database.hpp>
+#include <golos/chain/database_exceptions.hpp>
+#include <golos/chain/state_snapshot.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/thread/thread.hpp>
+
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/interprocess/managed_mapped_file.hpp>
+
+#include <fstream>
+#include <thread>
+
+namespace golos {
+    namespace chain {
+
+        fc::sha256 state_snapshot_checksum(const fc::path &file) {
+            std::ifstream in(file.string(), std::ios::in | std::ios::binary);
+            FC_ASSERT(in.is_open(), "Unable to open ${f}", ("f", file));
+
+            fc::sha256::encoder enc;
+            std::vector<char> buffer(1024 * 1024);
+            while (in) {
+                in.read(buffer.data(), buffer.size());
+                if (in.gcount() > 0) {
+                    enc.write(buffer.data(), in.gcount());
+                }
+            }
+            return enc.result();
+        }
+
+        namespace {
+            std::vector<std::shared_ptr<fc::thread>> make_snapshot_thread_pool(uint32_t threads, std::size_t tasks) {
+                if (threads == 0) {
+                    threads = std::max(std::thread::hardware_concurrency(), 1u);
+                }
+                threads = std::min<std::size_t>(threads, std::max<std::size_t>(tasks, 1));
+
+                std::vector<std::shared_ptr<fc::thread>> pool(threads);
+                for (uint32_t i = 0; i < threads; ++i) {
+                    pool[i] = std::make_shared<fc::thread>("snapshot_" + fc::to_string(i));
+                }
+                return pool;
+            }
+        }
+
+        void database::export_state_snapshot(const fc::path &snapshot_dir, uint32_t threads) {
+            try {
+                ilog("Writing state snapshot to ${d}", ("d", snapshot_dir));
+                auto start = fc::time_point::now();
+
+                fc::create_directories(snapshot_dir);
+
+                state_snapshot_manifest manifest;
+                manifest.chain_id = get_chain_id();
+                manifest.blockchain_version = std::string(STEEMIT_BLOCKCHAIN_VERSION);
+                manifest.indexes.resize(_index_infos.size());
+
+                with_read_lock([&]() {
+                    manifest.head_block_num = head_block_num();
+                    manifest.head_block_id = head_block_id();
+                    manifest.head_block_time = head_block_time();
+
+                    auto pool = make_snapshot_thread_pool(threads, _index_infos.size());
+                    std::vector<fc::future<void>> results;
+                    results.reserve(_index_infos.size());
+
+                    for (std::size_t i = 0; i < _index_infos.size(); ++i) {
+                        const auto &info = *_index_infos[i];
+                        auto &entry = manifest.indexes[i];
+
+                        entry.name = info.name();
+                        entry.type_id = info.type_id();
+                        entry.file = boost::replace_all_copy(entry.name, "::", ".") + ".bin";
+                        entry.next_id = info.next_id();
+
+                        results.push_back(pool[i % pool.size()]->async([&info, &entry, &snapshot_dir]() {
+                            auto file = snapshot_dir / entry.file;
+                            {
+                                std::ofstream out(file.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+                                FC_ASSERT(out.is_open(), "Unable to create ${f}", ("f", file));
+                                entry.count = info.export_objects(out);
+                                out.flush();
+                                FC_ASSERT(out.good(), "Error writing ${f}", ("f", file));
+                            }
+                            entry.size = fc::file_size(file);
+                            entry.checksum = state_snapshot_checksum(file);
+                        }, "export_state_snapshot"));
+                    }
+
+                    for (auto &r : results) {
+                        r.wait();
+                    }
+                });
+
+                // the manifest is written last, so an interrupted export is never taken for a complete one
+                fc::json::save_to_file(manifest, snapshot_dir / STATE_SNAPSHOT_MANIFEST);
+
+                for (const auto &entry : manifest.indexes) {
+                    ilog("  ${n}: ${c} objects, ${s} bytes", ("n", entry.name)("c", entry.count)("s", entry.size));
+                }
+
+                auto end = fc::time_point::now();
+                ilog("Done writing state snapshot at block ${b}, elapsed time: ${t} sec",
+                     ("b", manifest.head_block_num)("t", double((end - start).count()) / 1000000.0));
+            } FC_CAPTURE_AND_RETHROW((snapshot_dir))
+        }
+
+        void database::import_state_snapshot(const fc::path &snapshot_dir, uint32_t threads) {
+            try {
+                ilog("Loading state snapshot from ${d}", ("d", snapshot_dir));
+                auto start = fc::time_point::now();
+
+                auto manifest_file = snapshot_dir / STATE_SNAPSHOT_MANIFEST;
+                STEEMIT_ASSERT(fc::exists(manifest_file), exceptions::chain::state_snapshot<>,
+                               "State snapshot manifest ${f} was not found", ("f", manifest_file));
+
+                auto manifest = fc::json::from_file(manifest_file).as<state_snapshot_manifest>();
+                STEEMIT_ASSERT(manifest.version == STATE_SNAPSHOT_VERSION, exceptions::chain::state_snapshot<>,
+                               "Unsupported state snapshot version ${v}", ("v", manifest.version));
+                STEEMIT_ASSERT(manifest.chain_id == get_chain_id(), exceptions::chain::state_snapshot<>,
+                               "State snapshot was made for another chain ${c}", ("c", manifest.chain_id));
+
+                // checksums of all files are verified before any object is loaded
+                {
+                    auto pool = make_snapshot_thread_pool(threads, manifest.indexes.size());
+                    std::vector<fc::future<bool>> results;
+                    results.reserve(manifest.indexes.size());
+
+                    for (std::size_t i = 0; i < manifest.indexes.size(); ++i) {
+                        const auto &entry = manifest.indexes[i];
+                        results.push_back(pool[i % pool.size()]->async([&entry, &snapshot_dir]() {
+                            auto file = snapshot_dir / entry.file;
+                            return fc::exists(file) && fc::file_size(file) == entry.size &&
+                                   state_snapshot_checksum(file) == entry.checksum;
+                        }, "verify_state_snapshot"));
+                    }
+
+                    for (std::size_t i = 0; i < results.size(); ++i) {
+                        STEEMIT_ASSERT(results[i].wait(), exceptions::chain::state_snapshot<>,
+                                       "Checksum mismatch in state snapshot file ${f}",
+                                       ("f", manifest.indexes[i].file));
+                    }
+                }
+
+                std::map<std::string, const state_snapshot_index *> entries;
+                for (const auto &entry : manifest.indexes) {
+                    entries[entry.name] = &entry;
+                }
+
+                with_write_lock([&]() {
+                    for (const auto &info : _index_infos) {
+                        auto itr = entries.find(info->name());
+                        if (itr == entries.end()) {
+                            wlog("Index ${n} is not present in the state snapshot, it stays empty", ("n", info->name()));
+                            continue;
+                        }
+
+                        const auto &entry = *itr->second;
+                        auto file = snapshot_dir / entry.file;
+                        std::ifstream in(file.string(), std::ios::in | std::ios::binary);
+                        FC_ASSERT(in.is_open(), "Unable to open ${f}", ("f", file));
+
+                        info->import_objects(in, entry.count, entry.next_id);
+                        ilog("  ${n}: ${c} objects", ("n", entry.name)("c", entry.count));
+                        entries.erase(itr);
+                    }
+
+                    for (const auto &e : entries) {
+                        wlog("Index ${n} from the state snapshot is not registered, skipping it", ("n", e.first));
+                    }
+
+                    STEEMIT_ASSERT(head_block_num() == manifest.head_block_num &&
+                                   head_block_id() == manifest.head_block_id,
+                                   exceptions::chain::state_snapshot<>,
+                                   "State snapshot head does not match the manifest",
+                                   ("head_block_num", head_block_num())("manifest", manifest.head_block_num));
+
+                    set_revision(head_block_num());
+                });
+
+                auto end = fc::time_point::now();
+                ilog("Done loading state snapshot at block ${b}, elapsed time: ${t} sec",
+                     ("b", manifest.head_block_num)("t", double((end - start).count()) / 1000000.0));
+            } FC_CAPTURE_AND_RETHROW((snapshot_dir))
+        }
+
+        void database::compact_shared_memory(const fc::path &dest_dir, uint64_t shared_file_size) {
+            try {
+                ilog("Compacting shared memory into ${d}", ("d", dest_dir));
+                auto start = fc::time_point::now();
+
+                // the file name is chosen by chainbase
+                auto dest_file = dest_dir / "shared_memory.bin";
+                FC_ASSERT(!fc::exists(dest_file), "Shared memory file ${f} already exists", ("f", dest_file));
+
+                uint64_t before_size = 0;
+                uint64_t before_used = 0;
+                uint64_t after_used = 0;
+
+                with_read_lock([&]() {
+                    FC_ASSERT(revision() == head_block_num(), "Undo history has to be rewound before compaction",
+                              ("revision", revision())("head_block_num", head_block_num()));
+
+                    before_size = get_segment_manager()->get_size();
+                    before_used = before_size - get_free_memory();
+
+                    chainbase::database dest;
+                    dest.open(dest_dir, chainbase::database::read_write, shared_file_size);
+
+                    dest.with_write_lock([&]() {
+                        dest.add_index<next_id_index>();
+                        for (const auto &info : _index_infos) {
+                            auto count = info->copy_objects(dest);
+                            ilog("  ${n}: ${c} objects", ("n", info->name())("c", count));
+                        }
+                        dest.set_revision(revision());
+                    });
+
+                    after_used = dest.get_segment_manager()->get_size() - dest.get_free_memory();
+
+                    dest.flush();
+                    dest.close();
+                });
+
+                boost::interprocess::managed_mapped_file::shrink_to_fit(dest_file.string().c_str());
+                uint64_t after_size = fc::file_size(dest_file);
+
+                auto end = fc::time_point::now();
+                ilog("Done compacting shared memory at block ${b}, elapsed time: ${t} sec",
+                     ("b", head_block_num())("t", double((end - start).count()) / 1000000.0));
+                ilog("Shared memory used ${bu} of ${bs} bytes before and ${au} of ${as} bytes after compaction",
+                     ("bu", before_used)("bs", before_size)("au", after_used)("as", after_size));
+            } FC_CAPTURE_AND_RETHROW((dest_dir)(shared_file_size))
+        }
+
+    }
+} // golos::chain
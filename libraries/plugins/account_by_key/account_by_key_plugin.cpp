@@ -77,6 +77,10 @@ namespace golos {
                 }
             };
 
+            /// Operations handled by pre_operation_visitor, the plugin is not notified about the others
+            typedef chain::operation_templates<account_create_operation, account_update_operation,
+                    recover_account_operation, pow_operation, pow2_operation> pre_operations;
+
             struct pow2_work_get_account_visitor {
                 typedef const account_name_type *result_type;
 
@@ -163,6 +167,10 @@ namespace golos {
                 }
             };
 
+            /// Operations handled by post_operation_visitor
+            typedef chain::operation_templates<account_create_operation, account_update_operation,
+                    recover_account_operation, pow_operation, pow2_operation, hardfork_operation> post_operations;
+
             void account_by_key_plugin_impl::clear_cache() {
                 cached_keys.clear();
             }
@@ -205,12 +213,16 @@ namespace golos {
                 ilog("Initializing account_by_key plugin");
                 chain::database &db = database();
 
-                db.pre_apply_operation.connect([&](const operation_notification &o) {
-                    my->pre_operation(o);
-                });
-                db.post_apply_operation.connect([&](const operation_notification &o) {
-                    my->post_operation(o);
-                });
+                db.pre_apply_operation_connect<detail::pre_operations>(
+                        db.measure_plugin_handler<const operation_notification &>(
+                                plugin_name(), [&](const operation_notification &o) {
+                                    my->pre_operation(o);
+                                }));
+                db.post_apply_operation_connect<detail::post_operations>(
+                        db.measure_plugin_handler<const operation_notification &>(
+                                plugin_name(), [&](const operation_notification &o) {
+                                    my->post_operation(o);
+                                }));
 
                 db.add_plugin_index<key_lookup_index>();
             }
@@ -1,6 +1,7 @@
 #include <golos/account_history/account_history_plugin.hpp>
 
 #include <golos/application/impacted.hpp>
+#include <golos/application/subscription_hub.hpp>
 
 #include <golos/chain/operation_notification.hpp>
 #include <golos/chain/objects/history_object.hpp>
@@ -62,7 +63,7 @@ namespace golos {
                             obj.trx_in_block = _note.trx_in_block;
                             obj.op_in_trx = _note.op_in_trx;
                             obj.virtual_op = _note.virtual_op;
-                            obj.timestamp = _db.head_block_time();
+                            obj.timestamp = _note.timestamp;
                             //fc::raw::pack( obj.serialized_op , _note.op);  //call to 'pack' is ambiguous
                             auto size = fc::raw::pack_size(_note.op);
                             obj.serialized_op.resize(size);
@@ -196,9 +197,10 @@ namespace golos {
 
         void account_history_plugin::plugin_initialize(const boost::program_options::variables_map &options) {
             //ilog("Intializing account history plugin" );
-            database().pre_apply_operation.connect([&](const operation_notification &note) {
-                my->on_operation(note);
-            });
+            database().deferred_apply_operation_connect<chain::all_operations>(
+                    plugin_name(), [&](const operation_notification &note) {
+                        my->on_operation(note);
+                    });
 
             typedef pair<string, string> pairstring;
             LOAD_VALUE_SET(options, "track-account-range", my->_tracked_accounts, pairstring);
@@ -210,6 +212,10 @@ namespace golos {
         void account_history_plugin::plugin_startup() {
             ilog("account_history plugin: plugin_startup() begin");
 
+            // block feeds may start at older blocks only when every operation is in the history
+            app().get_subscription_hub()->set_operation_history_complete(
+                    my->_tracked_accounts.empty() && !my->_filter_content);
+
             ilog("account_history plugin: plugin_startup() end");
         }
 
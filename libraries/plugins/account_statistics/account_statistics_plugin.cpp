@@ -77,7 +77,9 @@ namespace golos {
             try {
                 ilog("account_stats plugin: plugin_initialize() begin");
 
-                database().post_apply_operation.connect([&](const operation_notification &o) { _my->on_operation(o); });
+                database().post_apply_operation_connect<chain::real_operations>(
+                        database().measure_plugin_handler<const operation_notification &>(
+                                plugin_name(), [&](const operation_notification &o) { _my->on_operation(o); }));
 
                 ilog("account_stats plugin: plugin_initialize() end");
             } FC_CAPTURE_AND_RETHROW()
@@ -395,6 +395,16 @@ namespace golos {
                 }
             }
 
+            /// Operations handled by pre_operation
+            typedef chain::operation_templates<delete_comment_operation, withdraw_vesting_operation> pre_operations;
+
+            /// Operations counted by post_operation, and the virtual ones handled by operation_process
+            typedef chain::operation_sets<
+                    chain::real_operations,
+                    chain::operation_templates<interest_operation, author_reward_operation, curation_reward_operation,
+                            liquidity_reward_operation, fill_vesting_withdraw_operation, fill_order_operation,
+                            fill_convert_request_operation>> post_operations;
+
             void blockchain_statistics_plugin_impl::post_operation(const operation_notification &o) {
                 try {
                     auto &db = _self.database();
@@ -436,15 +446,20 @@ namespace golos {
                 ilog("chain_stats_plugin: plugin_initialize() begin");
                 chain::database &db = database();
 
-                db.applied_block.connect([&](const signed_block &b) {
-                    _my->on_block(b);
-                });
-                db.pre_apply_operation.connect([&](const operation_notification &o) {
-                    _my->pre_operation(o);
-                });
-                db.post_apply_operation.connect([&](const operation_notification &o) {
-                    _my->post_operation(o);
-                });
+                db.applied_block.connect(db.measure_plugin_handler<const signed_block &>(
+                        plugin_name(), [&](const signed_block &b) {
+                            _my->on_block(b);
+                        }));
+                db.pre_apply_operation_connect<detail::pre_operations>(
+                        db.measure_plugin_handler<const operation_notification &>(
+                                plugin_name(), [&](const operation_notification &o) {
+                                    _my->pre_operation(o);
+                                }));
+                db.post_apply_operation_connect<detail::post_operations>(
+                        db.measure_plugin_handler<const operation_notification &>(
+                                plugin_name(), [&](const operation_notification &o) {
+                                    _my->post_operation(o);
+                                }));
 
                 db.add_plugin_index<bucket_index>();
 
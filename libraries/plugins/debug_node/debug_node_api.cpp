@@ -70,6 +70,8 @@ namespace golos {
 
                     void debug_get_json_schema(std::string &schema);
 
+                    std::vector<chain::index_memory_usage> debug_get_memory_usage();
+
                     void debug_set_dev_key_prefix(std::string prefix);
 
                     void debug_mine(debug_mine_result &result, const debug_mine_args &args);
@@ -357,6 +359,13 @@ namespace golos {
                     schema = app.chain_database()->get_json_schema();
                 }
 
+                std::vector<chain::index_memory_usage> debug_node_api_impl::debug_get_memory_usage() {
+                    std::shared_ptr<chain::database> db = app.chain_database();
+                    return db->with_read_lock([&]() {
+                        return db->get_memory_usage();
+                    });
+                }
+
             } // detail
 
             debug_node_api::debug_node_api(const golos::application::api_context &ctx) {
@@ -461,6 +470,10 @@ namespace golos {
                 return result;
             }
 
+            std::vector<chain::index_memory_usage> debug_node_api::debug_get_memory_usage() {
+                return my->debug_get_memory_usage();
+            }
+
         }
     }
 } // golos::plugin::debug_node
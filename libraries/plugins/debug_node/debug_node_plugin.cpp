@@ -163,7 +163,8 @@ namespace golos {
 
                 // connect needed signals
 
-                _applied_block_conn = db.applied_block.connect([this](const chain::signed_block &b) { on_applied_block(b); });
+                _applied_block_conn = db.applied_block.connect(db.measure_plugin_handler<const chain::signed_block &>(
+                        plugin_name(), [this](const chain::signed_block &b) { on_applied_block(b); }));
 
                 app().register_api_factory<debug_node_api>("debug_node_api");
 
@@ -10,6 +10,7 @@
 
 #include <golos/protocol/block.hpp>
 
+#include <golos/chain/index_info.hpp>
 #include <golos/chain/objects/witness_object.hpp>
 
 namespace golos {
@@ -134,6 +135,12 @@ namespace golos {
 
                 std::string debug_get_json_schema();
 
+                /**
+                 * Approximate shared memory usage of every registered index, largest first.
+                 * Walks all objects under the read lock.
+                 */
+                std::vector<chain::index_memory_usage> debug_get_memory_usage();
+
                 std::shared_ptr<detail::debug_node_api_impl> my;
             };
 
@@ -173,6 +180,7 @@ FC_API(golos::plugin::debug_node::debug_node_api,
                 (debug_get_witness_schedule)
                 (debug_get_hardfork_property_object)
                 (debug_get_json_schema)
+                (debug_get_memory_usage)
                 (debug_set_dev_key_prefix)
                 (debug_get_dev_key)
                 (debug_mine)
@@ -1,3 +1,4 @@
+#include <golos/application/api_thread_pool.hpp>
 #include <golos/chain/objects/account_object.hpp>
 
 #include <golos/follow/follow_api.hpp>
@@ -276,49 +277,49 @@ namespace golos {
         }
 
         vector<follow_api_obj> follow_api::get_followers(string following, string start_follower, follow_type type, uint16_t limit) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_followers(following, start_follower, type, limit);
             });
         }
 
         vector<follow_api_obj> follow_api::get_following(string follower, string start_following, follow_type type, uint16_t limit) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_following(follower, start_following, type, limit);
             });
         }
 
         follow_count_api_obj follow_api::get_follow_count(string account) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_follow_count(account);
             });
         }
 
         vector<feed_entry> follow_api::get_feed_entries(string account, uint32_t entry_id, uint16_t limit) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_feed_entries(account, entry_id, limit);
             });
         }
 
         vector<comment_feed_entry> follow_api::get_feed(string account, uint32_t entry_id, uint16_t limit) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_feed(account, entry_id, limit);
             });
         }
 
         vector<blog_entry> follow_api::get_blog_entries(string account, uint32_t entry_id, uint16_t limit) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_blog_entries(account, entry_id, limit);
             });
         }
 
         vector<comment_blog_entry> follow_api::get_blog(string account, uint32_t entry_id, uint16_t limit) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_blog(account, entry_id, limit);
             });
         }
 
         vector<account_reputation> follow_api::get_account_reputations(string lower_bound_name, uint32_t limit) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_account_reputations(lower_bound_name, limit);
             });
         }
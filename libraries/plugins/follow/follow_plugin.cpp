@@ -321,6 +321,14 @@ namespace golos {
                 }
             };
 
+            /// Operations handled by pre_operation_visitor, the plugin is not notified about the others
+            typedef chain::operation_templates<vote_operation, delete_comment_operation> pre_operations;
+
+            /// Operations handled by post_operation_visitor
+            typedef chain::operation_sets<
+                    chain::operation_templates<comment_operation, vote_operation>,
+                    chain::operation_types<custom_json_operation>> post_operations;
+
             void follow_plugin_impl::pre_operation(const operation_notification &note) {
                 try {
                     note.op.visit(pre_operation_visitor(_self));
@@ -364,8 +372,12 @@ namespace golos {
                 chain::database &db = database();
                 my->plugin_initialize();
 
-                db.pre_apply_operation.connect([&](const operation_notification &o) { my->pre_operation(o); });
-                db.post_apply_operation.connect([&](const operation_notification &o) { my->post_operation(o); });
+                db.pre_apply_operation_connect<detail::pre_operations>(
+                        db.measure_plugin_handler<const operation_notification &>(
+                                plugin_name(), [&](const operation_notification &o) { my->pre_operation(o); }));
+                db.post_apply_operation_connect<detail::post_operations>(
+                        db.measure_plugin_handler<const operation_notification &>(
+                                plugin_name(), [&](const operation_notification &o) { my->post_operation(o); }));
                 db.add_plugin_index<follow_index>();
                 db.add_plugin_index<feed_index>();
                 db.add_plugin_index<blog_index>();
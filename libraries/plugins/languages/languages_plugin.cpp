@@ -408,6 +408,10 @@ namespace golos {
             };
 
 
+            /// Operations handled by operation_visitor, the plugin is not notified about the others
+            typedef chain::operation_templates<comment_operation, transfer_operation, vote_operation,
+                    delete_comment_operation, comment_reward_operation, comment_payout_update_operation> handled_operations;
+
             void languages_plugin_impl::on_operation(const operation_notification &note) {
                 try {
                     /// plugins shouldn't ever throw
@@ -459,9 +463,11 @@ namespace golos {
 
         void languages_plugin::plugin_initialize(const boost::program_options::variables_map &options) {
             ilog("Intializing languages plugin");
-            database().post_apply_operation.connect([&](const operation_notification &note) {
-                my->on_operation(note);
-            });
+            database().post_apply_operation_connect<detail::handled_operations>(
+                    database().measure_plugin_handler<const operation_notification &>(
+                            plugin_name(), [&](const operation_notification &note) {
+                                my->on_operation(note);
+                            }));
 
             app().register_api_factory<language_api>("language_api");
         }
@@ -2,6 +2,7 @@
 
 #include <golos/chain/objects/steem_objects.hpp>
 
+#include <golos/application/api_thread_pool.hpp>
 #include <golos/application/application.hpp>
 
 #include <fc/crypto/bigint.hpp>
@@ -283,11 +284,12 @@ return trade;
                 result.quote = quote;
 
                 try {
+                    // the chain start comes from the state, the block log must not be read on API pool threads
                     const fc::time_point_sec now = fc::time_point::now();
-                    const fc::time_point_sec yesterday = app.chain_database()->fetch_block_by_number(1)->timestamp <
-                                                         fc::time_point_sec(now.sec_since_epoch() - 86400)
-                                                         ? fc::time_point_sec(now.sec_since_epoch() - 86400)
-                                                         : app.chain_database()->fetch_block_by_number(1)->timestamp;
+                    const fc::time_point_sec genesis =
+                            app.chain_database()->get_hardfork_property_object().processed_hardforks.front();
+                    const fc::time_point_sec yesterday = std::max(genesis,
+                                                                  fc::time_point_sec(now.sec_since_epoch() - 86400));
                     const auto batch_size = 100;
 
                     vector<market_trade> trades = get_trade_history(base, quote, now, yesterday, batch_size);
@@ -707,19 +709,19 @@ return trade;
         }
 
         market_ticker market_history_api::get_ticker(const string &base, const string &quote) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_ticker(base, quote);
             });
         }
 
         market_volume market_history_api::get_volume(const string &base, const string &quote) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_volume(base, quote);
             });
         }
 
         order_book market_history_api::get_order_book(const string &base, const string &quote, unsigned limit) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_order_book(base, quote, limit);
             });
         }
@@ -727,14 +729,14 @@ return trade;
         std::vector<market_trade> market_history_api::get_trade_history(const string &base, const string &quote,
                                                                         fc::time_point_sec start,
                                                                         fc::time_point_sec stop, unsigned limit) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_trade_history(base, quote, start, stop, limit);
             });
         }
 
         vector<order_history_object> market_history_api::get_fill_order_history(const string &a, const string &b,
                                                                                 uint32_t limit) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_fill_order_history(a, b, limit);
             });
         }
@@ -742,13 +744,13 @@ return trade;
         vector<bucket_object> market_history_api::get_market_history(const string &a, const string &b,
                                                                      uint32_t bucket_seconds, fc::time_point_sec start,
                                                                      fc::time_point_sec end) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_market_history(a, b, bucket_seconds, start, end);
             });
         }
 
         flat_set<uint32_t> market_history_api::get_market_history_buckets() const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_market_history_buckets();
             });
         }
@@ -756,32 +758,32 @@ return trade;
 
         vector<limit_order_object> market_history_api::get_limit_orders(const string &a, const string &b,
                                                                         uint32_t limit) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_limit_orders(a, b, limit);
             });
         }
 
         vector<call_order_object> market_history_api::get_call_orders(const string &a, uint32_t limit) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_call_orders(a, limit);
             });
         }
 
         vector<call_order_object> market_history_api::get_margin_positions(const string &name) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_margin_positions(name);
             });
         }
 
         vector<force_settlement_object> market_history_api::get_settle_orders(const string &a, uint32_t limit) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_settle_orders(a, limit);
             });
         }
 
         std::vector<liquidity_balance> market_history_api::get_liquidity_queue(const string &start_account,
                                                                                uint32_t limit) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_liquidity_queue(start_account, limit);
             });
         }
@@ -816,19 +818,19 @@ return trade;
 
         std::vector<golos::application::extended_limit_order> market_history_api::get_limit_orders_by_owner(
                 const string &owner) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_limit_orders_by_owner(owner);
             });
         }
 
         std::vector<call_order_object> market_history_api::get_call_orders_by_owner(const string &owner) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_call_orders_by_owner(owner);
             });
         }
 
         std::vector<force_settlement_object> market_history_api::get_settle_orders_by_owner(const string &owner) const {
-            return my->app.chain_database()->with_read_lock([&]() {
+            return my->app.get_api_thread_pool()->with_read_lock([&]() {
                 return my->get_settle_orders_by_owner(owner);
             });
         }
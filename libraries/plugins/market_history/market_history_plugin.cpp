@@ -15,9 +15,11 @@ namespace golos {
                 struct operation_process_fill_order {
                     market_history_plugin &_plugin;
                     fc::time_point_sec _now;
+                    /// Time of the block the operation belongs to
+                    fc::time_point_sec _time;
 
-                    operation_process_fill_order(market_history_plugin &mhp, fc::time_point_sec n) : _plugin(mhp),
-                                                                                                     _now(n) {
+                    operation_process_fill_order(market_history_plugin &mhp, fc::time_point_sec n,
+                                                 fc::time_point_sec t) : _plugin(mhp), _now(n), _time(t) {
                     }
 
                     typedef void result_type;
@@ -36,7 +38,7 @@ namespace golos {
                         const auto &bucket_idx = db.get_index<bucket_index>();
                         const auto &history_idx = db.get_index<order_history_index>().indices().get<by_key>();
 
-                        auto time = db.head_block_time();
+                        auto time = _time;
 
                         history_key hkey;
                         hkey.base = o.current_pays.symbol_name();
@@ -162,7 +164,7 @@ namespace golos {
                         const auto &bucket_idx = db.get_index<bucket_index>();
                         const auto &history_idx = db.get_index<order_history_index>().indices().get<by_key>();
 
-                        auto time = db.head_block_time();
+                        auto time = _time;
 
                         history_key hkey;
                         hkey.base = o.pays.symbol_name();
@@ -272,7 +274,7 @@ namespace golos {
                         const auto &bucket_idx = db.get_index<bucket_index>();
                         const auto &history_idx = db.get_index<order_history_index>().indices().get<by_key>();
 
-                        auto time = db.head_block_time();
+                        auto time = _time;
 
                         history_key hkey;
                         hkey.base = o.pays.symbol_name();
@@ -389,6 +391,10 @@ namespace golos {
                 int32_t maximum_history_per_bucket_size = 1000;
             };
 
+            /// Operations handled by operation_process_fill_order, the plugin is not notified about the others
+            typedef chain::operation_templates<fill_order_operation, fill_call_order_operation,
+                    fill_settlement_order_operation> fill_operations;
+
             void market_history_plugin_impl::update_market_histories(const operation_notification &o) {
                 if (maximum_history_per_bucket_size == 0) {
                     return;
@@ -397,7 +403,7 @@ namespace golos {
                     return;
                 }
 
-                o.op.visit(operation_process_fill_order(_self, fc::time_point::now()));
+                o.op.visit(operation_process_fill_order(_self, fc::time_point::now(), o.timestamp));
             }
 
         } // detail
@@ -425,9 +431,10 @@ namespace golos {
                 ilog("market_history: plugin_initialize() begin");
                 chain::database &db = database();
 
-                db.post_apply_operation.connect([&](const operation_notification &o) {
-                    _my->update_market_histories(o);
-                });
+                db.deferred_apply_operation_connect<detail::fill_operations>(
+                        plugin_name(), [&](const operation_notification &o) {
+                            _my->update_market_histories(o);
+                        });
 
                 db.add_plugin_index<bucket_index>();
                 db.add_plugin_index<order_history_index>();
@@ -150,9 +150,10 @@ namespace golos {
                     elog("No witnesses configured! Please add witness names and private keys to configuration.");
                 if (!_miners.empty()) {
                     ilog("Starting mining...");
-                    d.applied_block.connect([this](const protocol::signed_block &b) {
-                        this->on_applied_block(b);
-                    });
+                    d.applied_block.connect(d.measure_plugin_handler<const protocol::signed_block &>(
+                            plugin_name(), [this](const protocol::signed_block &b) {
+                                this->on_applied_block(b);
+                            }));
                 } else {
                     elog("No miners configured! Please add miner names and private keys to configuration.");
                 }
@@ -27,22 +27,22 @@ namespace golos {
         }
 
         template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
-        asset<Major, Hardfork, Release, type_traits::static_range<Hardfork <= 16>>::asset() : asset_interface<Major,
-                Hardfork, Release, asset_symbol_type, share_type>(0, STEEM_SYMBOL) {
+        asset<Major, Hardfork, Release, type_traits::static_range<Hardfork <= 16>>::asset() : amount(0),
+                symbol(STEEM_SYMBOL) {
 
         }
 
         template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
         asset<Major, Hardfork, Release, type_traits::static_range<Hardfork <= 16>>::asset(share_type a,
                                                                                           asset_symbol_type id)
-                : asset_interface<Major, Hardfork, Release, asset_symbol_type, share_type>(a, id) {
+                : amount(a), symbol(id) {
 
         }
 
         template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
         asset<Major, Hardfork, Release, type_traits::static_range<Hardfork <= 16>>::asset(share_type a,
                                                                                           asset_name_type name)
-                : asset_interface<Major, Hardfork, Release, asset_symbol_type, share_type>(a, STEEM_SYMBOL) {
+                : amount(a), symbol(STEEM_SYMBOL) {
             string s = fc::trim(name);
 
             this->symbol = uint64_t(3);
@@ -166,16 +166,15 @@ namespace golos {
         }
 
         template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
-        asset<Major, Hardfork, Release, type_traits::static_range<Hardfork >= 17>>::asset() : asset_interface<Major,
-                Hardfork, Release, asset_name_type, share_type>(0, STEEM_SYMBOL_NAME), decimals(3) {
+        asset<Major, Hardfork, Release, type_traits::static_range<Hardfork >= 17>>::asset() : amount(0),
+                symbol(STEEM_SYMBOL_NAME), decimals(3) {
 
         }
 
         template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
         asset<Major, Hardfork, Release, type_traits::static_range<Hardfork >= 17>>::asset(share_type a,
                                                                                           asset_symbol_type name)
-                : asset_interface<Major, Hardfork, Release, asset_name_type, share_type>(a, STEEM_SYMBOL_NAME),
-                decimals(3) {
+                : amount(a), symbol(STEEM_SYMBOL_NAME), decimals(3) {
             auto ta = (const char *) &name;
             FC_ASSERT(ta[7] == 0);
             this->symbol = &ta[1];
@@ -189,7 +188,7 @@ namespace golos {
         asset<Major, Hardfork, Release, type_traits::static_range<Hardfork >= 17>>::asset(share_type a,
                                                                                           asset_name_type name,
                                                                                           uint8_t d)
-                : asset_interface<Major, Hardfork, Release, asset_name_type, share_type>(a, name), decimals(d) {
+                : amount(a), symbol(name), decimals(d) {
 
         }
 
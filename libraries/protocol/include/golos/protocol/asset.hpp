@@ -16,29 +16,15 @@ namespace golos {
 
         bool operator==(const asset_name_type &b, const asset_symbol_type &a);
 
+        /**
+         * Common base of the versioned asset types. It is intentionally empty and non-virtual: assets are
+         * embedded by value in shared memory objects and copied on every balance change, so all data members
+         * live in the asset specializations themselves, which keeps them standard-layout and without a vtable.
+         */
         template<uint8_t Major, uint8_t Hardfork, uint16_t Release, typename StorageType, typename AmountType>
         struct asset_interface : public static_version<Major, Hardfork, Release> {
             typedef StorageType asset_container_type;
             typedef AmountType amount_container_type;
-
-            asset_interface() {
-
-            }
-
-            asset_interface(amount_container_type a, asset_container_type s) : amount(a), symbol(s) {
-
-            }
-
-            virtual ~asset_interface() {
-
-            }
-
-            virtual uint8_t get_decimals() const = 0;
-
-            virtual void set_decimals(uint8_t d) = 0;
-
-            amount_container_type amount;
-            asset_container_type symbol;
         };
 
         template<uint8_t Major, uint8_t Hardfork, uint16_t Release, typename = type_traits::static_range<true>>
@@ -55,15 +41,14 @@ namespace golos {
 
             asset(share_type a, asset_name_type name);
 
-            virtual ~asset() override {
-
-            }
+            share_type amount;
+            asset_symbol_type symbol;
 
             double to_real() const;
 
-            virtual uint8_t get_decimals() const override;
+            uint8_t get_decimals() const;
 
-            virtual void set_decimals(uint8_t d) override;
+            void set_decimals(uint8_t d);
 
             asset_name_type symbol_name() const;
 
@@ -167,15 +152,13 @@ namespace golos {
 
             asset(share_type a, asset_name_type name = STEEM_SYMBOL_NAME, uint8_t d = 3);
 
-            virtual ~asset() override {
-
-            }
+            share_type amount;
+            asset_name_type symbol;
+            uint8_t decimals;
 
-            virtual uint8_t get_decimals() const override;
+            uint8_t get_decimals() const;
 
-            virtual void set_decimals(uint8_t d) override;
-
-            uint8_t decimals;
+            void set_decimals(uint8_t d);
 
             double to_real() const;
 
@@ -274,8 +257,14 @@ namespace golos {
             }
         };
 
+        /**
+         * Does not derive from static_version: the empty base would collide with the one of @ref base at
+         * offset zero and cost price an extra padded word. The version is carried by the asset type.
+         */
         template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
-        struct price : public static_version<Major, Hardfork, Release> {
+        struct price {
+            typedef asset<Major, Hardfork, Release> asset_type;
+
             price(const asset<Major, Hardfork, Release> &input_base = asset<Major, Hardfork, Release>(0,
                                                                                                       STEEM_SYMBOL_NAME),
                   const asset<Major, Hardfork, Release> &input_quote = asset<Major, Hardfork, Release>(0,
@@ -501,18 +490,8 @@ namespace fc {
     }
 }
 
-FC_REFLECT((golos::protocol::asset_interface<0, 16, 0, golos::protocol::asset_symbol_type,
-        golos::protocol::share_type>), (amount)(symbol))
-
-FC_REFLECT((golos::protocol::asset_interface<0, 17, 0, golos::protocol::asset_name_type,
-        golos::protocol::share_type>), (amount)(symbol))
-
-FC_REFLECT_DERIVED((golos::protocol::asset<0, 16, 0>),
-                   ((golos::protocol::asset_interface<0, 16, 0, golos::protocol::asset_symbol_type,
-                           golos::protocol::share_type>)),)
-FC_REFLECT_DERIVED((golos::protocol::asset<0, 17, 0>),
-                   ((golos::protocol::asset_interface<0, 17, 0, golos::protocol::asset_name_type,
-                           golos::protocol::share_type>)), (decimals))
+FC_REFLECT((golos::protocol::asset<0, 16, 0>), (amount)(symbol))
+FC_REFLECT((golos::protocol::asset<0, 17, 0>), (amount)(symbol)(decimals))
 
 FC_REFLECT((golos::protocol::price<0, 16, 0>), (base)(quote))
 FC_REFLECT((golos::protocol::price<0, 17, 0>), (base)(quote))
@@ -8,5 +8,10 @@ namespace golos {
 
         template struct price<0, 16, 0>;
         template struct price<0, 17, 0>;
+
+        static_assert(!std::is_polymorphic<asset<0, 17, 0>>::value && !std::is_polymorphic<price<0, 17, 0>>::value,
+                      "assets are embedded in shared memory objects and must not carry a vtable");
+        static_assert(std::is_standard_layout<asset<0, 17, 0>>::value && std::is_standard_layout<price<0, 17, 0>>::value,
+                      "asset and price must stay standard-layout");
     }
 }
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include <golos/application/api_context.hpp>
+#include <golos/application/application.hpp>
+#include <golos/application/database_api.hpp>
+
+#include <golos/languages/languages_plugin.hpp>
+#include <golos/tags/tags_plugin.hpp>
+
+#include <fc/smart_ref_impl.hpp>
+#include <fc/time.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace golos::application;
+namespace bpo = boost::program_options;
+
+typedef std::vector<discussion> (database_api::*discussions_getter)(const discussion_query &) const;
+
+/**
+ * Measures the latency of every discussion sort of database_api on the chain state of a node, opened
+ * read only, for pages without a selection and for pages selected by several tags or languages
+ */
+void benchmark(const database_api &api, const std::string &name, discussions_getter getter,
+               const std::string &shape, const discussion_query &query, uint32_t rounds) {
+    std::size_t count = 0;
+
+    auto start = fc::time_point::now();
+    for (uint32_t i = 0; i < rounds; ++i) {
+        count += (api.*getter)(query).size();
+    }
+    auto time = fc::time_point::now() - start;
+
+    std::cerr << name << ", " << shape << ": " << time.count() / rounds << " us ("
+              << count / rounds << " discussions)\n";
+}
+
+int main(int argc, char **argv) {
+    std::unique_ptr<application> node(new application());
+    try {
+        node->register_plugin<golos::tags::tags_plugin>();
+        node->register_plugin<golos::languages::languages_plugin>();
+
+        bpo::options_description app_options("Discussion benchmark");
+        app_options.add_options()
+                ("help,h", "Print this help message and exit.")
+                ("data-dir,d", bpo::value<boost::filesystem::path>()->default_value("witness_node_data_dir"), "Directory of the node whose chain state is read")
+                ("rounds", bpo::value<uint32_t>()->default_value(100), "Number of calls of every query")
+                ("limit", bpo::value<uint32_t>()->default_value(20), "Discussions per page")
+                ("tag", bpo::value<std::vector<std::string>>()->composing()->default_value(std::vector<std::string>({"golos", "test"}), "golos test"), "Tags selected by the tag queries")
+                ("language", bpo::value<std::vector<std::string>>()->composing()->default_value(std::vector<std::string>({"ru", "en"}), "ru en"), "Languages selected by the language queries");
+
+        bpo::options_description cli, cfg;
+        node->set_program_options(cli, cfg);
+        app_options.add(cli);
+
+        // the node only reads the state, with the plugins which maintain the discussion indexes
+        bpo::variables_map options;
+        bpo::store(bpo::command_line_parser(std::vector<std::string>({"--read-only", "--enable-plugin", "tags languages"}))
+                           .options(app_options).run(), options);
+        bpo::store(bpo::parse_command_line(argc, argv, app_options), options);
+
+        if (options.count("help")) {
+            std::cout << app_options << "\n";
+            return 0;
+        }
+        bpo::notify(options);
+
+        fc::path data_dir = options["data-dir"].as<boost::filesystem::path>();
+        if (data_dir.is_relative()) {
+            data_dir = fc::current_path() / data_dir;
+        }
+
+        node->initialize(data_dir, options);
+        node->initialize_plugins(options);
+        node->startup();
+        node->startup_plugins();
+
+        const uint32_t rounds = options["rounds"].as<uint32_t>();
+
+        discussion_query all;
+        all.limit = options["limit"].as<uint32_t>();
+        all.truncate_body = 1024;
+
+        auto tags = all;
+        for (const auto &tag : options["tag"].as<std::vector<std::string>>()) {
+            tags.select_tags.insert(tag);
+        }
+
+        auto languages = all;
+        for (const auto &language : options["language"].as<std::vector<std::string>>()) {
+            languages.select_languages.insert(language);
+        }
+
+        const std::vector<std::pair<std::string, discussions_getter>> sorts = {
+                {"trending", &database_api::get_discussions_by_trending},
+                {"created", &database_api::get_discussions_by_created},
+                {"active", &database_api::get_discussions_by_active},
+                {"cashout", &database_api::get_discussions_by_cashout},
+                {"payout", &database_api::get_discussions_by_payout},
+                {"votes", &database_api::get_discussions_by_votes},
+                {"children", &database_api::get_discussions_by_children},
+                {"hot", &database_api::get_discussions_by_hot},
+                {"promoted", &database_api::get_discussions_by_promoted}
+        };
+
+        auto session = std::make_shared<api_session_data>();
+        database_api api(api_context(*node, "database_api", session));
+        for (const auto &sort : sorts) {
+            benchmark(api, sort.first, sort.second, "all", all, rounds);
+            benchmark(api, sort.first, sort.second, "tags", tags, rounds);
+            benchmark(api, sort.first, sort.second, "languages", languages, rounds);
+        }
+
+        node->shutdown_plugins();
+        node->shutdown();
+    } catch (const fc::exception &e) {
+        std::cerr << e.to_detail_string() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -178,6 +178,13 @@ int main(int argc, char **argv) {
 
         ilog("starting node");
         node->startup();
+
+        if (node->_exit_after_startup) {
+            node->shutdown();
+            delete node;
+            return 0;
+        }
+
         ilog("starting plugins");
         node->startup_plugins();
 
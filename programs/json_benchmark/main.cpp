@@ -0,0 +1,75 @@
+#include <golos/application/json_writer.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/smart_ref_impl.hpp>
+#include <fc/time.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace golos::application;
+using namespace golos::protocol;
+
+/**
+ * Compares the JSON replies written by json_writer with the fc::variant path for the result types
+ * batch_api_connection answers through json_writer
+ */
+template<typename T>
+void benchmark(const std::string &name, const T &value, uint32_t rounds) {
+    std::size_t size = 0;
+
+    auto start = fc::time_point::now();
+    for (uint32_t i = 0; i < rounds; ++i) {
+        size += fc::json::to_string(fc::variant(value)).size();
+    }
+    auto variant_time = fc::time_point::now() - start;
+
+    start = fc::time_point::now();
+    for (uint32_t i = 0; i < rounds; ++i) {
+        size += to_json(value).size();
+    }
+    auto writer_time = fc::time_point::now() - start;
+
+    if (to_json(value) != fc::json::to_string(fc::variant(value))) {
+        std::cerr << name << ": json_writer output differs from fc::json\n";
+    }
+
+    std::cerr << name << ": variant " << variant_time.count() / rounds << " us, json_writer "
+              << writer_time.count() / rounds << " us (" << size / (2 * rounds) << " bytes)\n";
+}
+
+int main(int argc, char **argv) {
+    uint32_t rounds = argc > 1 ? std::stoul(argv[1]) : 100;
+
+    discussion d;
+    d.author = "alice";
+    d.permlink = "a-post-with-a-permlink";
+    d.title = "A \"quoted\" title";
+    d.body = std::string(8192, 'x');
+    d.json_metadata = R"({"tags":["golos","test"],"app":"benchmark"})";
+    d.created = fc::time_point_sec(1500000000);
+    d.active_votes.resize(50);
+    for (std::size_t i = 0; i < d.active_votes.size(); ++i) {
+        d.active_votes[i].voter = "voter" + std::to_string(i);
+        d.active_votes[i].rshares = int64_t(i) << 34;
+    }
+    benchmark("20 discussions", std::vector<discussion>(20, d), rounds);
+
+    std::map<uint32_t, applied_operation> history;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        transfer_operation<0, 17, 0> transfer;
+        transfer.from = "alice";
+        transfer.to = "bob";
+        transfer.amount = asset<0, 17, 0>(i, STEEM_SYMBOL_NAME);
+        transfer.memo = "memo " + std::to_string(i);
+
+        auto &op = history[i];
+        op.block = i;
+        op.timestamp = fc::time_point_sec(1500000000 + i * 3);
+        op.op = transfer;
+    }
+    benchmark("1000 history entries", history, rounds);
+
+    return 0;
+}
@@ -4,6 +4,33 @@
 
 #include <golos/protocol/protocol.hpp>
 
+#include <golos/chain/objects/account_object.hpp>
+#include <golos/chain/objects/asset_object.hpp>
+#include <golos/chain/objects/block_summary_object.hpp>
+#include <golos/chain/objects/comment_object.hpp>
+#include <golos/chain/objects/global_property_object.hpp>
+#include <golos/chain/objects/hardfork_object.hpp>
+#include <golos/chain/objects/history_object.hpp>
+#include <golos/chain/objects/market_object.hpp>
+#include <golos/chain/objects/proposal_object.hpp>
+#include <golos/chain/objects/state_hash_object.hpp>
+#include <golos/chain/objects/steem_objects.hpp>
+#include <golos/chain/objects/transaction_object.hpp>
+#include <golos/chain/objects/witness_object.hpp>
+
+#include <golos/account_by_key/account_by_key_objects.hpp>
+#include <golos/account_statistics/account_statistics_plugin.hpp>
+#include <golos/blockchain_statistics/blockchain_statistics_plugin.hpp>
+#include <golos/follow/follow_objects.hpp>
+#include <golos/languages/languages_plugin.hpp>
+#include <golos/market_history/bucket_object.hpp>
+#include <golos/market_history/order_history_object.hpp>
+#include <golos/private_message/private_message_plugin.hpp>
+#include <golos/tags/tags_plugin.hpp>
+
+#include <iomanip>
+#include <type_traits>
+
 using namespace golos::protocol;
 
 std::vector<fc::variant_object> g_op_types;
@@ -32,6 +59,194 @@ struct size_check_type_visitor {
     }
 };
 
+/**
+ * Sizes of the value types embedded in shared memory objects and the throughput of their arithmetic,
+ * run it before and after changing asset or price to compare.
+ */
+void check_value_types() {
+    typedef asset<0, 17, 0> asset_type;
+    typedef price<0, 17, 0> price_type;
+
+    std::cerr << "Size of asset: " << sizeof(asset_type) << ", price: " << sizeof(price_type) << "\n";
+    std::cerr << "Size of account_object: " << sizeof(golos::chain::account_object)
+              << ", limit_order_object: " << sizeof(golos::chain::limit_order_object)
+              << ", call_order_object: " << sizeof(golos::chain::call_order_object) << "\n";
+
+    const uint32_t iterations = 10000000;
+
+    asset_type total(0, STEEM_SYMBOL_NAME);
+    const asset_type delta(1, STEEM_SYMBOL_NAME);
+    auto start = fc::time_point::now();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        total += delta;
+    }
+    auto add_time = fc::time_point::now() - start;
+
+    const price_type rate(asset_type(1000, SBD_SYMBOL_NAME), asset_type(3000, STEEM_SYMBOL_NAME));
+    share_type converted = 0;
+    start = fc::time_point::now();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        converted += (asset_type(i, STEEM_SYMBOL_NAME) * rate).amount;
+    }
+    auto mul_time = fc::time_point::now() - start;
+
+    std::vector<asset_type> copies(iterations / 10, delta);
+    start = fc::time_point::now();
+    std::vector<asset_type> copied(copies);
+    auto copy_time = fc::time_point::now() - start;
+
+    std::cerr << "asset += asset: " << double(add_time.count()) * 1000 / iterations << " ns, "
+              << "asset * price: " << double(mul_time.count()) * 1000 / iterations << " ns, "
+              << "asset copy: " << double(copy_time.count()) * 1000 / copies.size() << " ns "
+              << "(" << total.amount.value + converted.value + copied.size() << ")\n";
+}
+
+const std::size_t cache_line_size = 64;
+
+struct field_layout {
+    std::string name;
+    std::size_t offset;
+    std::size_t size;
+};
+
+/**
+ * Collects offsets and sizes of the reflected members of an object. The offsets are taken on an
+ * unconstructed buffer, most chain objects can only be constructed with a shared memory allocator.
+ */
+template<typename T>
+struct field_layout_visitor {
+    field_layout_visitor(const T *o, std::vector<field_layout> &f) : obj(o), fields(f) {
+    }
+
+    template<typename Member, class Class, Member (Class::*member)>
+    void operator()(const char *name) const {
+        const Class *base = obj;
+        const char *field = reinterpret_cast<const char *>(&(base->*member));
+        fields.push_back({name, std::size_t(field - reinterpret_cast<const char *>(obj)), sizeof(Member)});
+    }
+
+    const T *obj;
+    std::vector<field_layout> &fields;
+};
+
+/**
+ * Prints the members of an object in memory order with cache line boundaries, the holes between
+ * members (padding or members which are not reflected) and the members split across cache lines.
+ */
+template<typename T>
+void print_layout() {
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    const T *obj = reinterpret_cast<const T *>(&storage);
+
+    std::vector<field_layout> fields;
+    fc::reflector<T>::visit(field_layout_visitor<T>(obj, fields));
+    std::stable_sort(fields.begin(), fields.end(), [](const field_layout &a, const field_layout &b) {
+        return a.offset < b.offset;
+    });
+
+    std::cerr << "\n" << fc::get_typename<T>::name() << ": size " << sizeof(T) << ", align " << alignof(T)
+              << ", cache lines " << (sizeof(T) + cache_line_size - 1) / cache_line_size << "\n";
+
+    std::size_t end = 0;
+    std::size_t holes = 0;
+    std::size_t splits = 0;
+    std::size_t line = 0;
+    for (const auto &f : fields) {
+        if (f.offset > end) {
+            std::cerr << "    " << std::setw(5) << end << std::setw(6) << f.offset - end << "  <hole>\n";
+            holes += f.offset - end;
+        }
+        if (f.offset / cache_line_size > line) {
+            line = f.offset / cache_line_size;
+            std::cerr << "    ---- cache line " << line << "\n";
+        }
+
+        std::cerr << "    " << std::setw(5) << f.offset << std::setw(6) << f.size << "  " << f.name;
+        if (f.size > 0 && f.offset / cache_line_size != (f.offset + f.size - 1) / cache_line_size) {
+            std::cerr << "  <split>";
+            ++splits;
+        }
+        std::cerr << "\n";
+
+        end = std::max(end, f.offset + f.size);
+    }
+    if (sizeof(T) > end) {
+        std::cerr << "    " << std::setw(5) << end << std::setw(6) << sizeof(T) - end << "  <tail padding>\n";
+        holes += sizeof(T) - end;
+    }
+
+    std::cerr << "    holes: " << holes << " bytes, split members: " << splits << "\n";
+}
+
+/**
+ * Field layout of the objects kept in shared memory by the chain and by the plugins
+ */
+void check_object_layouts() {
+    using namespace golos::chain;
+
+    print_layout<dynamic_global_property_object>();
+    print_layout<account_object>();
+    print_layout<account_authority_object>();
+    print_layout<account_bandwidth_object>();
+    print_layout<account_balance_object>();
+    print_layout<account_statistics_object>();
+    print_layout<vesting_delegation_object>();
+    print_layout<vesting_delegation_expiration_object>();
+    print_layout<owner_authority_history_object>();
+    print_layout<account_recovery_request_object>();
+    print_layout<change_recovery_account_request_object>();
+    print_layout<witness_object>();
+    print_layout<witness_vote_object>();
+    print_layout<witness_schedule_object>();
+    print_layout<transaction_object>();
+    print_layout<block_summary_object>();
+    print_layout<comment_object>();
+    print_layout<comment_vote_object>();
+    print_layout<category_object>();
+    print_layout<limit_order_object>();
+    print_layout<call_order_object>();
+    print_layout<force_settlement_object>();
+    print_layout<collateral_bid_object>();
+    print_layout<feed_history_object>();
+    print_layout<convert_request_object>();
+    print_layout<liquidity_reward_balance_object>();
+    print_layout<operation_object>();
+    print_layout<account_history_object>();
+    print_layout<hardfork_property_object>();
+    print_layout<withdraw_vesting_route_object>();
+    print_layout<escrow_object>();
+    print_layout<savings_withdraw_object>();
+    print_layout<decline_voting_rights_request_object>();
+    print_layout<reward_fund_object>();
+    print_layout<proposal_object>();
+    print_layout<asset_object>();
+    print_layout<asset_dynamic_data_object>();
+    print_layout<asset_bitasset_data_object>();
+    print_layout<state_hash_object>();
+
+    print_layout<golos::account_by_key::key_lookup_object>();
+    print_layout<golos::account_statistics::account_stats_bucket_object>();
+    print_layout<golos::account_statistics::account_activity_bucket_object>();
+    print_layout<golos::blockchain_statistics::bucket_object>();
+    print_layout<golos::follow::follow_object>();
+    print_layout<golos::follow::feed_object>();
+    print_layout<golos::follow::blog_object>();
+    print_layout<golos::follow::blog_author_stats_object>();
+    print_layout<golos::follow::reputation_object>();
+    print_layout<golos::follow::follow_count_object>();
+    print_layout<golos::languages::language_object>();
+    print_layout<golos::languages::language_stats_object>();
+    print_layout<golos::languages::peer_stats_object>();
+    print_layout<golos::languages::author_language_stats_object>();
+    print_layout<golos::market_history::bucket_object>();
+    print_layout<golos::market_history::order_history_object>();
+    print_layout<golos::private_message::message_object>();
+    print_layout<golos::tags::tag_object>();
+    print_layout<golos::tags::tag_stats_object>();
+    print_layout<golos::tags::peer_stats_object>();
+    print_layout<golos::tags::author_tag_stats_object>();
+}
+
 int main(int argc, char **argv) {
     try {
         golos::protocol::operation op;
@@ -74,6 +289,9 @@ int main(int argc, char **argv) {
         std::cout << "]\n";
         std::cerr << "Size of block header: " << sizeof(block_header) << " "
                   << fc::raw::pack_size(block_header()) << "\n";
+
+        check_value_types();
+        check_object_layouts();
     }
     catch (const fc::exception &e) {
         edump((e.to_detail_string()));
@@ -4,10 +4,17 @@
 
 #include <golos/chain/objects/account_object.hpp>
 #include <golos/chain/objects/comment_object.hpp>
+#include <golos/chain/objects/history_object.hpp>
 #include <golos/protocol/operations/steem_operations.hpp>
 
+#include <golos/market_history/market_history_api.hpp>
 #include <golos/market_history/market_history_plugin.hpp>
 
+#include <golos/application/api_context.hpp>
+#include <golos/application/api_thread_pool.hpp>
+
+#include <fc/thread/thread.hpp>
+
 #include "../common/database_fixture.hpp"
 
 using namespace golos::chain;
@@ -329,5 +336,122 @@ BOOST_FIXTURE_TEST_SUITE(market_history, clean_database_fixture)
         } FC_LOG_AND_RETHROW()
     }
 
+    BOOST_AUTO_TEST_CASE(ticker_on_api_threads) {
+        using namespace golos::market_history;
+
+        try {
+            auto mh_plugin = app.register_plugin<market_history_plugin>();
+            boost::program_options::variables_map options;
+            mh_plugin->plugin_initialize(options);
+
+            app.get_api_thread_pool()->start(4);
+            generate_blocks(10);
+
+            auto session = std::make_shared<golos::application::api_session_data>();
+            market_history_api api(golos::application::api_context(app, "market_history_api", session));
+
+            // the calls run concurrently on the pool threads and must not touch the block log
+            std::vector<fc::future<void>> calls;
+            for (int i = 0; i < 32; ++i) {
+                calls.push_back(fc::async([&]() {
+                    auto ticker = api.get_ticker("TESTS", "TBD");
+                    auto volume = api.get_volume("TESTS", "TBD");
+                    BOOST_CHECK_EQUAL(ticker.base, "TESTS");
+                    BOOST_CHECK_EQUAL(volume.quote, "TBD");
+                    BOOST_CHECK_EQUAL(ticker.base_volume, volume.base_volume);
+                }));
+            }
+            for (auto &call : calls) {
+                call.wait();
+            }
+
+            BOOST_CHECK_EQUAL(app.get_api_thread_pool()->get_stats().threads, 4);
+            BOOST_CHECK(app.get_api_thread_pool()->get_stats().calls >= 64);
+        } FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(deferred_indexing_undo) {
+        using namespace golos::market_history;
+
+        try {
+            auto mh_plugin = app.register_plugin<market_history_plugin>();
+            boost::program_options::variables_map options;
+            mh_plugin->plugin_initialize(options);
+
+            ACTORS((alice)(bob));
+            fund("alice", latest_asset::from_string("10.000 TBD"));
+            fund("bob", 1000000);
+            generate_block();
+
+            db.set_deferred_plugin_indexing(true);
+
+            const auto &order_hist_idx = db.get_index<order_history_index>().indices().get<golos::chain::by_id>();
+            const auto &history_idx = db.get_index<account_history_index>().indices().get<by_account>();
+            auto bob_history = [&]() {
+                return std::distance(history_idx.lower_bound("bob"), history_idx.upper_bound("bob"));
+            };
+            const auto bob_history_before = bob_history();
+
+            signed_transaction tx;
+            limit_order_create_operation<0, 17, 0> op;
+            op.owner = "alice";
+            op.amount_to_sell = latest_asset::from_string("1.000 TBD");
+            op.min_to_receive = latest_asset::from_string("2.000 TESTS");
+            tx.operations.push_back(op);
+            tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            tx.sign(alice_private_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+
+            tx.operations.clear();
+            tx.signatures.clear();
+            op.owner = "bob";
+            op.amount_to_sell = latest_asset::from_string("2.000 TESTS");
+            op.min_to_receive = latest_asset::from_string("1.000 TBD");
+            tx.operations.push_back(op);
+            tx.sign(bob_private_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+
+            generate_block();
+            const auto fill_block = db.head_block_num();
+            BOOST_CHECK(db.plugin_head_block_num() + 1 >= fill_block);
+
+            BOOST_TEST_MESSAGE("A new transaction indexes the queued block first");
+            tx.operations.clear();
+            tx.signatures.clear();
+            transfer_operation<0, 17, 0> transfer;
+            transfer.from = "bob";
+            transfer.to = "alice";
+            transfer.amount = latest_asset::from_string("1.000 TESTS");
+            tx.operations.push_back(transfer);
+            tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            tx.sign(bob_private_key, db.get_chain_id());
+            db.push_transaction(tx, 0);
+            BOOST_CHECK_EQUAL(db.plugin_head_block_num(), fill_block);
+            BOOST_CHECK_EQUAL(std::distance(order_hist_idx.begin(), order_hist_idx.end()), 1);
+            // limit_order_create and fill_order for bob, the transfer is pending and not indexed
+            BOOST_CHECK_EQUAL(bob_history() - bob_history_before, 2);
+
+            generate_block();
+            BOOST_CHECK(db.is_known_transaction(tx.id()));
+
+            BOOST_TEST_MESSAGE("Popping the blocks undoes the deferred plugin writes");
+            db.pop_block();
+            BOOST_CHECK_EQUAL(db.plugin_head_block_num(), fill_block);
+            BOOST_CHECK_EQUAL(std::distance(order_hist_idx.begin(), order_hist_idx.end()), 1);
+
+            db.pop_block();
+            BOOST_CHECK_EQUAL(db.plugin_head_block_num(), fill_block - 1);
+            BOOST_CHECK(order_hist_idx.begin() == order_hist_idx.end());
+            BOOST_CHECK_EQUAL(bob_history(), bob_history_before);
+
+            BOOST_TEST_MESSAGE("Popped transactions are applied again and indexed once");
+            generate_block();
+            generate_block();
+            BOOST_CHECK_EQUAL(std::distance(order_hist_idx.begin(), order_hist_idx.end()), 1);
+            BOOST_CHECK_EQUAL(bob_history() - bob_history_before, 3);
+            validate_database();
+        } FC_LOG_AND_RETHROW()
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
 #endif
\ No newline at end of file
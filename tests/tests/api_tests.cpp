@@ -0,0 +1,490 @@
+#ifdef STEEMIT_BUILD_TESTNET
+
+#include <boost/test/unit_test.hpp>
+
+#include <golos/application/api_method_stats.hpp>
+#include <golos/application/api_response_cache.hpp>
+#include <golos/application/batch_api_connection.hpp>
+#include <golos/application/api_context.hpp>
+#include <golos/application/database_api.hpp>
+#include <golos/application/json_writer.hpp>
+
+#include <golos/languages/languages_plugin.hpp>
+#include <golos/tags/tags_plugin.hpp>
+
+#include <fc/api.hpp>
+#include <fc/crypto/base64.hpp>
+#include <fc/io/json.hpp>
+
+#include "../common/database_fixture.hpp"
+
+#include <algorithm>
+
+using namespace golos::application;
+using namespace golos::chain;
+using namespace golos::protocol;
+
+namespace golos {
+    namespace application {
+        namespace test {
+
+            /// API registered on the test connections
+            class calculator_api {
+            public:
+                int64_t add(int64_t a, int64_t b) const {
+                    ++calls;
+                    return a + b;
+                }
+
+                int64_t fail() const {
+                    ++calls;
+                    FC_THROW("Requested failure");
+                }
+
+                mutable uint32_t calls = 0;
+            };
+
+            /// Records what the connection sends instead of writing to a socket
+            class test_websocket_connection : public fc::http::websocket_connection {
+            public:
+                void send_message(const std::string &message) override {
+                    sent.push_back(message);
+                }
+
+                std::vector<std::string> sent;
+            };
+
+            const api_method_stats_entry *find_stats(const api_method_stats_result &stats, const std::string &api,
+                                                     const std::string &method) {
+                auto itr = std::find_if(stats.methods.begin(), stats.methods.end(),
+                                        [&](const api_method_stats_entry &e) {
+                                            return e.api == api && e.method == method;
+                                        });
+                return itr == stats.methods.end() ? nullptr : &*itr;
+            }
+
+        }
+    }
+} // golos::application::test
+
+FC_API(golos::application::test::calculator_api, (add)(fail))
+
+using namespace golos::application::test;
+
+BOOST_FIXTURE_TEST_SUITE(api_tests, clean_database_fixture)
+
+    BOOST_AUTO_TEST_CASE(method_stats_keys) {
+        try {
+            api_method_stats stats(db);
+            stats.add_api("calculator_api", {"add", "fail"});
+
+            const auto us = fc::microseconds(50);
+            stats.record("calculator_api", "add", us, false, 10, 0);
+            stats.record("calculator_api", "add", us, true, 10, 0);
+            stats.record("0", "add", us, false, 10, 0);
+            stats.record("", "fail", us, false, 10, 0);
+
+            BOOST_TEST_MESSAGE("Client supplied names end up in a single entry");
+            for (uint32_t i = 0; i < 1000; ++i) {
+                stats.record("calculator_api", "method" + std::to_string(i), us, true, 10, 0);
+                stats.record("api" + std::to_string(i), "add", us, true, 10, 0);
+                stats.record(std::to_string(i), "method" + std::to_string(i), us, true, 10, 0);
+            }
+
+            auto result = stats.get_stats();
+            BOOST_CHECK_EQUAL(result.methods.size(), 4);
+
+            auto add = find_stats(result, "calculator_api", "add");
+            BOOST_REQUIRE(add != nullptr);
+            BOOST_CHECK_EQUAL(add->calls, 2);
+            BOOST_CHECK_EQUAL(add->errors, 1);
+            BOOST_CHECK_EQUAL(add->latency_histogram[0], 2);
+            BOOST_CHECK_EQUAL(add->response_bytes, 20);
+
+            // numeric api ids are valid on one connection only
+            auto by_id = find_stats(result, "", "add");
+            BOOST_REQUIRE(by_id != nullptr);
+            BOOST_CHECK_EQUAL(by_id->calls, 1);
+            BOOST_REQUIRE(find_stats(result, "", "fail") != nullptr);
+
+            auto unknown = find_stats(result, "", api_method_stats::unknown_method);
+            BOOST_REQUIRE(unknown != nullptr);
+            BOOST_CHECK_EQUAL(unknown->calls, 3000);
+            BOOST_CHECK_EQUAL(unknown->errors, 3000);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(connection_records_calls) {
+        try {
+            auto stats = std::make_shared<api_method_stats>(db);
+            stats->add_api("calculator_api", {"add", "fail"});
+
+            test_websocket_connection socket;
+            auto wsc = std::make_shared<batch_api_connection>(socket, 10, stats);
+            wsc->register_api(fc::api<calculator_api>(std::make_shared<calculator_api>()));
+
+            BOOST_CHECK_EQUAL(socket.on_http(R"({"id":1,"method":"call","params":[0,"add",[2,3]]})"),
+                              R"({"id":1,"jsonrpc":"2.0","result":5})");
+            BOOST_CHECK(socket.on_http(R"({"id":2,"method":"call","params":[0,"fail",[]]})").find("\"error\"") !=
+                        std::string::npos);
+            socket.on_message(R"({"id":3,"method":"call","params":[0,"add",[1,1]]})");
+            BOOST_REQUIRE_EQUAL(socket.sent.size(), 1);
+            BOOST_CHECK_EQUAL(socket.sent[0], R"({"id":3,"jsonrpc":"2.0","result":2})");
+
+            socket.on_http(R"({"id":4,"method":"call","params":[0,"no_such_method",[]]})");
+
+            auto result = stats->get_stats();
+            auto add = find_stats(result, "", "add");
+            BOOST_REQUIRE(add != nullptr);
+            BOOST_CHECK_EQUAL(add->calls, 2);
+            BOOST_CHECK_EQUAL(add->errors, 0);
+
+            auto fail = find_stats(result, "", "fail");
+            BOOST_REQUIRE(fail != nullptr);
+            BOOST_CHECK_EQUAL(fail->calls, 1);
+            BOOST_CHECK_EQUAL(fail->errors, 1);
+
+            auto unknown = find_stats(result, "", api_method_stats::unknown_method);
+            BOOST_REQUIRE(unknown != nullptr);
+            BOOST_CHECK_EQUAL(unknown->errors, 1);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(json_methods) {
+        try {
+            test_websocket_connection socket;
+            auto wsc = std::make_shared<batch_api_connection>(socket, 10, nullptr);
+            wsc->register_api(fc::api<calculator_api>(std::make_shared<calculator_api>()));
+
+            uint32_t calls = 0;
+            wsc->add_json_method("calculator_api", "add", 2, [&](const fc::variants &args) {
+                ++calls;
+                return to_json(args[0].as<int64_t>() + args[1].as<int64_t>());
+            });
+            wsc->add_json_method("calculator_api", "fail", 0, [&](const fc::variants &) -> std::string {
+                ++calls;
+                FC_THROW("Requested failure");
+            });
+
+            BOOST_TEST_MESSAGE("The reply written by the handler is the reply of the generic path");
+            BOOST_CHECK_EQUAL(socket.on_http(R"({"id":1,"method":"call","params":["calculator_api","add",[2,3]]})"),
+                              socket.on_http(R"({"id":1,"method":"call","params":[0,"add",[2,3]]})"));
+            BOOST_CHECK_EQUAL(calls, 1);
+
+            socket.on_message(R"({"id":2,"method":"call","params":["calculator_api","add",[1,1]]})");
+            BOOST_REQUIRE_EQUAL(socket.sent.size(), 1);
+            BOOST_CHECK_EQUAL(socket.sent[0], R"({"id":2,"jsonrpc":"2.0","result":2})");
+            BOOST_CHECK_EQUAL(calls, 2);
+
+            BOOST_TEST_MESSAGE("A failed handler is reported once, without running the call again");
+            auto failed = socket.on_http(R"({"id":3,"method":"call","params":["calculator_api","fail",[]]})");
+            BOOST_CHECK(failed.find("\"error\"") != std::string::npos);
+            BOOST_CHECK(failed.find("Requested failure") != std::string::npos);
+            BOOST_CHECK_EQUAL(calls, 3);
+
+            BOOST_TEST_MESSAGE("Calls with other arguments go the generic way");
+            socket.on_http(R"({"id":4,"method":"call","params":["calculator_api","add",[2]]})");
+            socket.on_http(R"({"id":5,"method":"call","params":[0,"add",[2,3]]})");
+            BOOST_CHECK_EQUAL(calls, 3);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(batch_requests) {
+        try {
+            test_websocket_connection socket;
+            auto calculator = std::make_shared<calculator_api>();
+            auto wsc = std::make_shared<batch_api_connection>(socket, 3, nullptr);
+            wsc->register_api(fc::api<calculator_api>(calculator));
+
+            auto error_code = [](const std::string &reply) {
+                auto error = fc::json::from_string(reply).get_object();
+                BOOST_CHECK(error["id"].is_null());
+                return error["error"].get_object()["code"].as_int64();
+            };
+
+            BOOST_TEST_MESSAGE("Replies keep the order of the requests");
+            auto replies = fc::json::from_string(socket.on_http(
+                    R"([{"id":1,"method":"call","params":[0,"add",[1,2]]},)"
+                    R"({"id":2,"method":"call","params":[0,"fail",[]]},)"
+                    R"({"id":3,"method":"call","params":[0,"add",[3,4]]}])")).get_array();
+            BOOST_REQUIRE_EQUAL(replies.size(), 3);
+            BOOST_CHECK_EQUAL(replies[0]["id"].as_int64(), 1);
+            BOOST_CHECK_EQUAL(replies[0]["result"].as_int64(), 3);
+            BOOST_CHECK_EQUAL(replies[1]["id"].as_int64(), 2);
+            BOOST_CHECK(replies[1].get_object().contains("error"));
+            BOOST_CHECK_EQUAL(replies[2]["id"].as_int64(), 3);
+            BOOST_CHECK_EQUAL(replies[2]["result"].as_int64(), 7);
+            BOOST_CHECK_EQUAL(calculator->calls, 3);
+
+            BOOST_TEST_MESSAGE("Members without an id are run but get no reply");
+            replies = fc::json::from_string(socket.on_http(
+                    R"([{"method":"call","params":[0,"add",[1,1]]},)"
+                    R"({"id":5,"method":"call","params":[0,"add",[2,2]]}])")).get_array();
+            BOOST_REQUIRE_EQUAL(replies.size(), 1);
+            BOOST_CHECK_EQUAL(replies[0]["id"].as_int64(), 5);
+            BOOST_CHECK_EQUAL(calculator->calls, 5);
+
+            BOOST_CHECK_EQUAL(socket.on_http(R"([{"method":"call","params":[0,"add",[1,1]]}])"), "");
+            BOOST_CHECK_EQUAL(calculator->calls, 6);
+
+            BOOST_TEST_MESSAGE("A websocket batch is sent as one message");
+            socket.on_message(R"( [{"id":6,"method":"call","params":[0,"add",[1,1]]},)"
+                              R"({"id":7,"method":"call","params":[0,"add",[2,2]]}])");
+            BOOST_REQUIRE_EQUAL(socket.sent.size(), 1);
+            BOOST_CHECK_EQUAL(socket.sent[0], R"([{"id":6,"jsonrpc":"2.0","result":2},)"
+                                              R"({"id":7,"jsonrpc":"2.0","result":4}])");
+            BOOST_CHECK_EQUAL(calculator->calls, 8);
+
+            BOOST_TEST_MESSAGE("Empty and oversized batches are invalid requests");
+            BOOST_CHECK_EQUAL(error_code(socket.on_http("[]")), -32600);
+            BOOST_CHECK_EQUAL(error_code(socket.on_http(
+                    R"([{"id":1,"method":"call","params":[0,"add",[1,1]]},)"
+                    R"({"id":2,"method":"call","params":[0,"add",[1,1]]},)"
+                    R"({"id":3,"method":"call","params":[0,"add",[1,1]]},)"
+                    R"({"id":4,"method":"call","params":[0,"add",[1,1]]}])")), -32600);
+            BOOST_CHECK_EQUAL(calculator->calls, 8);
+
+            BOOST_TEST_MESSAGE("A malformed batch is a parse error");
+            BOOST_CHECK_EQUAL(error_code(socket.on_http(R"([{"id":1,"method":"call","params":[0,"add",[1,1]]})")),
+                              -32700);
+            BOOST_CHECK_EQUAL(calculator->calls, 8);
+
+            socket.on_message("[");
+            BOOST_REQUIRE_EQUAL(socket.sent.size(), 2);
+            BOOST_CHECK_EQUAL(error_code(socket.sent[1]), -32700);
+
+            BOOST_TEST_MESSAGE("Members which are not requests are invalid requests");
+            replies = fc::json::from_string(socket.on_http(
+                    R"([1,{"id":8,"method":"call","params":[0,"add",[1,1]]},{"foo":"bar"}])")).get_array();
+            BOOST_REQUIRE_EQUAL(replies.size(), 3);
+            BOOST_CHECK_EQUAL(error_code(fc::json::to_string(replies[0])), -32600);
+            BOOST_CHECK_EQUAL(replies[1]["result"].as_int64(), 2);
+            BOOST_CHECK_EQUAL(error_code(fc::json::to_string(replies[2])), -32600);
+            BOOST_CHECK_EQUAL(calculator->calls, 9);
+
+            BOOST_TEST_MESSAGE("Malformed single requests get error objects as well");
+            BOOST_CHECK_EQUAL(error_code(socket.on_http(R"({"id":1,"method":"call")")), -32700);
+            BOOST_CHECK_EQUAL(error_code(socket.on_http("1")), -32600);
+
+            socket.on_message("{");
+            BOOST_REQUIRE_EQUAL(socket.sent.size(), 3);
+            BOOST_CHECK_EQUAL(error_code(socket.sent[2]), -32700);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(binary_results) {
+        try {
+            test_websocket_connection socket;
+            auto wsc = std::make_shared<batch_api_connection>(socket, 10, nullptr);
+            auto calculator = std::make_shared<calculator_api>();
+            wsc->register_api(fc::api<calculator_api>(calculator));
+
+            uint32_t binary_calls = 0;
+            wsc->add_binary_method("calculator_api", "add", [&](const fc::variants &args) {
+                ++binary_calls;
+                FC_ASSERT(args.size() == 2);
+                return fc::raw::pack(calculator->add(args[0].as<int64_t>(), args[1].as<int64_t>()));
+            });
+
+            const std::string request = R"({"id":1,"method":"call","params":["calculator_api","add",[2,3]]})";
+
+            BOOST_TEST_MESSAGE("Binary results are off by default");
+            BOOST_CHECK(socket.on_http(request).find("\"error\"") != std::string::npos);
+            BOOST_CHECK_EQUAL(binary_calls, 0);
+
+            auto methods = wsc->set_binary_results(true);
+            BOOST_REQUIRE_EQUAL(methods.size(), 1);
+            BOOST_CHECK_EQUAL(methods[0], "calculator_api.add");
+
+            auto reply = fc::json::from_string(socket.on_http(request)).get_object();
+            BOOST_CHECK_EQUAL(reply["id"].as_int64(), 1);
+            auto packed = fc::base64_decode(reply["result"].as_string());
+            BOOST_CHECK_EQUAL(fc::raw::unpack<int64_t>(std::vector<char>(packed.begin(), packed.end())), 5);
+            BOOST_CHECK_EQUAL(binary_calls, 1);
+            BOOST_CHECK_EQUAL(calculator->calls, 1);
+
+            BOOST_TEST_MESSAGE("A failed binary call is answered with a JSON error and not run again");
+            auto failed = socket.on_http(R"({"id":2,"method":"call","params":["calculator_api","add",[2]]})");
+            BOOST_CHECK(failed.find("\"error\"") != std::string::npos);
+            BOOST_CHECK_EQUAL(binary_calls, 2);
+            BOOST_CHECK_EQUAL(calculator->calls, 1);
+
+            BOOST_TEST_MESSAGE("Other methods keep JSON results");
+            BOOST_CHECK_EQUAL(socket.on_http(R"({"id":3,"method":"call","params":[0,"add",[1,1]]})"),
+                              R"({"id":3,"jsonrpc":"2.0","result":2})");
+
+            wsc->set_binary_results(false);
+            BOOST_CHECK(socket.on_http(request).find("\"error\"") != std::string::npos);
+            BOOST_CHECK_EQUAL(binary_calls, 2);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(response_cache) {
+        try {
+            auto cache = std::make_shared<api_response_cache>(db);
+            cache->set_max_size(2);
+
+            test_websocket_connection socket;
+            auto wsc = std::make_shared<batch_api_connection>(socket, 10, nullptr, cache);
+
+            uint32_t calls = 0;
+            wsc->add_json_method("calculator_api", "add", 2, [&](const fc::variants &args) {
+                ++calls;
+                return to_json(args[0].as<int64_t>() + args[1].as<int64_t>());
+            }, true);
+            wsc->add_json_method("calculator_api", "sub", 2, [&](const fc::variants &args) {
+                ++calls;
+                return to_json(args[0].as<int64_t>() - args[1].as<int64_t>());
+            });
+
+            BOOST_TEST_MESSAGE("The first call misses, the same call with another id hits");
+            BOOST_CHECK_EQUAL(socket.on_http(R"({"id":1,"method":"call","params":["calculator_api","add",[2,3]]})"),
+                              R"({"id":1,"jsonrpc":"2.0","result":5})");
+            BOOST_CHECK_EQUAL(socket.on_http(R"({"id":2,"method":"call","params":["calculator_api","add",[2,3]]})"),
+                              R"({"id":2,"jsonrpc":"2.0","result":5})");
+            BOOST_CHECK_EQUAL(calls, 1);
+
+            auto stats = cache->get_stats();
+            BOOST_CHECK_EQUAL(stats.size, 1);
+            BOOST_CHECK_EQUAL(stats.hits, 1);
+            BOOST_CHECK_EQUAL(stats.misses, 1);
+
+            BOOST_TEST_MESSAGE("Other arguments miss, methods not added as cached are always run");
+            BOOST_CHECK_EQUAL(socket.on_http(R"({"id":3,"method":"call","params":["calculator_api","add",[3,2]]})"),
+                              R"({"id":3,"jsonrpc":"2.0","result":5})");
+            socket.on_http(R"({"id":4,"method":"call","params":["calculator_api","sub",[3,2]]})");
+            socket.on_http(R"({"id":5,"method":"call","params":["calculator_api","sub",[3,2]]})");
+            BOOST_CHECK_EQUAL(calls, 4);
+
+            BOOST_TEST_MESSAGE("A full cache answers without storing");
+            socket.on_http(R"({"id":6,"method":"call","params":["calculator_api","add",[1,1]]})");
+            socket.on_http(R"({"id":7,"method":"call","params":["calculator_api","add",[1,1]]})");
+            BOOST_CHECK_EQUAL(calls, 6);
+
+            stats = cache->get_stats();
+            BOOST_CHECK_EQUAL(stats.size, 2);
+            BOOST_CHECK_EQUAL(stats.hits, 1);
+            BOOST_CHECK_EQUAL(stats.misses, 4);
+
+            BOOST_TEST_MESSAGE("A new block drops the cached replies");
+            generate_block();
+            socket.on_http(R"({"id":8,"method":"call","params":["calculator_api","add",[2,3]]})");
+            BOOST_CHECK_EQUAL(calls, 7);
+            socket.on_http(R"({"id":9,"method":"call","params":["calculator_api","add",[2,3]]})");
+            BOOST_CHECK_EQUAL(calls, 7);
+
+            stats = cache->get_stats();
+            BOOST_CHECK_EQUAL(stats.size, 1);
+            BOOST_CHECK_EQUAL(stats.hits, 2);
+            BOOST_CHECK_EQUAL(stats.misses, 5);
+
+            BOOST_TEST_MESSAGE("A disabled cache runs every call");
+            cache->set_max_size(0);
+            socket.on_http(R"({"id":10,"method":"call","params":["calculator_api","add",[2,3]]})");
+            BOOST_CHECK_EQUAL(calls, 8);
+            BOOST_CHECK_EQUAL(cache->get_stats().size, 0);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(discussion_pages) {
+        try {
+            boost::program_options::variables_map options;
+            app.register_plugin<golos::tags::tags_plugin>()->plugin_initialize(options);
+            app.register_plugin<golos::languages::languages_plugin>()->plugin_initialize(options);
+
+            ACTORS((alice)(bob)(carol)(dave)(erin)(frank));
+            for (const auto &name : {"alice", "bob", "carol", "dave", "erin", "frank"}) {
+                fund(name, 1000000);
+            }
+
+            auto post = [&](const std::string &author, const fc::ecc::private_key &key, const std::string &category,
+                            const std::string &metadata, const std::string &parent_author = std::string()) {
+                comment_operation<0, 17, 0> op;
+                op.author = author;
+                op.permlink = "post-" + author;
+                op.parent_author = parent_author;
+                op.parent_permlink = parent_author.empty() ? category : "post-" + parent_author;
+                op.title = "Title of " + author;
+                op.body = "Body written by " + author;
+                op.json_metadata = metadata;
+
+                signed_transaction tx;
+                tx.operations.push_back(op);
+                tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+                tx.sign(key, db.get_chain_id());
+                db.push_transaction(tx, 0);
+                generate_block();
+            };
+
+            post("alice", alice_private_key, "golos", R"({"tags":["test"],"language":"ru"})");
+            post("bob", bob_private_key, "golos", R"({"language":"en"})");
+            post("carol", carol_private_key, "test", R"({"language":"ru"})");
+            post("dave", dave_private_key, "golos", R"({"tags":["nsfw"],"language":"ru"})");
+            post("erin", erin_private_key, "golos", "");
+            post("frank", frank_private_key, "golos", R"({"language":"ru"})", "alice");
+
+            auto session = std::make_shared<golos::application::api_session_data>();
+            golos::application::database_api api(golos::application::api_context(app, "database_api", session));
+
+            // each discussion of a page is the one get_discussion() builds for the comment
+            auto check_page = [&](const std::vector<discussion> &page, const std::vector<std::string> &authors,
+                                  uint32_t truncate_body) {
+                BOOST_REQUIRE_EQUAL(page.size(), authors.size());
+                for (std::size_t i = 0; i < page.size(); ++i) {
+                    BOOST_CHECK_EQUAL(std::string(page[i].author), authors[i]);
+                    auto expected = api.get_discussion(db.get_comment(authors[i], "post-" + authors[i]).id,
+                                                       truncate_body);
+                    BOOST_CHECK_EQUAL(fc::json::to_string(fc::variant(page[i])),
+                                      fc::json::to_string(fc::variant(expected)));
+                }
+            };
+
+            discussion_query query;
+            query.limit = 10;
+            query.select_tags = {"golos"};
+
+            BOOST_TEST_MESSAGE("Root posts of a tag, newest first");
+            check_page(api.get_discussions_by_created(query), {"erin", "dave", "bob", "alice"}, 0);
+
+            BOOST_TEST_MESSAGE("Paging with start_author and start_permlink");
+            query.limit = 2;
+            check_page(api.get_discussions_by_created(query), {"erin", "dave"}, 0);
+            query.start_author = "dave";
+            query.start_permlink = "post-dave";
+            check_page(api.get_discussions_by_created(query), {"dave", "bob"}, 0);
+            query.start_author = "bob";
+            query.start_permlink = "post-bob";
+            check_page(api.get_discussions_by_created(query), {"bob", "alice"}, 0);
+
+            BOOST_TEST_MESSAGE("Filtered candidates don't count toward the limit");
+            query.start_author.reset();
+            query.start_permlink.reset();
+            query.filter_tags = {"nsfw"};
+            check_page(api.get_discussions_by_created(query), {"erin", "bob"}, 0);
+            query.filter_tags.clear();
+
+            BOOST_TEST_MESSAGE("Tag and language candidates are intersected");
+            query.limit = 10;
+            query.select_tags = {"golos", "ru"};
+            check_page(api.get_discussions_by_created(query), {"dave", "alice"}, 0);
+
+            BOOST_TEST_MESSAGE("Bodies are truncated to truncate_body");
+            query.select_tags = {"golos"};
+            query.limit = 1;
+            query.truncate_body = 4;
+            auto page = api.get_discussions_by_created(query);
+            check_page(page, {"erin"}, 4);
+            BOOST_CHECK_EQUAL(page[0].body, "Body");
+            BOOST_CHECK_EQUAL(page[0].body_length, std::string("Body written by erin").size());
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
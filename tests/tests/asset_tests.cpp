@@ -7,6 +7,9 @@
 #include <golos/chain/objects/account_object.hpp>
 #include <golos/chain/objects/asset_object.hpp>
 
+#include <golos/application/api_context.hpp>
+#include <golos/application/database_api.hpp>
+
 #include <fc/crypto/digest.hpp>
 
 #include "../common/database_fixture.hpp"
@@ -426,4 +429,60 @@ BOOST_AUTO_TEST_CASE(asset_name_test) {
         }
 }
 
+BOOST_AUTO_TEST_CASE(balances_by_asset_id) {
+        try {
+            ACTORS((dan)(sam));
+            const asset_object &zeta = create_user_issued_asset("ZETA", sam, 0);
+            const asset_object &alpha = create_user_issued_asset("ALPHA", sam, 0);
+            BOOST_REQUIRE(zeta.id < alpha.id);
+
+            BOOST_TEST_MESSAGE("Checking the cached ids of the core assets");
+            BOOST_CHECK(db.get_asset_id(STEEM_SYMBOL_NAME) == db.get_asset(STEEM_SYMBOL_NAME).id);
+            BOOST_CHECK(db.get_asset_id(SBD_SYMBOL_NAME) == db.get_asset(SBD_SYMBOL_NAME).id);
+            BOOST_CHECK(db.get_asset_id("ALPHA") == alpha.id);
+
+            issue_uia(dan, zeta.amount(300));
+            issue_uia(dan, alpha.amount(100));
+            db.adjust_balance(dan, alpha.amount(50), alpha);
+            db.adjust_balance(dan, -zeta.amount(100));
+
+            BOOST_TEST_MESSAGE("Checking balances looked up by name and by asset");
+            BOOST_CHECK_EQUAL(get_balance(dan, alpha), 150);
+            BOOST_CHECK_EQUAL(get_balance(dan, zeta), 200);
+            BOOST_CHECK(db.get_balance(dan.name, "ALPHA") == alpha.amount(150));
+            BOOST_CHECK(db.get_balance(dan, asset_name_type("ZETA")) == zeta.amount(200));
+            BOOST_CHECK(db.get_balance(dan.name, "NOSUCH").amount == 0);
+
+            const auto &by_account = db.get_index<account_balance_index>().indices().get<by_account_asset>();
+            auto itr = by_account.find(boost::make_tuple(dan.name, alpha.id));
+            BOOST_REQUIRE(itr != by_account.end());
+            BOOST_CHECK(itr->asset_name == alpha.asset_name);
+            BOOST_CHECK(itr->asset_id == alpha.id);
+
+            STEEMIT_REQUIRE_THROW(db.adjust_balance(dan, -alpha.amount(151), alpha), fc::exception);
+
+            BOOST_TEST_MESSAGE("Checking get_account_balances keeps the order by asset name");
+            auto session = std::make_shared<golos::application::api_session_data>();
+            golos::application::database_api api(golos::application::api_context(app, "database_api", session));
+
+            auto balances = api.get_account_balances("dan", {});
+            BOOST_REQUIRE_EQUAL(balances.size(), 4);
+            BOOST_CHECK(std::is_sorted(balances.begin(), balances.end(),
+                                       [](const asset<0, 17, 0> &a, const asset<0, 17, 0> &b) {
+                                           return a.symbol < b.symbol;
+                                       }));
+            BOOST_CHECK(balances.front().symbol == "ALPHA");
+            BOOST_CHECK(balances.back() == zeta.amount(200));
+
+            balances = api.get_account_balances("dan", {"ZETA", "ALPHA"});
+            BOOST_REQUIRE_EQUAL(balances.size(), 2);
+            BOOST_CHECK(balances[0] == alpha.amount(150));
+            BOOST_CHECK(balances[1] == zeta.amount(200));
+        }
+        catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
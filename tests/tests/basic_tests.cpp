@@ -289,4 +289,83 @@ BOOST_FIXTURE_TEST_SUITE(basic_tests, clean_database_fixture)
         BOOST_CHECK(block.calculate_merkle_root() == c(dO));
     }
 
+    BOOST_AUTO_TEST_CASE(hashed_lookups) {
+        try {
+            ACTORS((alice)(bob));
+            fund("alice", 10000);
+            generate_block();
+
+            comment_operation<0, 17, 0> comment;
+            comment.author = "alice";
+            comment.permlink = "post";
+            comment.parent_permlink = "test";
+            comment.title = "title";
+            comment.body = "body";
+            trx.operations.push_back(comment);
+            trx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            db.push_transaction(trx, ~0);
+            trx.operations.clear();
+            generate_block();
+
+            const auto &accounts = db.get_index<account_index>().indices().get<by_name>();
+            const auto &witnesses = db.get_index<witness_index>().indices().get<by_name>();
+            const auto &authorities = db.get_index<account_authority_index>().indices().get<by_account>();
+
+            BOOST_TEST_MESSAGE("Hashed lookups find what the ordered indexes hold");
+            BOOST_CHECK(db.find_account("alice") == &*accounts.find("alice"));
+            BOOST_CHECK(&db.get_account("bob") == &*accounts.find("bob"));
+            BOOST_CHECK(db.find_account("carol") == nullptr);
+            BOOST_CHECK(db.find_witness(STEEMIT_INIT_MINER_NAME) == &*witnesses.find(STEEMIT_INIT_MINER_NAME));
+            BOOST_CHECK(db.find_witness("alice") == nullptr);
+            BOOST_CHECK(authorities.find("alice") != authorities.end());
+
+            const auto *post = db.find_comment("alice", std::string("post"));
+            BOOST_REQUIRE(post != nullptr);
+            BOOST_CHECK(post == db.find_comment("alice", post->permlink));
+            BOOST_CHECK(db.find_comment("bob", std::string("post")) == nullptr);
+            BOOST_CHECK(db.find_comment("alice", std::string("pos")) == nullptr);
+
+            BOOST_TEST_MESSAGE("Renamed objects are found by the new key only");
+            const auto alice_id = db.get_account("alice").id;
+            db.modify(db.get_account("alice"), [&](account_object &a) {
+                a.name = "alice2";
+            });
+            BOOST_CHECK(db.find_account("alice") == nullptr);
+            BOOST_REQUIRE(db.find_account("alice2") != nullptr);
+            BOOST_CHECK(db.find_account("alice2")->id == alice_id);
+            BOOST_CHECK(db.find_account("alice2") == &*accounts.find("alice2"));
+            STEEMIT_REQUIRE_THROW(db.get_account("alice"), fc::exception);
+
+            db.modify(db.get_witness(STEEMIT_INIT_MINER_NAME), [&](witness_object &w) {
+                w.owner = "renamedminer";
+            });
+            BOOST_CHECK(db.find_witness(STEEMIT_INIT_MINER_NAME) == nullptr);
+            BOOST_CHECK(db.find_witness("renamedminer") == &*witnesses.find("renamedminer"));
+
+            db.modify(*authorities.find("bob"), [&](account_authority_object &a) {
+                a.account = "bob2";
+            });
+            BOOST_CHECK(authorities.find("bob") == authorities.end());
+            BOOST_CHECK(authorities.find("bob2") != authorities.end());
+
+            db.modify(*post, [&](comment_object &c) {
+                from_string(c.permlink, "renamed");
+            });
+            BOOST_CHECK(db.find_comment("alice", std::string("post")) == nullptr);
+            BOOST_CHECK(db.find_comment("alice", std::string("renamed")) == post);
+            BOOST_CHECK(&db.get_comment("alice", std::string("renamed")) == post);
+
+            BOOST_TEST_MESSAGE("Removed objects are not found");
+            db.remove(*post);
+            BOOST_CHECK(db.find_comment("alice", std::string("renamed")) == nullptr);
+            STEEMIT_REQUIRE_THROW(db.get_comment("alice", std::string("renamed")), fc::exception);
+
+            db.remove(db.get_account("alice2"));
+            BOOST_CHECK(db.find_account("alice2") == nullptr);
+            BOOST_CHECK(accounts.find("alice2") == accounts.end());
+            BOOST_CHECK(db.find_account("bob") != nullptr);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,10 +5,12 @@
 #include <golos/protocol/exceptions.hpp>
 
 #include <golos/chain/database.hpp>
+#include <golos/chain/invariant_checker.hpp>
 #include <golos/chain/objects/steem_objects.hpp>
 #include <golos/chain/objects/history_object.hpp>
 
 #include <golos/account_history/account_history_plugin.hpp>
+#include <golos/market_history/market_history_plugin.hpp>
 
 #include <golos/utilities/tempdir.hpp>
 
@@ -16,12 +18,31 @@
 
 #include "../common/database_fixture.hpp"
 
+#include <algorithm>
+
 using namespace golos;
 using namespace golos::chain;
 using namespace golos::protocol;
 
 #define TEST_SHARED_MEM_SIZE (1024 * 1024 * 8)
 
+namespace {
+    /// Checks that an operation is a version of transfer_operation
+    struct is_transfer_visitor {
+        typedef bool result_type;
+
+        template<typename T>
+        bool operator()(const T &) const {
+            return false;
+        }
+
+        template<uint8_t Major, uint8_t Hardfork, uint16_t Release>
+        bool operator()(const transfer_operation<Major, Hardfork, Release> &) const {
+            return true;
+        }
+    };
+}
+
 BOOST_AUTO_TEST_SUITE(block_tests)
 
     BOOST_AUTO_TEST_CASE(generate_empty_blocks) {
@@ -133,6 +154,258 @@ BOOST_AUTO_TEST_SUITE(block_tests)
         }
     }
 
+    BOOST_AUTO_TEST_CASE(state_snapshot) {
+        try {
+            fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+            fc::temp_directory shared_dir(graphene::utilities::temp_directory_path());
+            fc::temp_directory snapshot_dir(graphene::utilities::temp_directory_path());
+            auto init_account_priv_key = STEEMIT_INIT_PRIVATE_KEY;
+
+            uint32_t head_block_num = 0;
+            block_id_type head_block_id;
+            std::map<std::string, std::size_t> sizes;
+            std::map<std::string, int64_t> next_ids;
+            int64_t removed_id = 0;
+            {
+                database db;
+                db._log_hardforks = false;
+                db.open(data_dir.path(), data_dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE,
+                        chainbase::database::read_write);
+                while (db.get_dynamic_global_properties().last_irreversible_block_num < 50) {
+                    db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                      database::skip_nothing);
+                }
+
+                // the id of a removed last object must not be given out again after the import
+                db.with_write_lock([&]() {
+                    db.create<decline_voting_rights_request_object>([&](decline_voting_rights_request_object &r) {
+                        r.account = account_object::id_type(0);
+                        r.effective_date = fc::time_point_sec::maximum();
+                    });
+                    const auto &removed = db.create<decline_voting_rights_request_object>(
+                            [&](decline_voting_rights_request_object &r) {
+                                r.account = account_object::id_type(1);
+                                r.effective_date = fc::time_point_sec::maximum();
+                            });
+                    removed_id = removed.id._id;
+                    db.remove(removed);
+                });
+                db.close();
+
+                // reopening rewinds the state to the last irreversible block, which is in the block log
+                db.open(data_dir.path(), data_dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE,
+                        chainbase::database::read_write);
+                db.export_state_snapshot(snapshot_dir.path(), 2);
+
+                head_block_num = db.head_block_num();
+                head_block_id = db.head_block_id();
+                for (const auto &info : db.get_index_infos()) {
+                    sizes[info->name()] = info->size();
+                    next_ids[info->name()] = info->next_id();
+                }
+                db.close();
+            }
+            {
+                database db;
+                db._log_hardforks = false;
+                db.open(data_dir.path(), shared_dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE,
+                        chainbase::database::read_write, snapshot_dir.path(), 2);
+
+                BOOST_CHECK_EQUAL(db.head_block_num(), head_block_num);
+                BOOST_CHECK(db.head_block_id() == head_block_id);
+                for (const auto &info : db.get_index_infos()) {
+                    BOOST_CHECK_EQUAL(info->size(), sizes[info->name()]);
+                    BOOST_CHECK_EQUAL(info->next_id(), next_ids[info->name()]);
+                }
+
+                db.with_write_lock([&]() {
+                    const auto &request = db.create<decline_voting_rights_request_object>(
+                            [&](decline_voting_rights_request_object &r) {
+                                r.account = account_object::id_type(2);
+                                r.effective_date = fc::time_point_sec::maximum();
+                            });
+                    BOOST_CHECK_EQUAL(request.id._id, removed_id + 1);
+                });
+
+                for (uint32_t i = 0; i < 10; ++i) {
+                    db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                      database::skip_nothing);
+                }
+                BOOST_CHECK_EQUAL(db.head_block_num(), head_block_num + 10);
+                db.close();
+            }
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(compact_shared_memory) {
+        try {
+            fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+            fc::temp_directory compact_dir(graphene::utilities::temp_directory_path());
+            auto init_account_priv_key = STEEMIT_INIT_PRIVATE_KEY;
+
+            uint32_t head_block_num = 0;
+            uint64_t state_hash = 0;
+            std::map<std::string, int64_t> next_ids;
+            {
+                database db;
+                db._log_hardforks = false;
+                db.open(data_dir.path(), data_dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE,
+                        chainbase::database::read_write);
+                while (db.get_dynamic_global_properties().last_irreversible_block_num < 50) {
+                    db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                      database::skip_nothing);
+                }
+                db.with_write_lock([&]() {
+                    db.remove(db.create<decline_voting_rights_request_object>(
+                            [&](decline_voting_rights_request_object &r) {
+                                r.account = account_object::id_type(0);
+                                r.effective_date = fc::time_point_sec::maximum();
+                            }));
+                });
+                db.close();
+
+                // rewinds the undo history, the compaction reads the state opened read_only
+                db.open(data_dir.path(), data_dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE,
+                        chainbase::database::read_write);
+                db.close();
+                db.open(data_dir.path(), data_dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE,
+                        chainbase::database::read_only);
+                db.compact_shared_memory(compact_dir.path(), TEST_SHARED_MEM_SIZE);
+                BOOST_CHECK_LE(fc::file_size(compact_dir.path() / "shared_memory.bin"), TEST_SHARED_MEM_SIZE);
+
+                head_block_num = db.head_block_num();
+                state_hash = db.calculate_state_hash();
+                for (const auto &info : db.get_index_infos()) {
+                    next_ids[info->name()] = info->next_id();
+                }
+                db.close();
+            }
+            {
+                database db;
+                db._log_hardforks = false;
+                db.open(data_dir.path(), compact_dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE,
+                        chainbase::database::read_write);
+
+                BOOST_CHECK_EQUAL(db.head_block_num(), head_block_num);
+                BOOST_CHECK_EQUAL(db.calculate_state_hash(), state_hash);
+                for (const auto &info : db.get_index_infos()) {
+                    BOOST_CHECK_EQUAL(info->next_id(), next_ids[info->name()]);
+                }
+
+                for (uint32_t i = 0; i < 10; ++i) {
+                    db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                      database::skip_nothing);
+                }
+                BOOST_CHECK_EQUAL(db.head_block_num(), head_block_num + 10);
+                db.close();
+            }
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(state_hash) {
+        try {
+            fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+            auto init_account_priv_key = STEEMIT_INIT_PRIVATE_KEY;
+
+            database db;
+            db._log_hardforks = false;
+            db.set_state_hash(true);
+            db.open(data_dir.path(), data_dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE,
+                    chainbase::database::read_write);
+            BOOST_REQUIRE(db.is_state_hash_enabled());
+            BOOST_CHECK_EQUAL(db.get_state_hash(), db.calculate_state_hash());
+
+            for (uint32_t i = 0; i < 5; ++i) {
+                db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                  database::skip_nothing);
+                BOOST_CHECK_EQUAL(db.get_state_hash(), db.calculate_state_hash());
+                BOOST_REQUIRE(db.get_state_hash(db.head_block_num()).valid());
+                BOOST_CHECK_EQUAL(*db.get_state_hash(db.head_block_num()), db.get_state_hash());
+            }
+
+            auto hash = *db.get_state_hash(db.head_block_num() - 1);
+            db.pop_block();
+            BOOST_CHECK_EQUAL(db.get_state_hash(), hash);
+            BOOST_CHECK_EQUAL(db.get_state_hash(), db.calculate_state_hash());
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(chunked_invariants_check) {
+        try {
+            fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+            auto init_account_priv_key = STEEMIT_INIT_PRIVATE_KEY;
+
+            database db;
+            db._log_hardforks = false;
+            db.open(data_dir.path(), data_dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE,
+                    chainbase::database::read_write);
+
+            for (uint32_t i = 0; i < 5; ++i) {
+                db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                  database::skip_nothing);
+            }
+
+            invariant_checker checker(db, 1);
+            uint32_t steps = 1;
+            while (!checker.step()) {
+                ++steps;
+            }
+            BOOST_CHECK(checker.done());
+            BOOST_CHECK_GT(steps, db.get_index<account_index>().indices().size());
+
+            db.modify(db.get_dynamic_global_properties(), [&](dynamic_global_property_object &gpo) {
+                gpo.current_supply += asset<0, 17, 0>(1, STEEM_SYMBOL_NAME);
+            });
+
+            invariant_checker broken_checker(db, 1);
+            STEEMIT_REQUIRE_THROW(while (!broken_checker.step()) {}, fc::exception);
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(memory_usage) {
+        try {
+            fc::temp_directory data_dir(graphene::utilities::temp_directory_path());
+
+            database db;
+            db._log_hardforks = false;
+            db.open(data_dir.path(), data_dir.path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE,
+                    chainbase::database::read_write);
+
+            auto usage = db.get_memory_usage();
+            BOOST_CHECK_EQUAL(usage.size(), db.get_index_infos().size());
+
+            for (std::size_t i = 0; i < usage.size(); ++i) {
+                BOOST_CHECK_EQUAL(usage[i].total_bytes,
+                                  usage[i].object_bytes + usage[i].dynamic_bytes + usage[i].node_bytes);
+                if (i > 0) {
+                    BOOST_CHECK_GE(usage[i - 1].total_bytes, usage[i].total_bytes);
+                }
+            }
+
+            auto accounts = std::find_if(usage.begin(), usage.end(), [](const index_memory_usage &u) {
+                return u.name == fc::get_typename<account_object>::name();
+            });
+            BOOST_REQUIRE(accounts != usage.end());
+            BOOST_CHECK_EQUAL(accounts->count, db.get_index<account_index>().indices().size());
+            BOOST_CHECK_EQUAL(accounts->object_bytes, accounts->count * sizeof(account_object));
+        } catch (fc::exception &e) {
+            edump((e.to_detail_string()));
+            throw;
+        }
+    }
+
     BOOST_AUTO_TEST_CASE(fork_blocks) {
         try {
             fc::temp_directory data_dir1(graphene::utilities::temp_directory_path());
@@ -647,6 +920,99 @@ BOOST_AUTO_TEST_SUITE(block_tests)
         } FC_LOG_AND_RETHROW();
     }
 
+    BOOST_FIXTURE_TEST_CASE(plugin_rebuild_after_reindex, database_fixture) {
+        try {
+            auto ahplugin = app.register_plugin<golos::account_history::account_history_plugin>();
+            auto mhplugin = app.register_plugin<golos::market_history::market_history_plugin>();
+            boost::program_options::variables_map options;
+            ahplugin->plugin_initialize(options);
+            mhplugin->plugin_initialize(options);
+
+            bool fail_rebuild = false;
+            db.deferred_apply_operation_connect<chain::all_operations>("failing", [&](const operation_notification &) {
+                FC_ASSERT(!fail_rebuild, "Requested failure");
+            });
+
+            open_database();
+
+            auto skip_sigs = database::skip_transaction_signatures | database::skip_authority_check;
+
+            signed_transaction trx;
+            account_create_operation<0, 17, 0> cop;
+            cop.new_account_name = "alice";
+            cop.creator = STEEMIT_INIT_MINER_NAME;
+            cop.owner = authority(1, init_account_pub_key, 1);
+            cop.active = cop.owner;
+            trx.operations.push_back(cop);
+            trx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            trx.sign(init_account_priv_key, db.get_chain_id());
+            PUSH_TX(db, trx, skip_sigs);
+
+            for (uint32_t i = 1; i <= 20; ++i) {
+                trx = decltype(trx)();
+                transfer_operation<0, 17, 0> t;
+                t.from = STEEMIT_INIT_MINER_NAME;
+                t.to = "alice";
+                t.amount = asset<0, 17, 0>(i, STEEM_SYMBOL);
+                trx.operations.push_back(t);
+                trx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+                trx.sign(init_account_priv_key, db.get_chain_id());
+                PUSH_TX(db, trx, skip_sigs);
+
+                db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key, skip_sigs);
+            }
+
+            // only irreversible blocks are replayed
+            const auto last_transfer_block = db.head_block_num();
+            while (db.get_dynamic_global_properties().last_irreversible_block_num < last_transfer_block) {
+                db.generate_block(db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key, skip_sigs);
+            }
+
+            auto index_hashes = [&]() {
+                std::map<std::string, uint64_t> result;
+                for (const auto &info : db.get_index_infos()) {
+                    result[info->name()] = info->hash_objects();
+                }
+                return result;
+            };
+            auto check_hashes = [&](const std::map<std::string, uint64_t> &expected) {
+                for (const auto &hash : index_hashes()) {
+                    BOOST_TEST_MESSAGE(hash.first);
+                    BOOST_CHECK_EQUAL(hash.second, expected.at(hash.first));
+                }
+            };
+
+            const auto log = data_dir->path() / "plugin_operations.log";
+
+            BOOST_TEST_MESSAGE("Plugin indexes updated during the replay");
+            db.set_plugin_rebuild_after_reindex(log, 0);
+            db.reindex(data_dir->path(), data_dir->path(), TEST_SHARED_MEM_SIZE);
+            const auto &history_idx = db.get_index<account_history_index>().indices().get<by_account>();
+            BOOST_CHECK_EQUAL(std::distance(history_idx.lower_bound("alice"), history_idx.upper_bound("alice")), 21);
+            const auto synchronous = index_hashes();
+
+            BOOST_TEST_MESSAGE("Plugin indexes rebuilt after the replay on several threads");
+            db.set_plugin_rebuild_after_reindex(log, 2);
+            db.reindex(data_dir->path(), data_dir->path(), TEST_SHARED_MEM_SIZE);
+            BOOST_CHECK(!fc::exists(log));
+            check_hashes(synchronous);
+
+            BOOST_TEST_MESSAGE("A failed rebuild leaves the log, so the database asks for a reindex");
+            fail_rebuild = true;
+            BOOST_CHECK_THROW(db.reindex(data_dir->path(), data_dir->path(), TEST_SHARED_MEM_SIZE), fc::exception);
+            BOOST_CHECK(fc::exists(log));
+            fail_rebuild = false;
+
+            db.close();
+            BOOST_CHECK_THROW(db.open(data_dir->path(), data_dir->path(), INITIAL_TEST_SUPPLY, TEST_SHARED_MEM_SIZE,
+                                      chainbase::database::read_write), fc::assert_exception);
+
+            db.reindex(data_dir->path(), data_dir->path(), TEST_SHARED_MEM_SIZE);
+            BOOST_CHECK(!fc::exists(log));
+            check_hashes(synchronous);
+        } FC_LOG_AND_RETHROW()
+    }
+
     BOOST_FIXTURE_TEST_CASE(hardfork_test, database_fixture) {
         try {
             try {
@@ -731,5 +1097,241 @@ BOOST_AUTO_TEST_SUITE(block_tests)
         } FC_LOG_AND_RETHROW()
     }
 
+    BOOST_FIXTURE_TEST_CASE(operation_handlers, clean_database_fixture) {
+        try {
+            ACTORS((alice)(bob));
+            fund("alice", 10000);
+            generate_block();
+
+            std::vector<std::string> calls;
+            auto record = [&](const std::string &name) {
+                return [&calls, name](const operation_notification &) {
+                    calls.push_back(name);
+                };
+            };
+
+            db.pre_apply_operation.connect(record("pre generic"));
+            db.post_apply_operation.connect(record("post generic"));
+            db.pre_apply_operation_connect<operation_templates<transfer_operation>>(record("pre transfer"));
+            db.post_apply_operation_connect<operation_templates<transfer_operation>>(record("post transfer"));
+            db.post_apply_operation_connect<operation_templates<transfer_operation, vote_operation>>(
+                    record("post transfer or vote"));
+            db.post_apply_operation_connect<operation_templates<comment_operation>>(record("post comment"));
+            db.post_apply_operation_connect<operation_types<custom_json_operation>>(record("post custom json"));
+
+            auto push = [&](const operation &op) {
+                signed_transaction tx;
+                tx.operations.push_back(op);
+                tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+                db.push_transaction(tx, ~0);
+            };
+
+            BOOST_TEST_MESSAGE("Tag handlers run after the generic slots, in the order of connection");
+            transfer_operation<0, 17, 0> transfer;
+            transfer.from = "alice";
+            transfer.to = "bob";
+            transfer.amount = asset<0, 17, 0>(1, STEEM_SYMBOL_NAME);
+            push(transfer);
+            BOOST_CHECK(calls == std::vector<std::string>({"pre generic", "pre transfer", "post generic",
+                                                           "post transfer", "post transfer or vote"}));
+
+            BOOST_TEST_MESSAGE("Operations outside of the sets reach the generic slots only");
+            calls.clear();
+            custom_json_operation custom;
+            custom.required_posting_auths.insert("alice");
+            custom.id = "test";
+            custom.json = "{}";
+            push(custom);
+            BOOST_CHECK(calls == std::vector<std::string>({"pre generic", "post generic", "post custom json"}));
+
+            calls.clear();
+            transfer_to_vesting_operation<0, 17, 0> vesting;
+            vesting.from = "alice";
+            vesting.amount = asset<0, 17, 0>(1, STEEM_SYMBOL_NAME);
+            push(vesting);
+            BOOST_CHECK(calls == std::vector<std::string>({"pre generic", "post generic"}));
+
+            BOOST_TEST_MESSAGE("Operation sets match every version of a template");
+            const auto tags = operation_set_tags<operation_templates<transfer_operation>>();
+            BOOST_CHECK(std::find(tags.begin(), tags.end(),
+                                  std::size_t(operation::tag<transfer_operation<0, 17, 0>>::value)) != tags.end());
+            for (auto tag : tags) {
+                operation op;
+                op.set_which(tag);
+                BOOST_CHECK(op.visit(is_transfer_visitor()));
+            }
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_FIXTURE_TEST_CASE(virtual_operations_mode, database_fixture) {
+        try {
+            // the account history plugin of clean_database_fixture would observe every operation
+            db_plugin = app.register_plugin<golos::plugin::debug_node::debug_node_plugin>();
+            init_account_pub_key = init_account_priv_key.get_public_key();
+            boost::program_options::variables_map options;
+
+            open_database();
+
+            db_plugin->logging = false;
+            db_plugin->plugin_initialize(options);
+            generate_block();
+            db.set_hardfork(STEEMIT_NUM_HARDFORKS);
+            generate_block();
+            db_plugin->plugin_startup();
+            vest(STEEMIT_INIT_MINER_NAME, 10000);
+
+            ACTORS((alice)(bob));
+            fund("alice", 100000);
+            fund("bob", asset<0, 17, 0>(100000, SBD_SYMBOL_NAME));
+            generate_block();
+
+            auto match_orders = [&](uint32_t order_id) {
+                limit_order_create_operation<0, 17, 0> sell;
+                sell.owner = "alice";
+                sell.order_id = order_id;
+                sell.amount_to_sell = asset<0, 17, 0>(1000, STEEM_SYMBOL_NAME);
+                sell.min_to_receive = asset<0, 17, 0>(1000, SBD_SYMBOL_NAME);
+
+                limit_order_create_operation<0, 17, 0> buy;
+                buy.owner = "bob";
+                buy.order_id = order_id;
+                buy.amount_to_sell = asset<0, 17, 0>(1000, SBD_SYMBOL_NAME);
+                buy.min_to_receive = asset<0, 17, 0>(1000, STEEM_SYMBOL_NAME);
+
+                signed_transaction tx;
+                tx.operations.push_back(sell);
+                tx.operations.push_back(buy);
+                tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+                db.push_transaction(tx, ~0);
+            };
+
+            BOOST_TEST_MESSAGE("auto: a virtual operation nobody subscribed to is not observed");
+            BOOST_CHECK(!db.is_virtual_operation_observed<fill_order_operation<0, 17, 0>>());
+            BOOST_CHECK(!db.is_virtual_operation_observed<interest_operation<0, 17, 0>>());
+
+            BOOST_TEST_MESSAGE("auto: a tag handler makes its operations observed");
+            uint32_t fills = 0;
+            db.post_apply_operation_connect<operation_templates<fill_order_operation>>(
+                    [&](const operation_notification &) {
+                        ++fills;
+                    });
+            BOOST_CHECK(db.is_virtual_operation_observed<fill_order_operation<0, 17, 0>>());
+            BOOST_CHECK(!db.is_virtual_operation_observed<interest_operation<0, 17, 0>>());
+            match_orders(1);
+            BOOST_CHECK_GT(fills, 0);
+            generate_block();
+
+            BOOST_TEST_MESSAGE("auto: a disconnected tag handler no longer makes its operations observed");
+            auto interest_handler = db.post_apply_operation_connect<operation_templates<interest_operation>>(
+                    [](const operation_notification &) {
+                    });
+            BOOST_CHECK(db.is_virtual_operation_observed<interest_operation<0, 17, 0>>());
+            db.disconnect_operation_handler(interest_handler);
+            BOOST_CHECK(!db.is_virtual_operation_observed<interest_operation<0, 17, 0>>());
+            BOOST_CHECK(db.is_virtual_operation_observed<fill_order_operation<0, 17, 0>>());
+
+            BOOST_TEST_MESSAGE("auto: a slot of the generic signals observes every operation from the next block");
+            auto connection = db.post_apply_operation.connect([](const operation_notification &) {
+            });
+            generate_block();
+            BOOST_CHECK(db.is_virtual_operation_observed<interest_operation<0, 17, 0>>());
+            connection.disconnect();
+            generate_block();
+            BOOST_CHECK(!db.is_virtual_operation_observed<interest_operation<0, 17, 0>>());
+
+            BOOST_TEST_MESSAGE("none: no virtual operation is emitted");
+            db.set_virtual_operations_mode(database::virtual_operations_none);
+            BOOST_CHECK(!db.is_virtual_operation_observed<fill_order_operation<0, 17, 0>>());
+            fills = 0;
+            match_orders(2);
+            BOOST_CHECK_EQUAL(fills, 0);
+            generate_block();
+
+            BOOST_TEST_MESSAGE("all: every virtual operation is emitted");
+            db.set_virtual_operations_mode(database::virtual_operations_all);
+            BOOST_CHECK(db.is_virtual_operation_observed<interest_operation<0, 17, 0>>());
+            match_orders(3);
+            BOOST_CHECK_GT(fills, 0);
+
+            db.set_virtual_operations_mode(database::virtual_operations_auto);
+            BOOST_CHECK(!db.is_virtual_operation_observed<interest_operation<0, 17, 0>>());
+        } FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_FIXTURE_TEST_CASE(plugin_handler_stats_counters, clean_database_fixture) {
+        try {
+            ACTORS((alice)(bob));
+            fund("alice", 10000);
+            generate_block();
+
+            auto find_stats = [&](const std::string &plugin) {
+                for (const auto &stats : db.get_plugin_handler_stats()) {
+                    if (stats.plugin == plugin) {
+                        return stats;
+                    }
+                }
+                return plugin_handler_stats();
+            };
+
+            bool fail = false;
+            db.post_apply_operation_connect<operation_templates<transfer_operation>>(
+                    db.measure_plugin_handler<const operation_notification &>("test_plugin",
+                            [&](const operation_notification &) {
+                                FC_ASSERT(!fail, "Requested failure");
+                            }));
+
+            auto push_transfer = [&](int64_t amount) {
+                transfer_operation<0, 17, 0> transfer;
+                transfer.from = "alice";
+                transfer.to = "bob";
+                transfer.amount = asset<0, 17, 0>(amount, STEEM_SYMBOL_NAME);
+
+                signed_transaction tx;
+                tx.operations.push_back(transfer);
+                tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+                db.push_transaction(tx, ~0);
+            };
+
+            BOOST_TEST_MESSAGE("Every call of a measured handler is counted");
+            BOOST_CHECK_EQUAL(find_stats("test_plugin").calls, 0);
+            push_transfer(1);
+            push_transfer(2);
+            auto stats = find_stats("test_plugin");
+            BOOST_CHECK_EQUAL(stats.plugin, "test_plugin");
+            BOOST_CHECK_EQUAL(stats.calls, 2);
+            BOOST_CHECK_EQUAL(stats.exceptions, 0);
+            BOOST_CHECK_LE(stats.max_time, stats.total_time);
+
+            BOOST_TEST_MESSAGE("Exceptions are counted and handled by the database as before");
+            fail = true;
+            push_transfer(3);
+            stats = find_stats("test_plugin");
+            BOOST_CHECK_EQUAL(stats.calls, 3);
+            BOOST_CHECK_EQUAL(stats.exceptions, 1);
+            fail = false;
+
+            BOOST_TEST_MESSAGE("Handlers of other signals are accounted to the same plugin");
+            uint32_t blocks = 0;
+            db.applied_block.connect(db.measure_plugin_handler<const signed_block &>("test_plugin",
+                    [&](const signed_block &) {
+                        ++blocks;
+                    }));
+            generate_block();
+            stats = find_stats("test_plugin");
+            BOOST_CHECK_EQUAL(blocks, 1);
+            // the three transfers are applied again with the block, without failing this time
+            BOOST_CHECK_GE(stats.calls, 3 + 3 + 1);
+            BOOST_CHECK_EQUAL(stats.exceptions, 1);
+
+            BOOST_TEST_MESSAGE("Plugins are reported in the order of their names");
+            const auto all = db.get_plugin_handler_stats();
+            BOOST_CHECK(std::is_sorted(all.begin(), all.end(),
+                                       [](const plugin_handler_stats &a, const plugin_handler_stats &b) {
+                                           return a.plugin < b.plugin;
+                                       }));
+        } FC_LOG_AND_RETHROW()
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
 #endif
@@ -153,10 +153,11 @@ BOOST_AUTO_TEST_CASE( vests_stock_split )
             const auto &by_account_witness_idx = db.get_index<witness_vote_index>().indices();
 
             for (auto vote: by_account_witness_idx) {
-                if (expected_votes.find(vote.witness) == expected_votes.end()) {
-                    expected_votes[vote.witness] = db.get_account(vote.account).witness_vote_weight();
+                const auto &witness = db.get(vote.witness).owner;
+                if (expected_votes.find(witness) == expected_votes.end()) {
+                    expected_votes[witness] = db.get(vote.account).witness_vote_weight();
                 } else {
-                    expected_votes[vote.witness] += db.get_account(vote.account).witness_vote_weight();
+                    expected_votes[witness] += db.get(vote.account).witness_vote_weight();
                 }
             }
 
@@ -1732,7 +1732,7 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             db.push_transaction(tx, 0);
 
             BOOST_REQUIRE(sam_witness.votes == alice.vesting_shares.amount);
-            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.owner, alice.name)) != witness_vote_idx.end());
+            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.id, alice.id)) != witness_vote_idx.end());
             validate_database();
 
             BOOST_TEST_MESSAGE("--- Test revoke vote");
@@ -1744,13 +1744,13 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
 
             db.push_transaction(tx, 0);
             BOOST_REQUIRE(sam_witness.votes.value == 0);
-            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.owner, alice.name)) == witness_vote_idx.end());
+            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.id, alice.id)) == witness_vote_idx.end());
 
             BOOST_TEST_MESSAGE("--- Test failure when attempting to revoke a non-existent vote");
 
             STEEMIT_REQUIRE_THROW(db.push_transaction(tx, database::skip_transaction_dupe_check), fc::exception);
             BOOST_REQUIRE(sam_witness.votes.value == 0);
-            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.owner, alice.name)) == witness_vote_idx.end());
+            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.id, alice.id)) == witness_vote_idx.end());
 
             BOOST_TEST_MESSAGE("--- Test proxied vote");
             proxy("alice", "bob");
@@ -1764,8 +1764,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             db.push_transaction(tx, 0);
 
             BOOST_REQUIRE(sam_witness.votes == (bob.proxied_vsf_votes_total() + bob.vesting_shares.amount));
-            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.owner, bob.name)) != witness_vote_idx.end());
-            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.owner, alice.name)) == witness_vote_idx.end());
+            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.id, bob.id)) != witness_vote_idx.end());
+            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.id, alice.id)) == witness_vote_idx.end());
 
             BOOST_TEST_MESSAGE("--- Test vote from a proxied account");
             tx.operations.clear();
@@ -1776,8 +1776,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             STEEMIT_REQUIRE_THROW(db.push_transaction(tx, database::skip_transaction_dupe_check), fc::exception);
 
             BOOST_REQUIRE(sam_witness.votes == (bob.proxied_vsf_votes_total() + bob.vesting_shares.amount));
-            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.owner, bob.name)) != witness_vote_idx.end());
-            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.owner, alice.name)) == witness_vote_idx.end());
+            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.id, bob.id)) != witness_vote_idx.end());
+            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.id, alice.id)) == witness_vote_idx.end());
 
             BOOST_TEST_MESSAGE("--- Test revoke proxied vote");
             tx.operations.clear();
@@ -1790,8 +1790,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             db.push_transaction(tx, 0);
 
             BOOST_REQUIRE(sam_witness.votes.value == 0);
-            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.owner, bob.name)) == witness_vote_idx.end());
-            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.owner, alice.name)) == witness_vote_idx.end());
+            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.id, bob.id)) == witness_vote_idx.end());
+            BOOST_REQUIRE(witness_vote_idx.find(std::make_tuple(sam_witness.id, alice.id)) == witness_vote_idx.end());
 
             BOOST_TEST_MESSAGE("--- Test failure when voting for a non-existent account");
             tx.operations.clear();
@@ -3994,9 +3994,9 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             const auto &escrow = db.get_escrow(op.from, op.escrow_id);
 
             BOOST_REQUIRE(escrow.escrow_id == op.escrow_id);
-            BOOST_REQUIRE(escrow.from == op.from);
-            BOOST_REQUIRE(escrow.to == op.to);
-            BOOST_REQUIRE(escrow.agent == op.agent);
+            BOOST_REQUIRE(db.get(escrow.from).name == op.from);
+            BOOST_REQUIRE(db.get(escrow.to).name == op.to);
+            BOOST_REQUIRE(db.get(escrow.agent).name == op.agent);
             BOOST_REQUIRE(escrow.ratification_deadline == op.ratification_deadline);
             BOOST_REQUIRE(escrow.escrow_expiration == op.escrow_expiration);
             BOOST_REQUIRE(escrow.sbd_balance == op.sbd_amount);
@@ -4141,8 +4141,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             db.push_transaction(tx, 0);
 
             auto &escrow = db.get_escrow(op.from, op.escrow_id);
-            BOOST_REQUIRE(escrow.to == "bob");
-            BOOST_REQUIRE(escrow.agent == "sam");
+            BOOST_REQUIRE(db.get(escrow.to).name == "bob");
+            BOOST_REQUIRE(db.get(escrow.agent).name == "sam");
             BOOST_REQUIRE(escrow.ratification_deadline == et_op.ratification_deadline);
             BOOST_REQUIRE(escrow.escrow_expiration == et_op.escrow_expiration);
             BOOST_REQUIRE(escrow.sbd_balance == latest_asset::from_string("0.000 TBD"));
@@ -4160,8 +4160,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             tx.sign(bob_private_key, db.get_chain_id());
             STEEMIT_REQUIRE_THROW(db.push_transaction(tx, 0), fc::exception);
 
-            BOOST_REQUIRE(escrow.to == "bob");
-            BOOST_REQUIRE(escrow.agent == "sam");
+            BOOST_REQUIRE(db.get(escrow.to).name == "bob");
+            BOOST_REQUIRE(db.get(escrow.agent).name == "sam");
             BOOST_REQUIRE(escrow.ratification_deadline == et_op.ratification_deadline);
             BOOST_REQUIRE(escrow.escrow_expiration == et_op.escrow_expiration);
             BOOST_REQUIRE(escrow.sbd_balance == latest_asset::from_string("0.000 TBD"));
@@ -4182,8 +4182,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             tx.sign(bob_private_key, db.get_chain_id());
             STEEMIT_REQUIRE_THROW(db.push_transaction(tx, 0), fc::exception);
 
-            BOOST_REQUIRE(escrow.to == "bob");
-            BOOST_REQUIRE(escrow.agent == "sam");
+            BOOST_REQUIRE(db.get(escrow.to).name == "bob");
+            BOOST_REQUIRE(db.get(escrow.agent).name == "sam");
             BOOST_REQUIRE(escrow.ratification_deadline == et_op.ratification_deadline);
             BOOST_REQUIRE(escrow.escrow_expiration == et_op.escrow_expiration);
             BOOST_REQUIRE(escrow.sbd_balance == latest_asset::from_string("0.000 TBD"));
@@ -4298,8 +4298,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
 
             {
                 const auto &escrow = db.get_escrow(op.from, op.escrow_id);
-                BOOST_REQUIRE(escrow.to == "bob");
-                BOOST_REQUIRE(escrow.agent == "sam");
+                BOOST_REQUIRE(db.get(escrow.to).name == "bob");
+                BOOST_REQUIRE(db.get(escrow.agent).name == "sam");
                 BOOST_REQUIRE(escrow.ratification_deadline == et_op.ratification_deadline);
                 BOOST_REQUIRE(escrow.escrow_expiration == et_op.escrow_expiration);
                 BOOST_REQUIRE(escrow.sbd_balance == latest_asset::from_string("0.000 TBD"));
@@ -4319,8 +4319,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             generate_blocks(et_op.ratification_deadline + STEEMIT_BLOCK_INTERVAL, true);
             {
                 const auto &escrow = db.get_escrow(op.from, op.escrow_id);
-                BOOST_REQUIRE(escrow.to == "bob");
-                BOOST_REQUIRE(escrow.agent == "sam");
+                BOOST_REQUIRE(db.get(escrow.to).name == "bob");
+                BOOST_REQUIRE(db.get(escrow.agent).name == "sam");
                 BOOST_REQUIRE(escrow.ratification_deadline == et_op.ratification_deadline);
                 BOOST_REQUIRE(escrow.escrow_expiration == et_op.escrow_expiration);
                 BOOST_REQUIRE(escrow.sbd_balance == latest_asset::from_string("0.000 TBD"));
@@ -4434,8 +4434,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             STEEMIT_REQUIRE_THROW(db.push_transaction(tx, 0), fc::exception);
 
             const auto &escrow = db.get_escrow(et_op.from, et_op.escrow_id);
-            BOOST_REQUIRE(escrow.to == "bob");
-            BOOST_REQUIRE(escrow.agent == "sam");
+            BOOST_REQUIRE(db.get(escrow.to).name == "bob");
+            BOOST_REQUIRE(db.get(escrow.agent).name == "sam");
             BOOST_REQUIRE(escrow.ratification_deadline == et_op.ratification_deadline);
             BOOST_REQUIRE(escrow.escrow_expiration == et_op.escrow_expiration);
             BOOST_REQUIRE(escrow.sbd_balance == et_op.sbd_amount);
@@ -4468,8 +4468,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             tx.sign(alice_private_key, db.get_chain_id());
             STEEMIT_REQUIRE_THROW(db.push_transaction(tx, 0), fc::exception);
 
-            BOOST_REQUIRE(escrow.to == "bob");
-            BOOST_REQUIRE(escrow.agent == "sam");
+            BOOST_REQUIRE(db.get(escrow.to).name == "bob");
+            BOOST_REQUIRE(db.get(escrow.agent).name == "sam");
             BOOST_REQUIRE(escrow.ratification_deadline == et_op.ratification_deadline);
             BOOST_REQUIRE(escrow.escrow_expiration == et_op.escrow_expiration);
             BOOST_REQUIRE(escrow.sbd_balance == et_op.sbd_amount);
@@ -4490,8 +4490,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             tx.sign(alice_private_key, db.get_chain_id());
             STEEMIT_REQUIRE_THROW(db.push_transaction(tx, 0), fc::exception);
 
-            BOOST_REQUIRE(escrow.to == "bob");
-            BOOST_REQUIRE(escrow.agent == "sam");
+            BOOST_REQUIRE(db.get(escrow.to).name == "bob");
+            BOOST_REQUIRE(db.get(escrow.agent).name == "sam");
             BOOST_REQUIRE(escrow.ratification_deadline == et_op.ratification_deadline);
             BOOST_REQUIRE(escrow.escrow_expiration == et_op.escrow_expiration);
             BOOST_REQUIRE(escrow.sbd_balance == et_op.sbd_amount);
@@ -4515,8 +4515,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
 
             {
                 const auto &escrow = db.get_escrow(et_op.from, et_op.escrow_id);
-                BOOST_REQUIRE(escrow.to == "bob");
-                BOOST_REQUIRE(escrow.agent == "sam");
+                BOOST_REQUIRE(db.get(escrow.to).name == "bob");
+                BOOST_REQUIRE(db.get(escrow.agent).name == "sam");
                 BOOST_REQUIRE(escrow.ratification_deadline == et_op.ratification_deadline);
                 BOOST_REQUIRE(escrow.escrow_expiration == et_op.escrow_expiration);
                 BOOST_REQUIRE(escrow.sbd_balance == et_op.sbd_amount);
@@ -4554,8 +4554,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
 
             {
                 const auto &escrow = db.get_escrow(et_op.from, et_op.escrow_id);
-                BOOST_REQUIRE(escrow.to == "bob");
-                BOOST_REQUIRE(escrow.agent == "sam");
+                BOOST_REQUIRE(db.get(escrow.to).name == "bob");
+                BOOST_REQUIRE(db.get(escrow.agent).name == "sam");
                 BOOST_REQUIRE(escrow.ratification_deadline == et_op.ratification_deadline);
                 BOOST_REQUIRE(escrow.escrow_expiration == et_op.escrow_expiration);
                 BOOST_REQUIRE(escrow.sbd_balance == et_op.sbd_amount);
@@ -4577,8 +4577,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
 
             {
                 const auto &escrow = db.get_escrow(et_op.from, et_op.escrow_id);
-                BOOST_REQUIRE(escrow.to == "bob");
-                BOOST_REQUIRE(escrow.agent == "sam");
+                BOOST_REQUIRE(db.get(escrow.to).name == "bob");
+                BOOST_REQUIRE(db.get(escrow.agent).name == "sam");
                 BOOST_REQUIRE(escrow.ratification_deadline == et_op.ratification_deadline);
                 BOOST_REQUIRE(escrow.escrow_expiration == et_op.escrow_expiration);
                 BOOST_REQUIRE(escrow.sbd_balance == et_op.sbd_amount);
@@ -5446,8 +5446,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             BOOST_REQUIRE(db.get_account("alice").balance == latest_asset::from_string("0.000 TESTS"));
             BOOST_REQUIRE(db.get_account("alice").savings_balance == latest_asset::from_string("9.000 TESTS"));
             BOOST_REQUIRE(db.get_account("alice").savings_withdraw_requests == 1);
-            BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).from == op.from);
-            BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).to == op.to);
+            BOOST_REQUIRE(db.get(db.get_savings_withdraw("alice", op.request_id).from).name == op.from);
+            BOOST_REQUIRE(db.get(db.get_savings_withdraw("alice", op.request_id).to).name == op.to);
             BOOST_REQUIRE(to_string(db.get_savings_withdraw("alice", op.request_id).memo) == op.memo);
             BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).request_id == op.request_id);
             BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).amount == op.amount);
@@ -5468,8 +5468,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             BOOST_REQUIRE(db.get_account("alice").sbd_balance == latest_asset::from_string("0.000 TBD"));
             BOOST_REQUIRE(db.get_account("alice").savings_sbd_balance == latest_asset::from_string("9.000 TBD"));
             BOOST_REQUIRE(db.get_account("alice").savings_withdraw_requests == 2);
-            BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).from == op.from);
-            BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).to == op.to);
+            BOOST_REQUIRE(db.get(db.get_savings_withdraw("alice", op.request_id).from).name == op.from);
+            BOOST_REQUIRE(db.get(db.get_savings_withdraw("alice", op.request_id).to).name == op.to);
             BOOST_REQUIRE(to_string(db.get_savings_withdraw("alice", op.request_id).memo) == op.memo);
             BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).request_id == op.request_id);
             BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).amount == op.amount);
@@ -5500,8 +5500,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             BOOST_REQUIRE(db.get_account("alice").balance == latest_asset::from_string("0.000 TESTS"));
             BOOST_REQUIRE(db.get_account("alice").savings_balance == latest_asset::from_string("8.000 TESTS"));
             BOOST_REQUIRE(db.get_account("alice").savings_withdraw_requests == 3);
-            BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).from == op.from);
-            BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).to == op.to);
+            BOOST_REQUIRE(db.get(db.get_savings_withdraw("alice", op.request_id).from).name == op.from);
+            BOOST_REQUIRE(db.get(db.get_savings_withdraw("alice", op.request_id).to).name == op.to);
             BOOST_REQUIRE(to_string(db.get_savings_withdraw("alice", op.request_id).memo) == op.memo);
             BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).request_id == op.request_id);
             BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).amount == op.amount);
@@ -5522,8 +5522,8 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
             BOOST_REQUIRE(db.get_account("alice").sbd_balance == latest_asset::from_string("0.000 TBD"));
             BOOST_REQUIRE(db.get_account("alice").savings_sbd_balance == latest_asset::from_string("8.000 TBD"));
             BOOST_REQUIRE(db.get_account("alice").savings_withdraw_requests == 4);
-            BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).from == op.from);
-            BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).to == op.to);
+            BOOST_REQUIRE(db.get(db.get_savings_withdraw("alice", op.request_id).from).name == op.from);
+            BOOST_REQUIRE(db.get(db.get_savings_withdraw("alice", op.request_id).to).name == op.to);
             BOOST_REQUIRE(to_string(db.get_savings_withdraw("alice", op.request_id).memo) == op.memo);
             BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).request_id == op.request_id);
             BOOST_REQUIRE(db.get_savings_withdraw("alice", op.request_id).amount == op.amount);
@@ -5830,7 +5830,7 @@ BOOST_FIXTURE_TEST_SUITE(operation_tests, clean_database_fixture)
 
             const auto &witness_idx = db.get_index<witness_vote_index>().indices().get<by_account_witness>();
             auto witness_itr = witness_idx.find(
-                    boost::make_tuple(db.get_account("alice").name, db.get_witness("alice").owner));
+                    boost::make_tuple(db.get_account("alice").id, db.get_witness("alice").id));
             BOOST_REQUIRE(witness_itr == witness_idx.end());
 
             tx.clear();
@@ -4,6 +4,7 @@
 
 #include <golos/chain/objects/steem_objects.hpp>
 #include <golos/chain/database.hpp>
+#include <golos/application/json_writer.hpp>
 
 #include <fc/crypto/digest.hpp>
 #include <fc/crypto/elliptic.hpp>
@@ -89,6 +90,48 @@ BOOST_FIXTURE_TEST_SUITE(serialization_tests, clean_database_fixture)
         }
     }
 
+    BOOST_AUTO_TEST_CASE(json_writer_test) {
+        try {
+            using golos::application::to_json;
+
+            golos::application::discussion d;
+            d.author = "alice";
+            d.permlink = "test";
+            d.title = "\"quoted\" \\ title\n";
+            d.body = std::string("tab\tcontrol\x01\x1f unicode \xd0\x9f\xd1\x80\xd0\xb8") + std::string(4096, 'x');
+            d.created = fc::time_point_sec(1500000000);
+            d.total_vote_weight = uint64_t(1) << 40;
+            d.net_votes = -3;
+            d.net_rshares = -(int64_t(1) << 40);
+            d.allow_votes = true;
+            d.active_votes.resize(2);
+            d.active_votes[0].voter = "bob";
+            d.active_votes[0].rshares = 42;
+            d.replies.push_back("bob/re-test");
+            d.reblogged_by.push_back("bob");
+            d.first_reblogged_by = account_name_type("bob");
+
+            BOOST_CHECK_EQUAL(to_json(d), fc::json::to_string(fc::variant(d)));
+
+            d.first_reblogged_by.reset();
+            BOOST_CHECK_EQUAL(to_json(d), fc::json::to_string(fc::variant(d)));
+
+            generate_block();
+            auto block = db.fetch_block_by_number(db.head_block_num());
+            BOOST_REQUIRE(block.valid());
+            BOOST_CHECK_EQUAL(to_json(*block), fc::json::to_string(fc::variant(*block)));
+
+            std::vector<golos::application::discussion> page(3, d);
+            BOOST_CHECK_EQUAL(to_json(page), fc::json::to_string(fc::variant(page)));
+
+            std::map<uint32_t, golos::application::applied_operation> history;
+            history[0].block = db.head_block_num();
+            history[0].op = block->transactions.empty() ? operation() : block->transactions[0].operations[0];
+            history[1].virtual_op = uint64_t(1) << 33;
+            BOOST_CHECK_EQUAL(to_json(history), fc::json::to_string(fc::variant(history)));
+        } FC_LOG_AND_RETHROW();
+    }
+
     BOOST_AUTO_TEST_CASE(asset_test) {
         try {
             BOOST_CHECK_EQUAL(typename BOOST_IDENTITY_TYPE ((latest_asset ))().get_decimals(), 3);
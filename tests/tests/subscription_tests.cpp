@@ -0,0 +1,423 @@
+#ifdef STEEMIT_BUILD_TESTNET
+
+#include <boost/test/unit_test.hpp>
+
+#include <golos/chain/database.hpp>
+
+#include <golos/application/subscription_hub.hpp>
+
+#include <fc/io/json.hpp>
+
+#include "../common/database_fixture.hpp"
+
+#include <algorithm>
+
+using namespace golos::application;
+using namespace golos::chain;
+using namespace golos::protocol;
+
+namespace {
+    struct confirmation {
+        transaction_id_type id;
+        int32_t block_num;
+        int32_t trx_num;
+        bool expired;
+    };
+
+    signed_transaction make_transfer(const std::string &from, const std::string &to, int64_t amount,
+                                     fc::time_point_sec expiration) {
+        transfer_operation<0, 17, 0> op;
+        op.from = from;
+        op.to = to;
+        op.amount = asset<0, 17, 0>(amount, STEEM_SYMBOL_NAME);
+
+        signed_transaction tx;
+        tx.operations.push_back(op);
+        tx.set_expiration(expiration);
+        return tx;
+    }
+
+    void push_operation(database &db, const operation &op) {
+        signed_transaction tx;
+        tx.operations.push_back(op);
+        tx.set_expiration(db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+        db.push_transaction(tx, ~0);
+    }
+
+    /// Keys of the objects of a changed objects update
+    std::vector<std::string> changed_keys(const fc::variant &update) {
+        std::vector<std::string> result;
+        for (const auto &object : update["objects"].get_array()) {
+            result.push_back(fc::json::to_string(object["key"]));
+        }
+        return result;
+    }
+
+    std::vector<uint32_t> feed_block_nums(const std::vector<fc::variant> &entries) {
+        std::vector<uint32_t> result;
+        for (const auto &entry : entries) {
+            result.push_back(entry["block_num"].as<uint32_t>());
+        }
+        return result;
+    }
+
+    std::vector<uint32_t> block_range(uint32_t first, uint32_t last) {
+        std::vector<uint32_t> result;
+        for (auto block_num = first; block_num <= last; ++block_num) {
+            result.push_back(block_num);
+        }
+        return result;
+    }
+}
+
+BOOST_FIXTURE_TEST_SUITE(subscription_tests, clean_database_fixture)
+
+    BOOST_AUTO_TEST_CASE(block_headers) {
+        try {
+            subscription_hub hub(db);
+
+            auto alice = std::make_shared<int>(0);
+            auto bob = std::make_shared<int>(0);
+            auto failing = std::make_shared<int>(0);
+
+            std::vector<fc::variant> alice_headers;
+            std::vector<fc::variant> bob_headers;
+            uint32_t failing_calls = 0;
+            hub.subscribe_block_headers(alice, [&](const fc::variant &header) {
+                alice_headers.push_back(header);
+            });
+            hub.subscribe_block_headers(bob, [&](const fc::variant &header) {
+                bob_headers.push_back(header);
+            });
+            hub.subscribe_block_headers(failing, [&](const fc::variant &) {
+                ++failing_calls;
+                FC_THROW("Requested failure");
+            });
+
+            BOOST_TEST_MESSAGE("Every subscriber gets the header of the applied block");
+            generate_block();
+            hub.flush();
+
+            const auto expected = fc::json::to_string(
+                    fc::variant(signed_block_header(*db.fetch_block_by_number(db.head_block_num()))));
+            BOOST_REQUIRE_EQUAL(alice_headers.size(), 1);
+            BOOST_REQUIRE_EQUAL(bob_headers.size(), 1);
+            BOOST_CHECK_EQUAL(fc::json::to_string(alice_headers[0]), expected);
+            BOOST_CHECK_EQUAL(fc::json::to_string(bob_headers[0]), expected);
+            BOOST_CHECK_EQUAL(failing_calls, 1);
+
+            BOOST_TEST_MESSAGE("A subscription replaces the previous one of the owner");
+            std::vector<fc::variant> alice_new_headers;
+            hub.subscribe_block_headers(alice, [&](const fc::variant &header) {
+                alice_new_headers.push_back(header);
+            });
+
+            BOOST_TEST_MESSAGE("Expired owners and failed callbacks are dropped");
+            bob.reset();
+
+            generate_block();
+            hub.flush();
+
+            BOOST_CHECK_EQUAL(alice_headers.size(), 1);
+            BOOST_CHECK_EQUAL(alice_new_headers.size(), 1);
+            BOOST_CHECK_EQUAL(bob_headers.size(), 1);
+            BOOST_CHECK_EQUAL(failing_calls, 1);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(transaction_confirmations) {
+        try {
+            ACTORS((alice)(bob));
+            fund("alice", 10000);
+            generate_block();
+
+            subscription_hub hub(db);
+
+            auto owner = std::make_shared<int>(0);
+            std::vector<confirmation> confirmations;
+            auto record = [&](const transaction_id_type &id, int32_t block_num, int32_t trx_num, bool expired) {
+                confirmations.push_back({id, block_num, trx_num, expired});
+            };
+
+            BOOST_TEST_MESSAGE("An included transaction is confirmed with its position");
+            auto tx = make_transfer("alice", "bob", 1, db.head_block_time() + STEEMIT_MAX_TIME_UNTIL_EXPIRATION);
+            hub.subscribe_transaction(owner, tx.id(), tx.expiration, record);
+
+            auto gone = std::make_shared<int>(0);
+            hub.subscribe_transaction(gone, tx.id(), tx.expiration, record);
+            gone.reset();
+
+            db.push_transaction(tx, ~0);
+            generate_block();
+            hub.flush();
+
+            BOOST_REQUIRE_EQUAL(confirmations.size(), 1);
+            BOOST_CHECK(confirmations[0].id == tx.id());
+            BOOST_CHECK_EQUAL(confirmations[0].block_num, int32_t(db.head_block_num()));
+            BOOST_CHECK_EQUAL(confirmations[0].trx_num, 0);
+            BOOST_CHECK(!confirmations[0].expired);
+
+            BOOST_TEST_MESSAGE("A transaction which is never included expires once");
+            confirmations.clear();
+            auto never = make_transfer("alice", "bob", 2, db.head_block_time() + STEEMIT_BLOCK_INTERVAL * 2);
+            hub.subscribe_transaction(owner, never.id(), never.expiration, record);
+
+            generate_blocks(2);
+            hub.flush();
+            BOOST_CHECK(confirmations.empty());
+
+            generate_block();
+            hub.flush();
+            BOOST_REQUIRE_EQUAL(confirmations.size(), 1);
+            BOOST_CHECK(confirmations[0].id == never.id());
+            BOOST_CHECK_EQUAL(confirmations[0].block_num, int32_t(db.head_block_num()));
+            BOOST_CHECK_EQUAL(confirmations[0].trx_num, -1);
+            BOOST_CHECK(confirmations[0].expired);
+
+            generate_blocks(2);
+            hub.flush();
+            BOOST_CHECK_EQUAL(confirmations.size(), 1);
+
+            BOOST_TEST_MESSAGE("A confirmed transaction doesn't expire later");
+            confirmations.clear();
+            tx = make_transfer("alice", "bob", 3, db.head_block_time() + STEEMIT_BLOCK_INTERVAL * 2);
+            hub.subscribe_transaction(owner, tx.id(), tx.expiration, record);
+            db.push_transaction(tx, ~0);
+            generate_blocks(4);
+            hub.flush();
+            BOOST_REQUIRE_EQUAL(confirmations.size(), 1);
+            BOOST_CHECK(!confirmations[0].expired);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(changed_objects) {
+        try {
+            ACTORS((alice)(bob)(carol));
+            fund("alice", 10000);
+            generate_block();
+
+            subscription_hub hub(db);
+
+            std::map<std::string, std::vector<fc::variant>> updates;
+            std::map<std::string, std::shared_ptr<int>> owners;
+            auto watch = [&](const std::shared_ptr<int> &owner, const std::vector<std::string> &accounts,
+                             const std::vector<subscription_hub::comment_key> &comments) {
+                subscription_hub::changed_object_keys keys;
+                for (const auto &name : accounts) {
+                    keys.accounts.insert(name);
+                }
+                for (const auto &comment : comments) {
+                    keys.comments.insert(comment);
+                }
+                hub.watch_changed_objects(owner, std::move(keys));
+            };
+            auto subscribe = [&](const std::string &name, const std::vector<std::string> &accounts,
+                                 const std::vector<subscription_hub::comment_key> &comments) {
+                owners[name] = std::make_shared<int>(0);
+                hub.subscribe_changed_objects(owners[name], [&updates, name](const fc::variant &update) {
+                    updates[name].push_back(update);
+                }, false);
+                watch(owners[name], accounts, comments);
+            };
+
+            subscribe("alice_watcher", {"alice"}, {});
+            subscribe("bob_watcher", {"bob"}, {});
+            subscribe("both_watcher", {"alice", "bob"}, {});
+            subscribe("carol_watcher", {"carol"}, {});
+            subscribe("post_watcher", {}, {subscription_hub::comment_key(std::string("alice"), "post")});
+
+            uint32_t failing_calls = 0;
+            auto failing = std::make_shared<int>(0);
+            hub.subscribe_changed_objects(failing, [&](const fc::variant &) {
+                ++failing_calls;
+                FC_THROW("Requested failure");
+            }, false);
+            watch(failing, {"alice"}, {});
+
+            BOOST_TEST_MESSAGE("The 10000 watched keys cap ignores later keys");
+            std::vector<std::string> many;
+            for (std::size_t i = 0; i < subscription_hub::max_watched_keys; ++i) {
+                many.push_back("watched" + std::to_string(i));
+            }
+            subscribe("full_watcher", many, {});
+            watch(owners["full_watcher"], {"alice"}, {});
+            hub.flush();
+
+            transfer_operation<0, 17, 0> transfer;
+            transfer.from = "alice";
+            transfer.to = "bob";
+            transfer.amount = asset<0, 17, 0>(1, STEEM_SYMBOL_NAME);
+            push_operation(db, transfer);
+            generate_block();
+            hub.flush();
+
+            BOOST_TEST_MESSAGE("A session gets the changes it watches in one update per block");
+            BOOST_REQUIRE_EQUAL(updates["alice_watcher"].size(), 1);
+            BOOST_CHECK_EQUAL(updates["alice_watcher"][0]["block_num"].as_uint64(), db.head_block_num());
+            BOOST_CHECK(changed_keys(updates["alice_watcher"][0]) == std::vector<std::string>({"\"alice\""}));
+            const auto &object = updates["alice_watcher"][0]["objects"].get_array()[0];
+            BOOST_CHECK_EQUAL(object["type"].as_string(), "account");
+            BOOST_CHECK_EQUAL(object["object"]["name"].as_string(), "alice");
+
+            BOOST_REQUIRE_EQUAL(updates["bob_watcher"].size(), 1);
+            BOOST_CHECK(changed_keys(updates["bob_watcher"][0]) == std::vector<std::string>({"\"bob\""}));
+
+            BOOST_REQUIRE_EQUAL(updates["both_watcher"].size(), 1);
+            BOOST_CHECK(changed_keys(updates["both_watcher"][0]) ==
+                        std::vector<std::string>({"\"alice\"", "\"bob\""}));
+
+            BOOST_TEST_MESSAGE("Sessions watching nothing that changed aren't called");
+            BOOST_CHECK(updates["carol_watcher"].empty());
+            BOOST_CHECK(updates["post_watcher"].empty());
+            BOOST_CHECK(updates["full_watcher"].empty());
+            BOOST_CHECK_EQUAL(failing_calls, 1);
+
+            BOOST_TEST_MESSAGE("Comments are reported with their object, removed ones with null");
+            comment_operation<0, 17, 0> comment;
+            comment.author = "alice";
+            comment.permlink = "post";
+            comment.parent_permlink = "test";
+            comment.title = "title";
+            comment.body = "body";
+            push_operation(db, comment);
+            generate_block();
+            hub.flush();
+
+            BOOST_REQUIRE_EQUAL(updates["post_watcher"].size(), 1);
+            BOOST_CHECK(changed_keys(updates["post_watcher"][0]) ==
+                        std::vector<std::string>({R"(["alice","post"])"}));
+            const auto &post = updates["post_watcher"][0]["objects"].get_array()[0];
+            BOOST_CHECK_EQUAL(post["type"].as_string(), "comment");
+            BOOST_CHECK_EQUAL(post["object"]["body"].as_string(), "body");
+
+            delete_comment_operation<0, 17, 0> remove;
+            remove.author = "alice";
+            remove.permlink = "post";
+            push_operation(db, remove);
+            generate_block();
+            hub.flush();
+
+            BOOST_REQUIRE_EQUAL(updates["post_watcher"].size(), 2);
+            BOOST_CHECK(updates["post_watcher"][1]["objects"].get_array()[0]["object"].is_null());
+
+            BOOST_TEST_MESSAGE("Cleared keys and expired owners get no more updates");
+            const auto alice_updates = updates["alice_watcher"].size();
+            hub.subscribe_changed_objects(owners["alice_watcher"], [&](const fc::variant &update) {
+                updates["alice_watcher"].push_back(update);
+            }, true);
+            const auto both_updates = updates["both_watcher"].size();
+            owners["both_watcher"].reset();
+
+            push_operation(db, transfer);
+            generate_block();
+            hub.flush();
+
+            BOOST_CHECK_EQUAL(updates["alice_watcher"].size(), alice_updates);
+            BOOST_CHECK_EQUAL(updates["both_watcher"].size(), both_updates);
+            BOOST_CHECK_EQUAL(updates["bob_watcher"].size(), 2);
+            BOOST_CHECK_EQUAL(failing_calls, 1);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+    BOOST_AUTO_TEST_CASE(block_feed) {
+        try {
+            ACTORS((alice)(bob));
+            fund("alice", 10000);
+            generate_blocks(100);
+
+            subscription_hub hub(db);
+
+            BOOST_TEST_MESSAGE("A feed can't start at an older block without the complete operation history");
+            auto history = std::make_shared<int>(0);
+            std::vector<fc::variant> history_entries;
+            auto record_history = [&](const fc::variant &entry) {
+                history_entries.push_back(entry);
+            };
+            STEEMIT_REQUIRE_THROW(hub.subscribe_block_feed(history, record_history, 1, false), fc::exception);
+            hub.flush();
+            BOOST_CHECK(history_entries.empty());
+
+            BOOST_TEST_MESSAGE("A feed starting at an older block sends up to 64 blocks beyond the acknowledged one");
+            hub.set_operation_history_complete(true);
+            hub.subscribe_block_feed(history, record_history, 1, false);
+            hub.flush();
+
+            const uint32_t head_block_num = db.head_block_num();
+            BOOST_CHECK(feed_block_nums(history_entries) == block_range(1, subscription_hub::block_feed_window));
+            BOOST_CHECK(history_entries[0]["block"]["previous"].as<block_id_type>() == block_id_type());
+
+            hub.acknowledge_block_feed(history, 10);
+            hub.flush();
+            BOOST_CHECK(feed_block_nums(history_entries) ==
+                        block_range(1, std::min(head_block_num, 10 + subscription_hub::block_feed_window)));
+
+            hub.acknowledge_block_feed(history, head_block_num);
+            hub.flush();
+            BOOST_CHECK(feed_block_nums(history_entries) == block_range(1, head_block_num));
+
+            BOOST_TEST_MESSAGE("A feed starting at the next block gets new blocks with their operations");
+            auto live = std::make_shared<int>(0);
+            std::vector<fc::variant> live_entries;
+            hub.subscribe_block_feed(live, [&](const fc::variant &entry) {
+                live_entries.push_back(entry);
+            }, 0, false);
+            hub.flush();
+            BOOST_CHECK(live_entries.empty());
+
+            generate_block();
+
+            transfer_operation<0, 17, 0> transfer;
+            transfer.from = "alice";
+            transfer.to = "bob";
+            transfer.amount = asset<0, 17, 0>(1, STEEM_SYMBOL_NAME);
+            push_operation(db, transfer);
+            generate_block();
+            hub.flush();
+
+            BOOST_CHECK(feed_block_nums(live_entries) == block_range(head_block_num + 1, db.head_block_num()));
+            BOOST_REQUIRE_EQUAL(live_entries.back()["block"]["transactions"].get_array().size(), 1);
+            BOOST_CHECK(fc::json::to_string(live_entries.back()["operations"]).find("\"bob\"") != std::string::npos);
+
+            BOOST_TEST_MESSAGE("A fork replacing a sent block makes the feed continue from that block");
+            const auto replaced = fc::json::to_string(live_entries.back());
+            const uint32_t fork_block_num = db.head_block_num();
+            db.pop_block();
+            generate_block();
+            hub.flush();
+
+            BOOST_REQUIRE_EQUAL(live_entries.size(), 3);
+            BOOST_CHECK_EQUAL(live_entries.back()["block_num"].as<uint32_t>(), fork_block_num);
+            BOOST_CHECK(fc::json::to_string(live_entries.back()) != replaced);
+            BOOST_CHECK(live_entries.back()["block"]["transactions"].get_array().empty());
+
+            BOOST_TEST_MESSAGE("An unacknowledged feed stops 64 blocks beyond the last acknowledged block");
+            const uint32_t acknowledged = db.head_block_num();
+            hub.acknowledge_block_feed(live, acknowledged);
+            generate_blocks(subscription_hub::block_feed_window + 6);
+            hub.flush();
+            BOOST_CHECK_EQUAL(live_entries.back()["block_num"].as<uint32_t>(),
+                              acknowledged + subscription_hub::block_feed_window);
+
+            hub.acknowledge_block_feed(live, db.head_block_num());
+            hub.flush();
+            const auto live_block_nums = feed_block_nums(live_entries);
+            BOOST_CHECK(std::vector<uint32_t>(live_block_nums.begin() + 2, live_block_nums.end()) ==
+                        block_range(fork_block_num, db.head_block_num()));
+
+            BOOST_TEST_MESSAGE("Feeds of expired owners are dropped");
+            hub.acknowledge_block_feed(history, db.head_block_num());
+            hub.flush();
+            const auto history_count = history_entries.size();
+            history.reset();
+            generate_block();
+            hub.flush();
+            BOOST_CHECK_EQUAL(history_entries.size(), history_count);
+        }
+        FC_LOG_AND_RETHROW()
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif